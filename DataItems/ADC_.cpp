@@ -5,31 +5,18 @@
 #include "../logging.h"
 #include "../eNET-AIO16-16F.h"
 #include "../adc.h"
+#include "../shadow.h"
+#include "../snapshot.h"
 #include "../config.h"
 
 extern int apci;
 
-TADC_BaseClock::TADC_BaseClock(DataItemIds id, const TBytes &buf)
+TADC_BaseClock::TADC_BaseClock(DataItemIds id, TByteSpan buf)
     : TDataItem<ADC_BaseClockParams>(id, buf)
 {
     // You previously had a constructor that validated 0 or 4 bytes
     GUARD((buf.size() == 0) || (buf.size() == 4), ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH, 0);
-
-    // Optionally parse the 4 bytes into this->params.baseClock if you want
-    // If you do:
-    if (buf.size() == 4)
-    {
-        // e.g.:
-        this->params.baseClock = *reinterpret_cast<const __u32 *>(buf.data());
-    }
-}
-
-TBytes TADC_BaseClock::calcPayload(bool bAsReply)
-{
-    TBytes bytes;
-    stuff(bytes, this->params.baseClock);
-    Trace("TADC_BaseClock::calcPayload built: ", bytes);
-    return bytes;
+    // a 4-byte payload has already been decoded into this->params.baseClock
 }
 
 TADC_BaseClock &TADC_BaseClock::Go()
@@ -49,16 +36,15 @@ std::string TADC_BaseClock::AsString(bool bAsReply)
 
 //  TADC_StreamStart
 
-TADC_StreamStart::TADC_StreamStart(DataItemIds id, TBytes FromBytes)
+TADC_StreamStart::TADC_StreamStart(DataItemIds id, TByteSpan FromBytes)
     : TDataItem<ADC_StreamStartParams>(id, FromBytes)
 {
     if (FromBytes.size() == 4)
     {
-        int cid = *reinterpret_cast<const int *>(FromBytes.data());
+        int cid = static_cast<int>(this->params.argConnectionID); // decoded by TDataItem<>
         if (AdcStreamingConnection == -1)
         {
             AdcStreamingConnection = cid;
-            this->params.argConnectionID = cid;
         }
         else
         {
@@ -109,7 +95,7 @@ std::string TADC_StreamStart::AsString(bool bAsReply)
 }
 
 //  TADC_StreamStop
-TADC_StreamStop::TADC_StreamStop(DataItemIds id, TBytes bytes)
+TADC_StreamStop::TADC_StreamStop(DataItemIds id, TByteSpan bytes)
     : TDataItemBase(id)
 {
 }
@@ -136,14 +122,9 @@ std::string TADC_StreamStop::AsString(bool bAsReply)
 //
 // TADC_Differential1 Implementation
 //
-TADC_Differential1::TADC_Differential1(DataItemIds id, const TBytes &data)
+TADC_Differential1::TADC_Differential1(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_Differential1Params>(id, data)
 {
-    if (data.size() >= 2)
-    {
-        this->params.channelGroup = data[0];
-        this->params.singleEnded = data[1];
-    }
 }
 
 TADC_Differential1::TADC_Differential1(DataItemIds id, __u8 channelGroup, __u8 singleEnded)
@@ -156,7 +137,7 @@ TADC_Differential1::TADC_Differential1(DataItemIds id, __u8 channelGroup, __u8 s
 TDataItemBase &TADC_Differential1::Go()
 {
     // Read current ADC range register for the channel group.
-    __u8 reg = static_cast<__u8>(in(ofsAdcRange + this->params.channelGroup));
+    __u8 reg = static_cast<__u8>(Shadow.Read(ofsAdcRange + this->params.channelGroup));
     // Bit 3 determines single-ended (1) vs differential (0)
     if (this->params.singleEnded)
         reg |= (1 << 3);
@@ -165,13 +146,6 @@ TDataItemBase &TADC_Differential1::Go()
     out(ofsAdcRange + this->params.channelGroup, reg);
     return *this;
 }
-TBytes TADC_Differential1::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    bytes.push_back(this->params.channelGroup);
-    bytes.push_back(this->params.singleEnded);
-    return bytes;
-}
 std::string TADC_Differential1::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -183,14 +157,9 @@ std::string TADC_Differential1::AsString(bool /*bAsReply*/)
 //
 // TADC_DifferentialAll Implementation
 //
-TADC_DifferentialAll::TADC_DifferentialAll(DataItemIds id, const TBytes &data)
+TADC_DifferentialAll::TADC_DifferentialAll(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_DifferentialAllParams>(id, data)
 {
-    if (data.size() >= 8)
-    {
-        for (int i = 0; i < 8; i++)
-            this->params.settings[i] = data[i];
-    }
 }
 TADC_DifferentialAll::TADC_DifferentialAll(DataItemIds id, const __u8 settings[8])
     : TDataItem<ADC_DifferentialAllParams>(id, {})
@@ -202,7 +171,7 @@ TDataItemBase &TADC_DifferentialAll::Go()
 {
     for (__u8 grp = 0; grp < 8; grp++)
     {
-        __u8 reg = static_cast<__u8>(in(ofsAdcRange + grp));
+        __u8 reg = static_cast<__u8>(Shadow.Read(ofsAdcRange + grp));
         if (this->params.settings[grp])
             reg |= (1 << 3);
         else
@@ -211,13 +180,6 @@ TDataItemBase &TADC_DifferentialAll::Go()
     }
     return *this;
 }
-TBytes TADC_DifferentialAll::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    for (int i = 0; i < 8; i++)
-        bytes.push_back(this->params.settings[i]);
-    return bytes;
-}
 std::string TADC_DifferentialAll::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -235,14 +197,9 @@ std::string TADC_DifferentialAll::AsString(bool /*bAsReply*/)
 //
 // TADC_Range1 Implementation
 //
-TADC_Range1::TADC_Range1(DataItemIds id, const TBytes &data)
+TADC_Range1::TADC_Range1(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_Range1Params>(id, data)
 {
-    if (data.size() >= 2)
-    {
-        this->params.channelGroup = data[0];
-        this->params.range = data[1];
-    }
 }
 TADC_Range1::TADC_Range1(DataItemIds id, __u8 channelGroup, __u8 range)
     : TDataItem<ADC_Range1Params>(id, {})
@@ -255,13 +212,6 @@ TDataItemBase &TADC_Range1::Go()
     out(ofsAdcRange + this->params.channelGroup, this->params.range);
     return *this;
 }
-TBytes TADC_Range1::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    bytes.push_back(this->params.channelGroup);
-    bytes.push_back(this->params.range);
-    return bytes;
-}
 std::string TADC_Range1::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -273,14 +223,9 @@ std::string TADC_Range1::AsString(bool /*bAsReply*/)
 //
 // TADC_RangeAll Implementation
 //
-TADC_RangeAll::TADC_RangeAll(DataItemIds id, const TBytes &data)
+TADC_RangeAll::TADC_RangeAll(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_RangeAllParams>(id, data)
 {
-    if (data.size() >= 8)
-    {
-        for (int i = 0; i < 8; i++)
-            this->params.ranges[i] = data[i];
-    }
 }
 TADC_RangeAll::TADC_RangeAll(DataItemIds id, const __u8 ranges[8])
     : TDataItem<ADC_RangeAllParams>(id, {})
@@ -296,13 +241,6 @@ TDataItemBase &TADC_RangeAll::Go()
     }
     return *this;
 }
-TBytes TADC_RangeAll::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    for (int i = 0; i < 8; i++)
-        bytes.push_back(this->params.ranges[i]);
-    return bytes;
-}
 std::string TADC_RangeAll::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -320,15 +258,9 @@ std::string TADC_RangeAll::AsString(bool /*bAsReply*/)
 //
 // TADC_Span1 Implementation (Scale calibration for one range)
 //
-TADC_Scale1::TADC_Scale1(DataItemIds id, const TBytes &data)
+TADC_Scale1::TADC_Scale1(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_Span1Params>(id, data)
 {
-    if (data.size() >= 5)
-    {
-        this->params.rangeIndex = data[0];
-        // Next 4 bytes: float scale
-        this->params.scale = *(reinterpret_cast<const float *>(&data[1]));
-    }
 }
 TADC_Scale1::TADC_Scale1(DataItemIds id, __u8 rangeIndex, float scale)
     : TDataItem<ADC_Span1Params>(id, {})
@@ -340,20 +272,11 @@ TDataItemBase &TADC_Scale1::Go()
 {
     // Write the scale to the appropriate calibration register.
     int addr = ofsAdcCalScale + (this->params.rangeIndex * ofsAdcCalScaleStride);
-    out(addr, *reinterpret_cast<__u32 *>(&this->params.scale));
+    out(addr, bit_cast<__u32>(this->params.scale));
     // Update global configuration.
     Config.adcScaleCoefficients[this->params.rangeIndex] = this->params.scale;
     return *this;
 }
-TBytes TADC_Scale1::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    bytes.push_back(this->params.rangeIndex);
-    const __u8 *p = reinterpret_cast<const __u8 *>(&this->params.scale);
-    for (size_t i = 0; i < sizeof(float); i++)
-        bytes.push_back(p[i]);
-    return bytes;
-}
 std::string TADC_Scale1::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -365,16 +288,9 @@ std::string TADC_Scale1::AsString(bool /*bAsReply*/)
 //
 // TADC_ScaleAll Implementation
 //
-TADC_ScaleAll::TADC_ScaleAll(DataItemIds id, const TBytes &data)
+TADC_ScaleAll::TADC_ScaleAll(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_SpanAllParams>(id, data)
 {
-    if (data.size() >= 8 * sizeof(float))
-    {
-        for (int i = 0; i < 8; i++)
-        {
-            this->params.scales[i] = *(reinterpret_cast<const float *>(&data[i * sizeof(float)]));
-        }
-    }
 }
 TADC_ScaleAll::TADC_ScaleAll(DataItemIds id, const float scales[8])
     : TDataItem<ADC_SpanAllParams>(id, {})
@@ -387,22 +303,11 @@ TDataItemBase &TADC_ScaleAll::Go()
     for (int i = 0; i < 8; i++)
     {
         int addr = ofsAdcCalScale + (i * ofsAdcCalScaleStride);
-        out(addr, *reinterpret_cast<__u32 *>(&this->params.scales[i]));
+        out(addr, bit_cast<__u32>(this->params.scales[i]));
         Config.adcScaleCoefficients[i] = this->params.scales[i];
     }
     return *this;
 }
-TBytes TADC_ScaleAll::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    for (int i = 0; i < 8; i++)
-    {
-        const __u8 *p = reinterpret_cast<const __u8 *>(&this->params.scales[i]);
-        for (size_t j = 0; j < sizeof(float); j++)
-            bytes.push_back(p[j]);
-    }
-    return bytes;
-}
 std::string TADC_ScaleAll::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -420,14 +325,9 @@ std::string TADC_ScaleAll::AsString(bool /*bAsReply*/)
 //
 // TADC_Offset1 Implementation (Offset calibration for one range)
 //
-TADC_Offset1::TADC_Offset1(DataItemIds id, const TBytes &data)
+TADC_Offset1::TADC_Offset1(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_Offset1Params>(id, data)
 {
-    if (data.size() >= 5)
-    {
-        this->params.rangeIndex = data[0];
-        this->params.offset = *(reinterpret_cast<const float *>(&data[1]));
-    }
 }
 TADC_Offset1::TADC_Offset1(DataItemIds id, __u8 rangeIndex, float offset)
     : TDataItem<ADC_Offset1Params>(id, {})
@@ -438,19 +338,10 @@ TADC_Offset1::TADC_Offset1(DataItemIds id, __u8 rangeIndex, float offset)
 TDataItemBase &TADC_Offset1::Go()
 {
     int addr = ofsAdcCalOffset + (this->params.rangeIndex * ofsAdcCalOffsetStride);
-    out(addr, *reinterpret_cast<__u32 *>(&this->params.offset));
+    out(addr, bit_cast<__u32>(this->params.offset));
     Config.adcOffsetCoefficients[this->params.rangeIndex] = this->params.offset;
     return *this;
 }
-TBytes TADC_Offset1::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    bytes.push_back(this->params.rangeIndex);
-    const __u8 *p = reinterpret_cast<const __u8 *>(&this->params.offset);
-    for (size_t i = 0; i < sizeof(float); i++)
-        bytes.push_back(p[i]);
-    return bytes;
-}
 std::string TADC_Offset1::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -462,16 +353,9 @@ std::string TADC_Offset1::AsString(bool /*bAsReply*/)
 //
 // TADC_OffsetAll Implementation
 //
-TADC_OffsetAll::TADC_OffsetAll(DataItemIds id, const TBytes &data)
+TADC_OffsetAll::TADC_OffsetAll(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_OffsetAllParams>(id, data)
 {
-    if (data.size() >= 8 * sizeof(float))
-    {
-        for (int i = 0; i < 8; i++)
-        {
-            this->params.offsets[i] = *(reinterpret_cast<const float *>(&data[i * sizeof(float)]));
-        }
-    }
 }
 TADC_OffsetAll::TADC_OffsetAll(DataItemIds id, const float offsets[8])
     : TDataItem<ADC_OffsetAllParams>(id, {})
@@ -484,22 +368,11 @@ TDataItemBase &TADC_OffsetAll::Go()
     for (int i = 0; i < 8; i++)
     {
         int addr = ofsAdcCalOffset + (i * ofsAdcCalOffsetStride);
-        out(addr, *reinterpret_cast<__u32 *>(&this->params.offsets[i]));
+        out(addr, bit_cast<__u32>(this->params.offsets[i]));
         Config.adcOffsetCoefficients[i] = this->params.offsets[i];
     }
     return *this;
 }
-TBytes TADC_OffsetAll::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    for (int i = 0; i < 8; i++)
-    {
-        const __u8 *p = reinterpret_cast<const __u8 *>(&this->params.offsets[i]);
-        for (size_t j = 0; j < sizeof(float); j++)
-            bytes.push_back(p[j]);
-    }
-    return bytes;
-}
 std::string TADC_OffsetAll::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -517,15 +390,9 @@ std::string TADC_OffsetAll::AsString(bool /*bAsReply*/)
 //
 // TADC_Calibration1 Implementation (both scale and offset for one range)
 //
-TADC_Calibration1::TADC_Calibration1(DataItemIds id, const TBytes &data)
+TADC_Calibration1::TADC_Calibration1(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_Calibration1Params>(id, data)
 {
-    if (data.size() >= 9)
-    {
-        this->params.rangeIndex = data[0];
-        this->params.scale = *(reinterpret_cast<const float *>(&data[1]));
-        this->params.offset = *(reinterpret_cast<const float *>(&data[5]));
-    }
 }
 TADC_Calibration1::TADC_Calibration1(DataItemIds id, __u8 rangeIndex, float scale, float offset)
     : TDataItem<ADC_Calibration1Params>(id, {})
@@ -538,24 +405,12 @@ TDataItemBase &TADC_Calibration1::Go()
 {
     int addrScale = ofsAdcCalScale + (this->params.rangeIndex * ofsAdcCalScaleStride);
     int addrOffset = ofsAdcCalOffset + (this->params.rangeIndex * ofsAdcCalOffsetStride);
-    out(addrScale, *reinterpret_cast<__u32 *>(&this->params.scale));
-    out(addrOffset, *reinterpret_cast<__u32 *>(&this->params.offset));
+    out(addrScale, bit_cast<__u32>(this->params.scale));
+    out(addrOffset, bit_cast<__u32>(this->params.offset));
     Config.adcScaleCoefficients[this->params.rangeIndex] = this->params.scale;
     Config.adcOffsetCoefficients[this->params.rangeIndex] = this->params.offset;
     return *this;
 }
-TBytes TADC_Calibration1::calcPayload(bool /*bAsReply*/)
-{
-    TBytes bytes;
-    bytes.push_back(this->params.rangeIndex);
-    const __u8 *pScale = reinterpret_cast<const __u8 *>(&this->params.scale);
-    for (size_t i = 0; i < sizeof(float); i++)
-        bytes.push_back(pScale[i]);
-    const __u8 *pOffset = reinterpret_cast<const __u8 *>(&this->params.offset);
-    for (size_t i = 0; i < sizeof(float); i++)
-        bytes.push_back(pOffset[i]);
-    return bytes;
-}
 std::string TADC_Calibration1::AsString(bool /*bAsReply*/)
 {
     std::stringstream ss;
@@ -570,7 +425,7 @@ std::string TADC_Calibration1::AsString(bool /*bAsReply*/)
 
 // TADC_CalibrationAll Constructor (from interleaved TBytes)
 //
-TADC_CalibrationAll::TADC_CalibrationAll(DataItemIds id, const TBytes &data)
+TADC_CalibrationAll::TADC_CalibrationAll(DataItemIds id, TByteSpan data)
     : TDataItem<ADC_CalibrationAllParams>(id, data)
 {
     // Expect interleaved scale/offset pairs: 16 floats = 16 * sizeof(float) bytes.
@@ -580,9 +435,9 @@ TADC_CalibrationAll::TADC_CalibrationAll(DataItemIds id, const TBytes &data)
         for (int i = 0; i < 8; i++)
         {
             // Scale is at even index.
-            this->params.scales[i] = *(reinterpret_cast<const float *>(base + (2 * i) * sizeof(float)));
+            this->params.scales[i] = ReadLE<float>(base + (2 * i) * sizeof(float));
             // Offset is at odd index.
-            this->params.offsets[i] = *(reinterpret_cast<const float *>(base + (2 * i + 1) * sizeof(float)));
+            this->params.offsets[i] = ReadLE<float>(base + (2 * i + 1) * sizeof(float));
         }
     }
 }
@@ -606,8 +461,8 @@ TDataItemBase &TADC_CalibrationAll::Go()
     {
         int addrScale = ofsAdcCalScale + (i * ofsAdcCalScaleStride);
         int addrOffset = ofsAdcCalOffset + (i * ofsAdcCalOffsetStride);
-        out(addrScale, *reinterpret_cast<__u32 *>(&this->params.scales[i]));
-        out(addrOffset, *reinterpret_cast<__u32 *>(&this->params.offsets[i]));
+        out(addrScale, bit_cast<__u32>(this->params.scales[i]));
+        out(addrOffset, bit_cast<__u32>(this->params.offsets[i]));
         Config.adcScaleCoefficients[i] = this->params.scales[i];
         Config.adcOffsetCoefficients[i] = this->params.offsets[i];
     }
@@ -619,19 +474,12 @@ TDataItemBase &TADC_CalibrationAll::Go()
 //
 TBytes TADC_CalibrationAll::calcPayload(bool bAsReply)
 {
-    TBytes bytes;
+    TBytes bytes(16 * sizeof(float));
+    __u8 *dest = bytes.data();
     for (int i = 0; i < 8; i++)
     {
-        const __u8 *pScale = reinterpret_cast<const __u8 *>(&this->params.scales[i]);
-        for (size_t j = 0; j < sizeof(float); j++)
-        {
-            bytes.push_back(pScale[j]);
-        }
-        const __u8 *pOffset = reinterpret_cast<const __u8 *>(&this->params.offsets[i]);
-        for (size_t j = 0; j < sizeof(float); j++)
-        {
-            bytes.push_back(pOffset[j]);
-        }
+        dest = WriteLE<float>(dest, this->params.scales[i]);
+        dest = WriteLE<float>(dest, this->params.offsets[i]);
     }
     return bytes;
 }
@@ -974,7 +822,7 @@ static void ADC_ReduceRawToVoltsPerChannel(const std::vector<__u32>& raw, const
     }
 }
 
-TADC_VoltsAll::TADC_VoltsAll(DataItemIds dId, const TBytes &data) : TDataItem<ADC_VoltsAllParams>(dId, data)
+TADC_VoltsAll::TADC_VoltsAll(DataItemIds dId, TByteSpan data) : TDataItem<ADC_VoltsAllParams>(dId, data)
 {
     this->params = {};
 }
@@ -1004,6 +852,7 @@ TDataItemBase& TADC_VoltsAll::Go()
 
     this->rawBytes.resize(volts.size() * sizeof(float));
     std::memcpy(this->rawBytes.data(), volts.data(), this->rawBytes.size());
+    Snapshot.PublishAdcScan(this->DId, this->rawBytes.data(), this->rawBytes.size());
     std::string mode = "single";
     if (cfg.oversamples == 1)
         mode = "avg2";
@@ -1041,7 +890,7 @@ std::string TADC_VoltsAll::AsString(bool bAsReply)
 
 // ---------------- ADC_RawAll ----------------
 
-TADC_RawAll::TADC_RawAll(DataItemIds dId, const TBytes &data)
+TADC_RawAll::TADC_RawAll(DataItemIds dId, TByteSpan data)
     : TDataItem<ADC_RawAllParams>(dId, data)
 {
 }
@@ -1082,6 +931,7 @@ TDataItemBase& TADC_RawAll::Go()
 
     this->rawBytes.resize(perChRaw.size() * sizeof(__u32));
     std::memcpy(this->rawBytes.data(), perChRaw.data(), this->rawBytes.size());
+    Snapshot.PublishAdcScan(this->DId, this->rawBytes.data(), this->rawBytes.size());
     std::string firstLast;
     if (!perChRaw.empty())
     {
@@ -1097,7 +947,7 @@ TDataItemBase& TADC_RawAll::Go()
 
 // ---------------- ADC_CountsAll ----------------
 
-TADC_CountsAll::TADC_CountsAll(DataItemIds dId, const TBytes &data)
+TADC_CountsAll::TADC_CountsAll(DataItemIds dId, TByteSpan data)
     : TDataItem<ADC_CountsAllParams>(dId, data)
 {
 }
@@ -1138,6 +988,7 @@ TDataItemBase& TADC_CountsAll::Go()
 
     this->rawBytes.resize(counts.size() * sizeof(__u16));
     std::memcpy(this->rawBytes.data(), counts.data(), this->rawBytes.size());
+    Snapshot.PublishAdcScan(this->DId, this->rawBytes.data(), this->rawBytes.size());
     std::string firstLast;
     if (!counts.empty())
     {
@@ -10,6 +10,8 @@
 struct ADC_BaseClockParams {
     __u32 baseClock = 25000000; // default
 };
+template <> struct TParamLayout<ADC_BaseClockParams>
+    : TParamCodec<ADC_BaseClockParams, PARAM_FIELD(ADC_BaseClockParams, baseClock)> {};
 class TADC_BaseClock : public TDataItem<ADC_BaseClockParams>
 {
 public:
@@ -20,10 +22,9 @@ public:
     }
     // Constructor that checks incoming byte size
     // (If you want to pass 0 or 4 bytes.)
-    TADC_BaseClock(DataItemIds id, const TBytes &FromBytes);
+    TADC_BaseClock(DataItemIds id, TByteSpan FromBytes);
 
     // Overridden methods
-    virtual TBytes calcPayload(bool bAsReply=false) override;
     virtual TADC_BaseClock &Go() override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
@@ -33,11 +34,13 @@ public:
 struct ADC_StreamStartParams {
     __u32 argConnectionID = (__u32)-1;
 };
+template <> struct TParamLayout<ADC_StreamStartParams>
+    : TParamCodec<ADC_StreamStartParams, PARAM_FIELD(ADC_StreamStartParams, argConnectionID)> {};
 
 class TADC_StreamStart : public TDataItem<ADC_StreamStartParams>
 {
 public:
-    TADC_StreamStart(DataItemIds id, TBytes FromBytes);
+    TADC_StreamStart(DataItemIds id, TByteSpan FromBytes);
 
     virtual TADC_StreamStart &Go() override;
     virtual std::string AsString(bool bAsReply = false) override;
@@ -48,7 +51,7 @@ public:
 class TADC_StreamStop : public TDataItemBase
 {
 public:
-    TADC_StreamStop(DataItemIds id, TBytes FromBytes);
+    TADC_StreamStop(DataItemIds id, TByteSpan FromBytes);
 
     virtual TBytes calcPayload(bool bAsReply=false) override;
     virtual TADC_StreamStop &Go() override;
@@ -62,28 +65,30 @@ struct ADC_Differential1Params {
     __u8 channelGroup;     // Which ADC channel group (0–7)
     __u8 singleEnded;      // 1 for single-ended, 0 for differential.
 };
+template <> struct TParamLayout<ADC_Differential1Params>
+    : TParamCodec<ADC_Differential1Params, PARAM_FIELD(ADC_Differential1Params, channelGroup), PARAM_FIELD(ADC_Differential1Params, singleEnded)> {};
 
 class TADC_Differential1 : public TDataItem<ADC_Differential1Params> {
 public:
-    TADC_Differential1(DataItemIds id, const TBytes &data);
+    TADC_Differential1(DataItemIds id, TByteSpan data);
     TADC_Differential1(DataItemIds id, __u8 channelGroup, __u8 singleEnded);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
 struct ADC_DifferentialAllParams {
     __u8 settings[8];  // One per channel group.
 };
+template <> struct TParamLayout<ADC_DifferentialAllParams>
+    : TParamCodec<ADC_DifferentialAllParams, PARAM_FIELD(ADC_DifferentialAllParams, settings)> {};
 
 class TADC_DifferentialAll : public TDataItem<ADC_DifferentialAllParams> {
 public:
-    TADC_DifferentialAll(DataItemIds id, const TBytes &data);
+    TADC_DifferentialAll(DataItemIds id, TByteSpan data);
     TADC_DifferentialAll(DataItemIds id, const __u8 settings[8]);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -93,28 +98,30 @@ struct ADC_Range1Params {
     __u8 channelGroup;
     __u8 range;  // The bitmask value representing the range.
 };
+template <> struct TParamLayout<ADC_Range1Params>
+    : TParamCodec<ADC_Range1Params, PARAM_FIELD(ADC_Range1Params, channelGroup), PARAM_FIELD(ADC_Range1Params, range)> {};
 
 class TADC_Range1 : public TDataItem<ADC_Range1Params> {
 public:
-    TADC_Range1(DataItemIds id, const TBytes &data);
+    TADC_Range1(DataItemIds id, TByteSpan data);
     TADC_Range1(DataItemIds id, __u8 channelGroup, __u8 range);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
 struct ADC_RangeAllParams {
     __u8 ranges[8];  // One range value per channel group.
 };
+template <> struct TParamLayout<ADC_RangeAllParams>
+    : TParamCodec<ADC_RangeAllParams, PARAM_FIELD(ADC_RangeAllParams, ranges)> {};
 
 class TADC_RangeAll : public TDataItem<ADC_RangeAllParams> {
 public:
-    TADC_RangeAll(DataItemIds id, const TBytes &data);
+    TADC_RangeAll(DataItemIds id, TByteSpan data);
     TADC_RangeAll(DataItemIds id, const __u8 ranges[8]);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -128,14 +135,15 @@ struct ADC_Span1Params {
     __u8 rangeIndex; // 0..7
     float scale;
 };
+template <> struct TParamLayout<ADC_Span1Params>
+    : TParamCodec<ADC_Span1Params, PARAM_FIELD(ADC_Span1Params, rangeIndex), PARAM_FIELD(ADC_Span1Params, scale)> {};
 
 class TADC_Scale1 : public TDataItem<ADC_Span1Params> {
 public:
-    TADC_Scale1(DataItemIds id, const TBytes &data);
+    TADC_Scale1(DataItemIds id, TByteSpan data);
     TADC_Scale1(DataItemIds id, __u8 rangeIndex, float scale);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -143,14 +151,15 @@ public:
 struct ADC_SpanAllParams {
     float scales[8];
 };
+template <> struct TParamLayout<ADC_SpanAllParams>
+    : TParamCodec<ADC_SpanAllParams, PARAM_FIELD(ADC_SpanAllParams, scales)> {};
 
 class TADC_ScaleAll : public TDataItem<ADC_SpanAllParams> {
 public:
-    TADC_ScaleAll(DataItemIds id, const TBytes &data);
+    TADC_ScaleAll(DataItemIds id, TByteSpan data);
     TADC_ScaleAll(DataItemIds id, const float scales[8]);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -163,14 +172,15 @@ struct ADC_Offset1Params {
     __u8 rangeIndex;
     float offset;
 };
+template <> struct TParamLayout<ADC_Offset1Params>
+    : TParamCodec<ADC_Offset1Params, PARAM_FIELD(ADC_Offset1Params, rangeIndex), PARAM_FIELD(ADC_Offset1Params, offset)> {};
 
 class TADC_Offset1 : public TDataItem<ADC_Offset1Params> {
 public:
-    TADC_Offset1(DataItemIds id, const TBytes &data);
+    TADC_Offset1(DataItemIds id, TByteSpan data);
     TADC_Offset1(DataItemIds id, __u8 rangeIndex, float offset);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -178,14 +188,15 @@ public:
 struct ADC_OffsetAllParams {
     float offsets[8];
 };
+template <> struct TParamLayout<ADC_OffsetAllParams>
+    : TParamCodec<ADC_OffsetAllParams, PARAM_FIELD(ADC_OffsetAllParams, offsets)> {};
 
 class TADC_OffsetAll : public TDataItem<ADC_OffsetAllParams> {
 public:
-    TADC_OffsetAll(DataItemIds id, const TBytes &data);
+    TADC_OffsetAll(DataItemIds id, TByteSpan data);
     TADC_OffsetAll(DataItemIds id, const float offsets[8]);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -199,14 +210,15 @@ struct ADC_Calibration1Params {
     float scale;
     float offset;
 };
+template <> struct TParamLayout<ADC_Calibration1Params>
+    : TParamCodec<ADC_Calibration1Params, PARAM_FIELD(ADC_Calibration1Params, rangeIndex), PARAM_FIELD(ADC_Calibration1Params, scale), PARAM_FIELD(ADC_Calibration1Params, offset)> {};
 
 class TADC_Calibration1 : public TDataItem<ADC_Calibration1Params> {
 public:
-    TADC_Calibration1(DataItemIds id, const TBytes &data);
+    TADC_Calibration1(DataItemIds id, TByteSpan data);
     TADC_Calibration1(DataItemIds id, __u8 rangeIndex, float scale, float offset);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -219,7 +231,7 @@ struct ADC_CalibrationAllParams {
 
 class TADC_CalibrationAll : public TDataItem<ADC_CalibrationAllParams> {
 public:
-    TADC_CalibrationAll(DataItemIds id, const TBytes &data); // Constructor from interleaved byte payload
+    TADC_CalibrationAll(DataItemIds id, TByteSpan data); // Constructor from interleaved byte payload
     TADC_CalibrationAll(DataItemIds id, const float scales[8], const float offsets[8]); // Explicit parameter constructor: scales and offsets provided separately.
 
     virtual TDataItemBase &Go() override;
@@ -235,7 +247,7 @@ struct ADC_RawAllParams  // Intentionally empty.
 class TADC_RawAll : public TDataItem<ADC_RawAllParams>
 {
 public:
-    TADC_RawAll(DataItemIds dId, const TBytes &data);
+    TADC_RawAll(DataItemIds dId, TByteSpan data);
 
     TDataItemBase &Go() override;
     std::string AsString(bool bAsReply = false) override;
@@ -250,7 +262,7 @@ struct ADC_CountsAllParams // Intentionally empty.
 class TADC_CountsAll : public TDataItem<ADC_CountsAllParams>
 {
 public:
-    TADC_CountsAll(DataItemIds dId, const TBytes &data);
+    TADC_CountsAll(DataItemIds dId, TByteSpan data);
 
     TDataItemBase &Go() override;
     std::string AsString(bool bAsReply = false) override;
@@ -267,7 +279,7 @@ struct ADC_VoltsAllParams
 class TADC_VoltsAll : public TDataItem<ADC_VoltsAllParams>
 {
 public:
-    TADC_VoltsAll(DataItemIds dId, const TBytes &data);
+    TADC_VoltsAll(DataItemIds dId, TByteSpan data);
 
     TDataItemBase &Go() override;
     std::string AsString(bool bAsReply = false) override;  // <-- REQUIRED
@@ -4,6 +4,7 @@
 
 #include "BRD_.h"
 #include "../config.h"
+#include "../snapshot.h"
 #include "../utilities.h"   // For stuff<>, etc.
 
 // =================== TReadOnlyConfig<T> ===================
@@ -18,7 +19,7 @@ TReadOnlyConfig<T>::TReadOnlyConfig(DataItemIds id, __u8 offset)
 
 // (2) Constructor: DId + raw bytes
 template <typename T>
-TReadOnlyConfig<T>::TReadOnlyConfig(DataItemIds id, const TBytes &FromBytes)
+TReadOnlyConfig<T>::TReadOnlyConfig(DataItemIds id, TByteSpan FromBytes)
     : TDataItem<ReadOnlyConfigParams<T>>(id, FromBytes)
 {
     // By default offset=0. Subclasses can override (like TBRD_DeviceID) if needed
@@ -69,11 +70,11 @@ std::string TReadOnlyConfig<T>::AsString(bool bAsReply)
     }
     if (bAsReply)
     {
-        return it->second.desc + " → " + to_hex<T>(this->params.config);
+        return std::string(it->desc) + " → " + to_hex<T>(this->params.config);
     }
     else
     {
-        return it->second.desc;
+        return std::string(it->desc);
     }
 }
 
@@ -96,7 +97,7 @@ TBRD_FpgaId::TBRD_FpgaId(const TBytes &FromBytes)
     this->params.offset = ofsFpgaID;
 }
 
-TBRD_FpgaId::TBRD_FpgaId(DataItemIds id, const TBytes &FromBytes)
+TBRD_FpgaId::TBRD_FpgaId(DataItemIds id, TByteSpan FromBytes)
     : TReadOnlyConfig<__u32>(id, FromBytes)
 {
     this->params.offset = ofsFpgaID;
@@ -119,6 +120,7 @@ TBRD_FpgaId &TBRD_FpgaId::Go()
     this->params.config = in(this->params.offset);
     Log("Offset = " + to_hex<__u8>(this->params.offset)
         + " > " + to_hex<__u32>(this->params.config));
+    Snapshot.PublishBoardId(this->DId, this->params.config);
     return *this;
 }
 
@@ -141,7 +143,7 @@ TBRD_DeviceID::TBRD_DeviceID(const TBytes &FromBytes)
     this->params.offset = ofsDeviceID;
 }
 
-TBRD_DeviceID::TBRD_DeviceID(DataItemIds id, const TBytes &FromBytes)
+TBRD_DeviceID::TBRD_DeviceID(DataItemIds id, TByteSpan FromBytes)
     : TReadOnlyConfig<__u16>(id, FromBytes)
 {
     this->params.offset = ofsDeviceID;
@@ -162,6 +164,7 @@ TBRD_DeviceID &TBRD_DeviceID::Go()
     this->params.config = static_cast<__u16>(in(this->params.offset));
     Log("Offset = " + to_hex<__u8>(this->params.offset)
         + " > " + to_hex<__u16>(this->params.config));
+    Snapshot.PublishBoardId(this->DId, this->params.config);
     return *this;
 }
 
@@ -184,7 +187,7 @@ TBRD_Features::TBRD_Features(const TBytes &FromBytes)
     this->params.offset = ofsFeatures;
 }
 
-TBRD_Features::TBRD_Features(DataItemIds id, const TBytes &FromBytes)
+TBRD_Features::TBRD_Features(DataItemIds id, TByteSpan FromBytes)
     : TReadOnlyConfig<__u8>(id, FromBytes)
 {
     this->params.offset = ofsFeatures;
@@ -206,6 +209,7 @@ TBRD_Features &TBRD_Features::Go()
     Log("Offset = " + to_hex<__u8>(this->params.offset)
         + " > " + to_hex<__u8>(this->params.config));
     Config.features = this->params.config;
+    Snapshot.PublishBoardId(this->DId, this->params.config);
     return *this;
 }
 
@@ -523,33 +527,16 @@ std::string TBRD_GetModel::AsString(bool bAsReply)
 }
 
 
-TBRD_GetNumberOfAdcChannels::TBRD_GetNumberOfAdcChannels(DataItemIds id, const TBytes &buf)
+TBRD_GetNumberOfAdcChannels::TBRD_GetNumberOfAdcChannels(DataItemIds id, TByteSpan buf)
     : TDataItem<BRD_GetNumberOfAdcChannelsParams>(id, buf)
 {
     // Accept either:
     //   - 0 bytes (typical "get" request)
     //   - 1 byte  (optional: if ever passed as a parsed payload)
     GUARD((buf.size() == 0) || (buf.size() == 1), ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH, 0);
-
-    if (buf.size() == 1) {
-        this->params.numAdcChan = buf[0];
-    }
 }
 
 // -------------------- TBRD_GetNumberOfAdcChannels --------------------
-TBytes TBRD_GetNumberOfAdcChannels::calcPayload(bool bAsReply)
-{
-    (void)bAsReply;
-
-    TBytes bytes;
-
-    // Return the channel count as a single byte
-    stuff(bytes, this->params.numAdcChan);
-
-    Trace("TBRD_GetNumberOfAdcChannels::calcPayload built: ", bytes);
-    return bytes;
-}
-
 TBRD_GetNumberOfAdcChannels &TBRD_GetNumberOfAdcChannels::Go()
 {
     Trace("BRD_GetNumberOfAdcChannels Go() reading Config.adcChannels");
@@ -623,7 +610,7 @@ std::string TBRD_GetSerialNumber::AsString(bool bAsReply)
 // -----------------------------------------
 // TBRD_GetNumberOfSubmuxes
 // -----------------------------------------
-TBRD_GetNumberOfSubmuxes::TBRD_GetNumberOfSubmuxes(DataItemIds id, const TBytes &buf)
+TBRD_GetNumberOfSubmuxes::TBRD_GetNumberOfSubmuxes(DataItemIds id, TByteSpan buf)
   : TDataItem<NumberOfSubmuxParams>(id, buf)
 {
     // ignore buf
@@ -638,13 +625,6 @@ TBRD_GetNumberOfSubmuxes &TBRD_GetNumberOfSubmuxes::Go()
     return *this;
 }
 
-TBytes TBRD_GetNumberOfSubmuxes::calcPayload(bool /*bAsReply*/)
-{
-    TBytes out;
-    out.push_back(this->params.value);
-    return out;
-}
-
 std::string TBRD_GetNumberOfSubmuxes::AsString(bool bAsReply)
 {
     if (bAsReply)
@@ -656,14 +636,14 @@ std::string TBRD_GetNumberOfSubmuxes::AsString(bool bAsReply)
 // -----------------------------------------
 // TBRD_GetSubmuxScale
 // -----------------------------------------
-TBRD_GetSubmuxScale::TBRD_GetSubmuxScale(DataItemIds id, const TBytes &buf)
+TBRD_GetSubmuxScale::TBRD_GetSubmuxScale(DataItemIds id, TByteSpan buf)
   : TDataItem<SubmuxScaleParams>(id, buf)
 {
     if (buf.size() == 2) {
         this->params.submuxIndex    = buf[0];
         this->params.gainGroupIndex = buf[1];
     } else if (buf.size() == 4) {
-        this->params.value = *(float *)(&buf[0]);
+        this->params.value = ReadLE<float>(buf.data());
     }
 }
 
@@ -682,16 +662,14 @@ TBRD_GetSubmuxScale &TBRD_GetSubmuxScale::Go()
 
 TBytes TBRD_GetSubmuxScale::calcPayload(bool bAsReply)
 {
-    TBytes out;
-    if (bAsReply){
-        const auto *p = reinterpret_cast<const __u8*>(&this->params.value);
-        out.insert(out.end(), p, p + sizeof(float));
-    }
-    else{
-        out.push_back(this->params.submuxIndex);
-        out.push_back(this->params.gainGroupIndex);
+    // request is the two indices; the reply is just the float
+    if (bAsReply)
+    {
+        TBytes out(sizeof(float));
+        WriteLE<float>(out.data(), this->params.value);
+        return out;
     }
-    return out;
+    return TBytes{this->params.submuxIndex, this->params.gainGroupIndex};
 }
 
 std::string TBRD_GetSubmuxScale::AsString(bool bAsReply)
@@ -707,14 +685,14 @@ std::string TBRD_GetSubmuxScale::AsString(bool bAsReply)
 // -----------------------------------------
 // TBRD_GetSubmuxOffset
 // -----------------------------------------
-TBRD_GetSubmuxOffset::TBRD_GetSubmuxOffset(DataItemIds id, const TBytes &buf)
+TBRD_GetSubmuxOffset::TBRD_GetSubmuxOffset(DataItemIds id, TByteSpan buf)
   : TDataItem<SubmuxOffsetParams>(id, buf)
 {
     if (buf.size() == 2) {
         this->params.submuxIndex    = buf[0];
         this->params.gainGroupIndex = buf[1];
     } else if (buf.size() == 4) {
-        this->params.value = *(float *)(&buf[0]);
+        this->params.value = ReadLE<float>(buf.data());
     }
 }
 TBRD_GetSubmuxOffset &TBRD_GetSubmuxOffset::Go()
@@ -734,17 +712,14 @@ TBRD_GetSubmuxOffset &TBRD_GetSubmuxOffset::Go()
 
 TBytes TBRD_GetSubmuxOffset::calcPayload(bool bAsReply)
 {
-    TBytes out;
-    if (bAsReply){
-        const auto *p = reinterpret_cast<const __u8*>(&this->params.value);
-        out.insert(out.end(), p, p + sizeof(float));
-    }
-    else
+    // request is the two indices; the reply is just the float
+    if (bAsReply)
     {
-        out.push_back(this->params.submuxIndex);
-        out.push_back(this->params.gainGroupIndex);
+        TBytes out(sizeof(float));
+        WriteLE<float>(out.data(), this->params.value);
+        return out;
     }
-    return out;
+    return TBytes{this->params.submuxIndex, this->params.gainGroupIndex};
 }
 
 std::string TBRD_GetSubmuxOffset::AsString(bool bAsReply)
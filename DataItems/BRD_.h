@@ -23,7 +23,7 @@ public:
     TReadOnlyConfig(DataItemIds id, __u8 offset);
 
     // (2) Constructor: DId + raw bytes (from factory)
-    TReadOnlyConfig(DataItemIds id, const TBytes &FromBytes);
+    TReadOnlyConfig(DataItemIds id, TByteSpan FromBytes);
 
     // (3) Constructor: just TBytes
     explicit TReadOnlyConfig(const TBytes &FromBytes);
@@ -45,7 +45,7 @@ class TBRD_FpgaId : public TReadOnlyConfig<__u32>
 public:
     TBRD_FpgaId();
     TBRD_FpgaId(const TBytes &FromBytes);
-    TBRD_FpgaId(DataItemIds id, const TBytes &FromBytes);
+    TBRD_FpgaId(DataItemIds id, TByteSpan FromBytes);
 
     // Override if needed
     virtual std::string AsString(bool bAsReply) override;
@@ -59,7 +59,7 @@ class TBRD_DeviceID : public TReadOnlyConfig<__u16>
 public:
     TBRD_DeviceID();
     TBRD_DeviceID(const TBytes &FromBytes);
-    TBRD_DeviceID(DataItemIds id, const TBytes &FromBytes);
+    TBRD_DeviceID(DataItemIds id, TByteSpan FromBytes);
 
     virtual std::string AsString(bool bAsReply) override;
     virtual TBRD_DeviceID &Go() override;
@@ -72,7 +72,7 @@ class TBRD_Features : public TReadOnlyConfig<__u8>
 public:
     TBRD_Features();
     TBRD_Features(const TBytes &FromBytes);
-    TBRD_Features(DataItemIds id, const TBytes &FromBytes);
+    TBRD_Features(DataItemIds id, TByteSpan FromBytes);
 
     virtual std::string AsString(bool bAsReply) override;
     virtual TBRD_Features &Go() override;
@@ -84,7 +84,7 @@ public:
 class TBRD_Model : public TDataItem<GenericParams>
 {
 public:
-    explicit TBRD_Model(DataItemIds id, const TBytes &buf)
+    explicit TBRD_Model(DataItemIds id, TByteSpan buf)
         : TDataItem<GenericParams>(id, buf) {}
 
     // no zero-arg ctor
@@ -104,7 +104,7 @@ public:
 class TBRD_GetModel : public TDataItem<GenericParams>
 {
 public:
-    explicit TBRD_GetModel(DataItemIds id, const TBytes &buf)
+    explicit TBRD_GetModel(DataItemIds id, TByteSpan buf)
         : TDataItem<GenericParams>(id, buf) {}
 
     TBRD_GetModel() = delete;
@@ -122,7 +122,7 @@ public:
 class TBRD_SerialNumber : public TDataItem<GenericParams>
 {
 public:
-    explicit TBRD_SerialNumber(DataItemIds id, const TBytes &buf)
+    explicit TBRD_SerialNumber(DataItemIds id, TByteSpan buf)
         : TDataItem<GenericParams>(id, buf) {}
 
     TBRD_SerialNumber() = delete;
@@ -136,7 +136,7 @@ public:
 class TBRD_GetSerialNumber : public TDataItem<GenericParams>
 {
 public:
-    explicit TBRD_GetSerialNumber(DataItemIds id, const TBytes &buf)
+    explicit TBRD_GetSerialNumber(DataItemIds id, TByteSpan buf)
         : TDataItem<GenericParams>(id, buf) {}
 
     TBRD_GetSerialNumber() = delete;
@@ -149,41 +149,29 @@ public:
 struct NumberOfSubmuxParams {
     __u8 value;
 };
+template <> struct TParamLayout<NumberOfSubmuxParams>
+    : TParamCodec<NumberOfSubmuxParams, PARAM_FIELD(NumberOfSubmuxParams, value)> {};
 class TBRD_GetNumberOfSubmuxes : public TDataItem<NumberOfSubmuxParams> {
     public:
         // ctor from raw bytes (ignored)
-        TBRD_GetNumberOfSubmuxes(DataItemIds id, const TBytes &buf);
+        TBRD_GetNumberOfSubmuxes(DataItemIds id, TByteSpan buf);
         // no-arg ctor
         TBRD_GetNumberOfSubmuxes(DataItemIds id);
 
         virtual TBRD_GetNumberOfSubmuxes &Go() override;
-        virtual TBytes              calcPayload(bool bAsReply = false) override;
         virtual std::string        AsString(bool bAsReply = false) override;
     };
 
 class TBRD_NumberOfSubmuxes : public TDataItem<NumberOfSubmuxParams>
 {
 public:
-    explicit TBRD_NumberOfSubmuxes(DataItemIds id, const TBytes &buf)
+    explicit TBRD_NumberOfSubmuxes(DataItemIds id, TByteSpan buf)
         : TDataItem<NumberOfSubmuxParams>(id, buf)
     {
-        // Assuming buf contains the value in the first byte
-        if (!buf.empty())
-            this->params.value = buf[0];
-        else
-            this->params.value = 0;  // default/fallback value
-
+        // value was decoded by TDataItem<>; stays 0 if buf is empty
         Trace("Parsed numberOfSubmuxes: 0x" + to_hex<__u16>(this->params.value));
     }
 
-    virtual TBytes calcPayload(bool bAsReply = false) override
-    {
-        // Convert __u8 value to byte payload
-        TBytes out;
-        out.push_back(this->params.value);
-        return out;
-    }
-
     virtual std::string AsString(bool bAsReply = false) override
     {
         return "TBRD_NumberOfSubmuxes(" + std::to_string(this->params.value) + ")";
@@ -238,6 +226,8 @@ public:
 struct BRD_GetNumberOfAdcChannelsParams {
     __u8 numAdcChan = 16; // default
 };
+template <> struct TParamLayout<BRD_GetNumberOfAdcChannelsParams>
+    : TParamCodec<BRD_GetNumberOfAdcChannelsParams, PARAM_FIELD(BRD_GetNumberOfAdcChannelsParams, numAdcChan)> {};
 class TBRD_GetNumberOfAdcChannels : public TDataItem<BRD_GetNumberOfAdcChannelsParams>
 {
 public:
@@ -246,10 +236,9 @@ public:
     {
         // optional: parse an empty TBytes
     }
-    TBRD_GetNumberOfAdcChannels(DataItemIds id, const TBytes &FromBytes);
+    TBRD_GetNumberOfAdcChannels(DataItemIds id, TByteSpan FromBytes);
 
     // Overridden methods
-    virtual TBytes calcPayload(bool bAsReply=false) override;
     virtual TBRD_GetNumberOfAdcChannels &Go() override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
@@ -260,10 +249,12 @@ struct SubmuxScaleParams {
     __u8 gainGroupIndex;
     float value;
 };
+template <> struct TParamLayout<SubmuxScaleParams>
+    : TParamCodec<SubmuxScaleParams, PARAM_FIELD(SubmuxScaleParams, submuxIndex), PARAM_FIELD(SubmuxScaleParams, gainGroupIndex), PARAM_FIELD(SubmuxScaleParams, value)> {};
 
 class TBRD_GetSubmuxScale : public TDataItem<SubmuxScaleParams> {
 public:
-    TBRD_GetSubmuxScale(DataItemIds id, const TBytes &buf);
+    TBRD_GetSubmuxScale(DataItemIds id, TByteSpan buf);
 
     virtual TBRD_GetSubmuxScale &Go() override;
     virtual TBytes               calcPayload(bool bAsReply = false) override;
@@ -275,22 +266,10 @@ class TBRD_SubmuxScale : public TDataItem<SubmuxScaleParams>
 public:
     // For setting the value directly via pointer to buffer, the buffer will be structured as:
     // [submuxIndex (1 byte), gainGroupIndex (1 byte), then float bytes (4 bytes)]
-    explicit TBRD_SubmuxScale(DataItemIds id, const TBytes &buf)
+    explicit TBRD_SubmuxScale(DataItemIds id, TByteSpan buf)
         : TDataItem<SubmuxScaleParams>(id, buf)
     {
-        if (buf.size() >= 6)
-        {
-            this->params.submuxIndex = buf[0];
-            this->params.gainGroupIndex = buf[1];
-            // Copy 4 bytes for the float value (ensure proper alignment)
-            std::memcpy(&this->params.value, buf.data() + 2, sizeof(float));
-        }
-        else
-        {
-            this->params.submuxIndex = 0;
-            this->params.gainGroupIndex = 0;
-            this->params.value = 0.0f;
-        }
+        // fields were decoded by TDataItem<> (6 bytes: submuxIndex, gainGroupIndex, float value); all 0 if buf is short
         char *s=NULL;
         if (asprintf(&s, "%.3f", this->params.value) == -1) {
             // allocation failed
@@ -303,16 +282,6 @@ public:
         }
     }
 
-    virtual TBytes calcPayload(bool bAsReply = false) override
-    {
-        TBytes out;
-        out.push_back(this->params.submuxIndex);
-        out.push_back(this->params.gainGroupIndex);
-        const __u8* pVal = reinterpret_cast<const __u8*>(&this->params.value);
-        out.insert(out.end(), pVal, pVal + sizeof(float));
-        return out;
-    }
-
     virtual std::string AsString(bool bAsReply = false) override
     {
         return "TBRD_SubmuxScale[submux " + std::to_string(this->params.submuxIndex) +
@@ -350,10 +319,12 @@ struct SubmuxOffsetParams {
     __u8 gainGroupIndex;
     float value;
 };
+template <> struct TParamLayout<SubmuxOffsetParams>
+    : TParamCodec<SubmuxOffsetParams, PARAM_FIELD(SubmuxOffsetParams, submuxIndex), PARAM_FIELD(SubmuxOffsetParams, gainGroupIndex), PARAM_FIELD(SubmuxOffsetParams, value)> {};
 
 class TBRD_GetSubmuxOffset : public TDataItem<SubmuxOffsetParams> {
     public:
-        TBRD_GetSubmuxOffset(DataItemIds id, const TBytes &buf);
+        TBRD_GetSubmuxOffset(DataItemIds id, TByteSpan buf);
 
         virtual TBRD_GetSubmuxOffset &Go() override;
         virtual TBytes                calcPayload(bool bAsReply = false) override;
@@ -363,21 +334,10 @@ class TBRD_GetSubmuxOffset : public TDataItem<SubmuxOffsetParams> {
 class TBRD_SubmuxOffset : public TDataItem<SubmuxOffsetParams>
 {
 public:
-    explicit TBRD_SubmuxOffset(DataItemIds id, const TBytes &buf)
+    explicit TBRD_SubmuxOffset(DataItemIds id, TByteSpan buf)
         : TDataItem<SubmuxOffsetParams>(id, buf)
     {
-        if (buf.size() >= 6)
-        {
-            this->params.submuxIndex = buf[0];
-            this->params.gainGroupIndex = buf[1];
-            std::memcpy(&this->params.value, buf.data() + 2, sizeof(float));
-        }
-        else
-        {
-            this->params.submuxIndex = 0;
-            this->params.gainGroupIndex = 0;
-            this->params.value = 0.0f;
-        }
+        // fields were decoded by TDataItem<> (6 bytes: submuxIndex, gainGroupIndex, float value); all 0 if buf is short
         char *s = NULL;
         if (asprintf(&s, "%.3f", this->params.value) == -1) {
             // allocation failed
@@ -390,16 +350,6 @@ public:
         }
     }
 
-    virtual TBytes calcPayload(bool bAsReply = false) override
-    {
-        TBytes out;
-        out.push_back(this->params.submuxIndex);
-        out.push_back(this->params.gainGroupIndex);
-        const __u8* pVal = reinterpret_cast<const __u8*>(&this->params.value);
-        out.insert(out.end(), pVal, pVal + sizeof(float));
-        return out;
-    }
-
     virtual std::string AsString(bool bAsReply = false) override
     {
         return "TBRD_SubmuxOffset[submux " + std::to_string(this->params.submuxIndex) +
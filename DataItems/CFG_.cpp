@@ -7,7 +7,7 @@
 #include "../utilities.h"
 #include "../eNET-AIO16-16F.h"
 
-TCFG_Hostname::TCFG_Hostname(DataItemIds id, const TBytes &buf)
+TCFG_Hostname::TCFG_Hostname(DataItemIds id, TByteSpan buf)
     : TDataItem<HostnameParams>(id, buf)
 {
     Debug("TCFG_Hostname ctor: Received ", buf);
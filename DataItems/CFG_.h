@@ -11,7 +11,7 @@ struct HostnameParams {
 class TCFG_Hostname : public TDataItem<HostnameParams>
 {
 public:
-    explicit TCFG_Hostname(DataItemIds id, const TBytes &buf);
+    explicit TCFG_Hostname(DataItemIds id, TByteSpan buf);
 
     TCFG_Hostname() = delete;
 
@@ -40,7 +40,7 @@ public:
     }
 
     // 2) Provide the (DataItemIds, TBytes) constructor, for when the factory calls it
-    TConfigField(DataItemIds id, TBytes bytes)
+    TConfigField(DataItemIds id, TByteSpan bytes)
         : TDataItem<ConfigFieldParams>(id, bytes),
           ptr_(nullptr),
           size_(0)
@@ -67,9 +67,9 @@ public:
         auto item = DIdDict.find(this->DId);
         if (item != DIdDict.end())
         {
-            Trace(item->second.desc);
+            Trace(std::string(item->desc));
             Trace("this->rawBytes = ", this->rawBytes);
-            item->second.go(this->rawBytes.data());
+            item->go(this->rawBytes.data());
         }
         else
         {
@@ -50,7 +50,7 @@ inline __u16 sat_u16_from_double(double v) {
     return static_cast<__u16>(std::lround(v));
 }
 
-void TDAC_Output::parseBytes(const TBytes &bytes)
+void TDAC_Output::parseBytes(TByteSpan bytes)
 {
     if (bytes.size() >= 1) {
         GUARD(bytes[0] < 4, ERR_DId_BAD_PARAM, bytes[0]);
@@ -64,7 +64,7 @@ void TDAC_Output::parseBytes(const TBytes &bytes)
 
     if (bytes.size() == 3) {
         // counts path: [iDAC][lo][hi] (little-endian)
-        __u16 inCounts = static_cast<__u16>(bytes[1] | (static_cast<__u16>(bytes[2]) << 8));
+        __u16 inCounts = ReadLE<__u16>(bytes.data() + 1);
         this->bWrite = true;
 
         const double outCountsF = static_cast<double>(inCounts) * sc + oc;
@@ -76,8 +76,7 @@ void TDAC_Output::parseBytes(const TBytes &bytes)
     }
     else if (bytes.size() == 5) {
         // volts path: [iDAC][f32 volts]
-        float volts;
-        std::memcpy(&volts, &bytes[1], sizeof(float));
+        float volts = ReadLE<float>(bytes.data() + 1);
         this->bWrite = true;
 
         const __u16 countsNom = DACVoltsToCounts(ch, static_cast<double>(volts));
@@ -131,7 +130,7 @@ TDAC_OutputV::TDAC_OutputV(const TBytes &bytes)
     parseBytes(bytes);
 }
 
-void TDAC_OutputV::parseBytes(const TBytes &bytes)
+void TDAC_OutputV::parseBytes(TByteSpan bytes)
 {
     if (bytes.size() >= 1) {
         GUARD(bytes[0] < 4, ERR_DId_BAD_PARAM, bytes[0]);
@@ -145,7 +144,7 @@ void TDAC_OutputV::parseBytes(const TBytes &bytes)
 
     if (bytes.size() == 3) {
         // counts path: [iDAC][lo][hi] (little-endian)
-        __u16 inCounts = static_cast<__u16>(bytes[1] | (static_cast<__u16>(bytes[2]) << 8));
+        __u16 inCounts = ReadLE<__u16>(bytes.data() + 1);
         this->bWrite = true;
 
         const double outCountsF = static_cast<double>(inCounts) * sc + oc;
@@ -157,8 +156,7 @@ void TDAC_OutputV::parseBytes(const TBytes &bytes)
     }
     else if (bytes.size() == 5) {
         // volts path: [iDAC][f32 volts]
-        float volts;
-        std::memcpy(&volts, &bytes[1], sizeof(float));
+        float volts = ReadLE<float>(bytes.data() + 1);
         this->bWrite = true;
 
         const __u16 countsNom = DACVoltsToCounts(ch, static_cast<double>(volts));
@@ -214,7 +212,7 @@ TDAC_Range1::TDAC_Range1(const TBytes &bytes)
     parseBytes(bytes);
 }
 
-void TDAC_Range1::parseBytes(const TBytes &bytes)
+void TDAC_Range1::parseBytes(TByteSpan bytes)
 {
     if (bytes.size() >= 1)
     {
@@ -225,10 +223,7 @@ void TDAC_Range1::parseBytes(const TBytes &bytes)
     }
     if (bytes.size() == 5)
     {
-        __u32 rangeCode = (bytes[1])
-                        | (bytes[2] << 8)
-                        | (bytes[3] << 16)
-                        | (bytes[4] << 24);
+        __u32 rangeCode = ReadLE<__u32>(bytes.data() + 1);
         if ((rangeCode < 4)
          || (rangeCode == 0x30313055)
          || (rangeCode == 0x35303055)
@@ -244,14 +239,6 @@ void TDAC_Range1::parseBytes(const TBytes &bytes)
     }
 }
 
-TBytes TDAC_Range1::calcPayload(bool bAsReply)
-{
-    TBytes out;
-    stuff<__u8>(out,  this->params.dacChannel);
-    stuff<__u32>(out, this->params.dacRange);
-    return out;
-}
-
 TDAC_Range1 &TDAC_Range1::Go()
 {
     if (this->bWrite)
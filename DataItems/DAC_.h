@@ -22,6 +22,8 @@ struct DAC_RangeParams {
     __u8  dacChannel = 0;
     __u32 dacRange   = 0;
 };
+template <> struct TParamLayout<DAC_RangeParams>
+    : TParamCodec<DAC_RangeParams, PARAM_FIELD(DAC_RangeParams, dacChannel), PARAM_FIELD(DAC_RangeParams, dacRange)> {};
 
 // 2) TDAC_Output
 // ==============
@@ -33,7 +35,7 @@ public:
     explicit TDAC_Output(const TBytes &bytes);
 
     // Additional constructor for the dictionary/factory
-    TDAC_Output(DataItemIds id, const TBytes &FromBytes)
+    TDAC_Output(DataItemIds id, TByteSpan FromBytes)
         : TDataItem(id, FromBytes)
     {
         // We rely on the main constructor for partial parsing
@@ -48,7 +50,7 @@ public:
 
 private:
     // Helper to unify the partial parsing logic
-    void parseBytes(const TBytes &bytes);
+    void parseBytes(TByteSpan bytes);
 };
 
 // 2) TDAC_OutputV
@@ -61,7 +63,7 @@ public:
     explicit TDAC_OutputV(const TBytes &bytes);
 
     // Additional constructor for the dictionary/factory
-    TDAC_OutputV(DataItemIds id, const TBytes &FromBytes)
+    TDAC_OutputV(DataItemIds id, TByteSpan FromBytes)
         : TDataItem(id, FromBytes)
     {
         // We rely on the main constructor for partial parsing
@@ -76,7 +78,7 @@ public:
 
 private:
     // Helper to unify the partial parsing logic
-    void parseBytes(const TBytes &bytes);
+    void parseBytes(TByteSpan bytes);
 };
 
 // 3) TDAC_Range1
@@ -88,18 +90,17 @@ public:
     explicit TDAC_Range1(const TBytes &bytes);
 
     // For dictionary/factory usage
-    TDAC_Range1(DataItemIds id, const TBytes &FromBytes)
+    TDAC_Range1(DataItemIds id, TByteSpan FromBytes)
         : TDataItem(id, FromBytes)
     {
         parseBytes(FromBytes);
     }
 
     // Overridden
-    virtual TBytes calcPayload(bool bAsReply=false) override;
     virtual std::string AsString(bool bAsReply = false) override;
     virtual TDAC_Range1 &Go() override;
 
 private:
     // partial parse logic
-    void parseBytes(const TBytes &bytes);
+    void parseBytes(TByteSpan bytes);
 };
@@ -2,6 +2,8 @@
 #include "../apci.h"
 #include "../eNET-AIO16-16F.h"
 #include "../logging.h"
+#include "../shadow.h"
+#include "../snapshot.h"
 #include "TDataItem.h"
 #include <sstream>
 #include <iomanip>
@@ -12,13 +14,9 @@
 // --------------------------------------------------------------------------
 // TDIO_Configure Implementation
 // --------------------------------------------------------------------------
-TDIO_Configure::TDIO_Configure(DataItemIds id, const TBytes &data)
+TDIO_Configure::TDIO_Configure(DataItemIds id, TByteSpan data)
     : TDataItem<TDIO_ConfigureParams>(id, data)
 {
-    if(data.size() >= 2) {
-        // Assuming little-endian: data[0]=low byte, data[1]=high byte.
-        this->params.value = static_cast<__u16>(static_cast<__u16>(data[0]) | (static_cast<__u16>(data[1]) << 8));
-    }
 }
 
 TDIO_Configure::TDIO_Configure(DataItemIds id, __u16 value)
@@ -34,13 +32,6 @@ TDataItemBase &TDIO_Configure::Go() {
     return *this;
 }
 
-TBytes TDIO_Configure::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(static_cast<__u8>(this->params.value & 0xFF));
-    bytes.push_back(static_cast<__u8>((this->params.value >> 8) & 0xFF));
-    return bytes;
-}
-
 std::string TDIO_Configure::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_Configure(value=0x" << std::hex << std::setw(4) << std::setfill('0')
@@ -51,7 +42,7 @@ std::string TDIO_Configure::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_Input Implementation
 // --------------------------------------------------------------------------
-TDIO_Input::TDIO_Input(DataItemIds id, const TBytes &data)
+TDIO_Input::TDIO_Input(DataItemIds id, TByteSpan data)
     : TDataItem<TDIO_InputParams>(id, data)
 {
     // No parameters needed; this command just triggers a read.
@@ -66,16 +57,13 @@ TDataItemBase &TDIO_Input::Go() {
     // Read the digital inputs from the input register.
     __u32 regValue = in(ofsDioInputs);
     this->params.value = static_cast<__u16>(regValue & 0xFFFF);
+    Snapshot.PublishDioInputs(this->params.value);
     return *this;
 }
 
 TBytes TDIO_Input::calcPayload(bool bAsReply) {
-    TBytes bytes;
-    if(bAsReply) {
-        bytes.push_back(static_cast<__u8>(this->params.value & 0xFF));
-        bytes.push_back(static_cast<__u8>((this->params.value >> 8) & 0xFF));
-    }
-    return bytes;
+    // the request carries nothing; only the reply has the value
+    return bAsReply ? TParamLayout<TDIO_InputParams>::Encode(this->params) : TBytes{};
 }
 
 std::string TDIO_Input::AsString(bool bAsReply) {
@@ -97,12 +85,9 @@ std::shared_ptr<void> TDIO_Input::getResultValue() {
 // --------------------------------------------------------------------------
 // TDIO_Output Implementation
 // --------------------------------------------------------------------------
-TDIO_Output::TDIO_Output(DataItemIds id, const TBytes &data)
+TDIO_Output::TDIO_Output(DataItemIds id, TByteSpan data)
     : TDataItem<TDIO_OutputParams>(id, data)
 {
-    if(data.size() >= 2) {
-        this->params.value = static_cast<__u16>(static_cast<__u16>(data[0]) | (static_cast<__u16>(data[1]) << 8));
-    }
 }
 
 TDIO_Output::TDIO_Output(DataItemIds id, __u16 value)
@@ -117,13 +102,6 @@ TDataItemBase &TDIO_Output::Go() {
     return *this;
 }
 
-TBytes TDIO_Output::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(static_cast<__u8>(this->params.value & 0xFF));
-    bytes.push_back(static_cast<__u8>((this->params.value >> 8) & 0xFF));
-    return bytes;
-}
-
 std::string TDIO_Output::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_Output(value=0x" << std::hex << std::setw(4) << std::setfill('0')
@@ -134,13 +112,9 @@ std::string TDIO_Output::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_ConfigureBit Implementation
 // --------------------------------------------------------------------------
-TDIO_ConfigureBit::TDIO_ConfigureBit(DataItemIds id, const TBytes &data)
+TDIO_ConfigureBit::TDIO_ConfigureBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_ConfigureBitParams>(id, data)
 {
-    if (data.size() >= 2) {
-        this->params.bitNumber = data[0];
-        this->params.direction = data[1];
-    }
 }
 TDIO_ConfigureBit::TDIO_ConfigureBit(DataItemIds id, __u8 bitNumber, __u8 direction)
     : TDataItem<DIO_ConfigureBitParams>(id, {})
@@ -149,7 +123,7 @@ TDIO_ConfigureBit::TDIO_ConfigureBit(DataItemIds id, __u8 bitNumber, __u8 direct
     this->params.direction = direction;
 }
 TDataItemBase &TDIO_ConfigureBit::Go() {
-    __u32 regValue = in(ofsDioDirections);
+    __u32 regValue = Shadow.Read(ofsDioDirections);
     regValue &= ~(1 << this->params.bitNumber);
     if (this->params.direction) {
         regValue |= (1 << this->params.bitNumber);
@@ -157,12 +131,6 @@ TDataItemBase &TDIO_ConfigureBit::Go() {
     out(ofsDioDirections, regValue);
     return *this;
 }
-TBytes TDIO_ConfigureBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    bytes.push_back(this->params.direction);
-    return bytes;
-}
 std::string TDIO_ConfigureBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_ConfigureBit(bitNumber=" << std::dec << static_cast<int>(this->params.bitNumber)
@@ -173,7 +141,7 @@ std::string TDIO_ConfigureBit::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_InputBit Implementation
 // --------------------------------------------------------------------------
-TDIO_InputBit::TDIO_InputBit(DataItemIds id, const TBytes &data)
+TDIO_InputBit::TDIO_InputBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_InputBitParams>(id, data)
 {
     if (data.size() >= 1) {
@@ -187,16 +155,15 @@ TDIO_InputBit::TDIO_InputBit(DataItemIds id, __u8 bitNumber)
 }
 TDataItemBase &TDIO_InputBit::Go() {
     __u32 regValue = in(ofsDioInputs);
+    Snapshot.PublishDioInputs(static_cast<__u16>(regValue & 0xFFFF));
     this->params.bitValue = (__u8)((regValue >> this->params.bitNumber) & 1);
     return *this;
 }
 TBytes TDIO_InputBit::calcPayload(bool bAsReply) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    if (bAsReply) {
-        bytes.push_back(this->params.bitValue);
-    }
-    return bytes;
+    // request is just bitNumber; the reply adds bitValue
+    if (bAsReply)
+        return TParamLayout<DIO_InputBitParams>::Encode(this->params);
+    return TBytes{this->params.bitNumber};
 }
 std::string TDIO_InputBit::AsString(bool bAsReply) {
     std::stringstream ss;
@@ -214,13 +181,9 @@ std::shared_ptr<void> TDIO_InputBit::getResultValue() {
 // --------------------------------------------------------------------------
 // TDIO_OutputBit Implementation
 // --------------------------------------------------------------------------
-TDIO_OutputBit::TDIO_OutputBit(DataItemIds id, const TBytes &data)
+TDIO_OutputBit::TDIO_OutputBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_OutputBitParams>(id, data)
 {
-    if (data.size() >= 2) {
-        this->params.bitNumber = data[0];
-        this->params.value = data[1];
-    }
 }
 TDIO_OutputBit::TDIO_OutputBit(DataItemIds id, __u8 bitNumber, __u8 value)
     : TDataItem<DIO_OutputBitParams>(id, {})
@@ -229,7 +192,7 @@ TDIO_OutputBit::TDIO_OutputBit(DataItemIds id, __u8 bitNumber, __u8 value)
     this->params.value = value;
 }
 TDataItemBase &TDIO_OutputBit::Go() {
-    __u32 regValue = in(ofsDioOutputs);
+    __u32 regValue = Shadow.Read(ofsDioOutputs);
     regValue &= ~(1 << this->params.bitNumber);
     if (this->params.value) {
         regValue |= (1 << this->params.bitNumber);
@@ -237,12 +200,6 @@ TDataItemBase &TDIO_OutputBit::Go() {
     out(ofsDioOutputs, regValue);
     return *this;
 }
-TBytes TDIO_OutputBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    bytes.push_back(this->params.value);
-    return bytes;
-}
 std::string TDIO_OutputBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "DIO_OutputBit(bitNumber=" << std::dec << static_cast<int>(this->params.bitNumber)
@@ -253,12 +210,9 @@ std::string TDIO_OutputBit::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_ClearBit Implementation
 // --------------------------------------------------------------------------
-TDIO_ClearBit::TDIO_ClearBit(DataItemIds id, const TBytes &data)
+TDIO_ClearBit::TDIO_ClearBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_ClearBitParams>(id, data)
 {
-    if (data.size() >= 1) {
-        this->params.bitNumber = data[0];
-    }
 }
 TDIO_ClearBit::TDIO_ClearBit(DataItemIds id, __u8 bitNumber)
     : TDataItem<DIO_ClearBitParams>(id, {})
@@ -266,16 +220,11 @@ TDIO_ClearBit::TDIO_ClearBit(DataItemIds id, __u8 bitNumber)
     this->params.bitNumber = bitNumber;
 }
 TDataItemBase &TDIO_ClearBit::Go() {
-    __u32 regValue = in(ofsDioOutputs);
+    __u32 regValue = Shadow.Read(ofsDioOutputs);
     regValue &= ~(1 << this->params.bitNumber);
     out(ofsDioOutputs, regValue);
     return *this;
 }
-TBytes TDIO_ClearBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    return bytes;
-}
 std::string TDIO_ClearBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_ClearBit(bitNumber=" << std::dec << static_cast<int>(this->params.bitNumber) << ")";
@@ -285,12 +234,9 @@ std::string TDIO_ClearBit::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_SetBit Implementation
 // --------------------------------------------------------------------------
-TDIO_SetBit::TDIO_SetBit(DataItemIds id, const TBytes &data)
+TDIO_SetBit::TDIO_SetBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_SetBitParams>(id, data)
 {
-    if (data.size() >= 1) {
-        this->params.bitNumber = data[0];
-    }
 }
 TDIO_SetBit::TDIO_SetBit(DataItemIds id, __u8 bitNumber)
     : TDataItem<DIO_SetBitParams>(id, {})
@@ -298,16 +244,11 @@ TDIO_SetBit::TDIO_SetBit(DataItemIds id, __u8 bitNumber)
     this->params.bitNumber = bitNumber;
 }
 TDataItemBase &TDIO_SetBit::Go() {
-    __u32 regValue = in(ofsDioOutputs);
+    __u32 regValue = Shadow.Read(ofsDioOutputs);
     regValue |= (1 << this->params.bitNumber);
     out(ofsDioOutputs, regValue);
     return *this;
 }
-TBytes TDIO_SetBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    return bytes;
-}
 std::string TDIO_SetBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_SetBit(bitNumber=" << std::dec << static_cast<int>(this->params.bitNumber) << ")";
@@ -317,12 +258,9 @@ std::string TDIO_SetBit::AsString(bool /*bAsReply*/) {
 // --------------------------------------------------------------------------
 // TDIO_ToggleBit Implementation
 // --------------------------------------------------------------------------
-TDIO_ToggleBit::TDIO_ToggleBit(DataItemIds id, const TBytes &data)
+TDIO_ToggleBit::TDIO_ToggleBit(DataItemIds id, TByteSpan data)
     : TDataItem<DIO_ToggleBitParams>(id, data)
 {
-    if (data.size() >= 1) {
-        this->params.bitNumber = data[0];
-    }
 }
 TDIO_ToggleBit::TDIO_ToggleBit(DataItemIds id, __u8 bitNumber)
     : TDataItem<DIO_ToggleBitParams>(id, {})
@@ -330,16 +268,11 @@ TDIO_ToggleBit::TDIO_ToggleBit(DataItemIds id, __u8 bitNumber)
     this->params.bitNumber = bitNumber;
 }
 TDataItemBase &TDIO_ToggleBit::Go() {
-    __u32 regValue = in(ofsDioOutputs);
+    __u32 regValue = Shadow.Read(ofsDioOutputs);
     regValue ^= (1 << this->params.bitNumber);
     out(ofsDioOutputs, regValue);
     return *this;
 }
-TBytes TDIO_ToggleBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    bytes.push_back(this->params.bitNumber);
-    return bytes;
-}
 std::string TDIO_ToggleBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TDIO_ToggleBit(bitNumber=" << std::dec << static_cast<int>(this->params.bitNumber) << ")";
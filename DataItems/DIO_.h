@@ -10,44 +10,62 @@ struct DIO_ConfigureBitParams {
     __u8 bitNumber;  // Which digital bit (0..15)
     __u8 direction;  // 1 = input, 0 = output
 };
+template <> struct TParamLayout<DIO_ConfigureBitParams>
+    : TParamCodec<DIO_ConfigureBitParams, PARAM_FIELD(DIO_ConfigureBitParams, bitNumber), PARAM_FIELD(DIO_ConfigureBitParams, direction)> {};
 
 struct DIO_InputBitParams {
     __u8 bitNumber;
     __u8 bitValue;   // Result after reading (0 or 1)
 };
+template <> struct TParamLayout<DIO_InputBitParams>
+    : TParamCodec<DIO_InputBitParams, PARAM_FIELD(DIO_InputBitParams, bitNumber), PARAM_FIELD(DIO_InputBitParams, bitValue)> {};
 
 struct DIO_OutputBitParams {
     __u8 bitNumber;
     __u8 value;      // Desired output value (0 or 1)
 };
+template <> struct TParamLayout<DIO_OutputBitParams>
+    : TParamCodec<DIO_OutputBitParams, PARAM_FIELD(DIO_OutputBitParams, bitNumber), PARAM_FIELD(DIO_OutputBitParams, value)> {};
 
 struct DIO_ClearBitParams {
     __u8 bitNumber;
 };
+template <> struct TParamLayout<DIO_ClearBitParams>
+    : TParamCodec<DIO_ClearBitParams, PARAM_FIELD(DIO_ClearBitParams, bitNumber)> {};
 
 struct DIO_SetBitParams {
     __u8 bitNumber;
 };
+template <> struct TParamLayout<DIO_SetBitParams>
+    : TParamCodec<DIO_SetBitParams, PARAM_FIELD(DIO_SetBitParams, bitNumber)> {};
 
 struct DIO_ToggleBitParams {
     __u8 bitNumber;
 };
+template <> struct TParamLayout<DIO_ToggleBitParams>
+    : TParamCodec<DIO_ToggleBitParams, PARAM_FIELD(DIO_ToggleBitParams, bitNumber)> {};
 
 // For configuring all 16 digital channels (direction only).
 // Each bit in 'value' represents a channel: 1=input, 0=output.
 struct TDIO_ConfigureParams {
     __u16 value;
 };
+template <> struct TParamLayout<TDIO_ConfigureParams>
+    : TParamCodec<TDIO_ConfigureParams, PARAM_FIELD(TDIO_ConfigureParams, value)> {};
 
 // For reading digital input (16 bits).
 struct TDIO_InputParams {
     __u16 value;  // This will be filled with the 16-bit input state.
 };
+template <> struct TParamLayout<TDIO_InputParams>
+    : TParamCodec<TDIO_InputParams, PARAM_FIELD(TDIO_InputParams, value)> {};
 
 // For writing digital output (16 bits).
 struct TDIO_OutputParams {
     __u16 value;
 };
+template <> struct TParamLayout<TDIO_OutputParams>
+    : TParamCodec<TDIO_OutputParams, PARAM_FIELD(TDIO_OutputParams, value)> {};
 
 // --------------------------------------------------------------------------
 // TDIO_Configure: Configures directions for all 16 digital I/O bits.
@@ -55,11 +73,10 @@ struct TDIO_OutputParams {
 // --------------------------------------------------------------------------
 class TDIO_Configure : public TDataItem<TDIO_ConfigureParams> {
 public:
-    TDIO_Configure(DataItemIds id, const TBytes &data);
+    TDIO_Configure(DataItemIds id, TByteSpan data);
     TDIO_Configure(DataItemIds id, __u16 value);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -69,7 +86,7 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_Input : public TDataItem<TDIO_InputParams> {
 public:
-    TDIO_Input(DataItemIds id, const TBytes &data);
+    TDIO_Input(DataItemIds id, TByteSpan data);
     TDIO_Input(DataItemIds id);
 
     virtual TDataItemBase &Go() override;
@@ -84,11 +101,10 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_Output : public TDataItem<TDIO_OutputParams> {
 public:
-    TDIO_Output(DataItemIds id, const TBytes &data);
+    TDIO_Output(DataItemIds id, TByteSpan data);
     TDIO_Output(DataItemIds id, __u16 value);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -98,11 +114,10 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_ConfigureBit : public TDataItem<DIO_ConfigureBitParams> {
 public:
-    TDIO_ConfigureBit(DataItemIds id, const TBytes &data);
+    TDIO_ConfigureBit(DataItemIds id, TByteSpan data);
     TDIO_ConfigureBit(DataItemIds id, __u8 bitNumber, __u8 direction);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -111,7 +126,7 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_InputBit : public TDataItem<DIO_InputBitParams> {
 public:
-    TDIO_InputBit(DataItemIds id, const TBytes &data);
+    TDIO_InputBit(DataItemIds id, TByteSpan data);
     TDIO_InputBit(DataItemIds id, __u8 bitNumber);
 
     virtual TDataItemBase &Go() override;
@@ -125,11 +140,10 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_OutputBit : public TDataItem<DIO_OutputBitParams> {
 public:
-    TDIO_OutputBit(DataItemIds id, const TBytes &data);
+    TDIO_OutputBit(DataItemIds id, TByteSpan data);
     TDIO_OutputBit(DataItemIds id, __u8 bitNumber, __u8 value);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -138,11 +152,10 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_ClearBit : public TDataItem<DIO_ClearBitParams> {
 public:
-    TDIO_ClearBit(DataItemIds id, const TBytes &data);
+    TDIO_ClearBit(DataItemIds id, TByteSpan data);
     TDIO_ClearBit(DataItemIds id, __u8 bitNumber);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -151,11 +164,10 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_SetBit : public TDataItem<DIO_SetBitParams> {
 public:
-    TDIO_SetBit(DataItemIds id, const TBytes &data);
+    TDIO_SetBit(DataItemIds id, TByteSpan data);
     TDIO_SetBit(DataItemIds id, __u8 bitNumber);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -164,10 +176,9 @@ public:
 // --------------------------------------------------------------------------
 class TDIO_ToggleBit : public TDataItem<DIO_ToggleBitParams> {
 public:
-    TDIO_ToggleBit(DataItemIds id, const TBytes &data);
+    TDIO_ToggleBit(DataItemIds id, TByteSpan data);
     TDIO_ToggleBit(DataItemIds id, __u8 bitNumber);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
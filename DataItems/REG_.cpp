@@ -2,6 +2,7 @@
 #include "../apci.h"
 #include "../eNET-AIO16-16F.h"
 #include "../logging.h"
+#include "../shadow.h"
 #include "../utilities.h"
 #include "TDataItem.h"
 
@@ -34,7 +35,7 @@ std::shared_ptr<void> TREG_Read1::getResultValue()
     }
 }
 
-TError TREG_Read1::validateDataItemPayload(DataItemIds DataItemID, TBytes Data)
+TError TREG_Read1::validateDataItemPayload(DataItemIds DataItemID, TByteSpan Data)
 {
     TError result = ERR_SUCCESS;
     if (Data.size() != 1)
@@ -75,7 +76,7 @@ TREG_Read1::TREG_Read1(const TBytes &data)
     this->params.width = w;
 }
 
-TREG_Read1::TREG_Read1(DataItemIds id, const TBytes &FromBytes)
+TREG_Read1::TREG_Read1(DataItemIds id, TByteSpan FromBytes)
     : TDataItem<REG_Read1Params>(id, FromBytes)
 {
     if (!FromBytes.empty())
@@ -150,7 +151,182 @@ std::string TREG_Read1::AsString(bool bAsReply)
     return dest.str();
 }
 
-// ======================== TREG_Writes ========================
+// a write to offset goes out over SPI (the DAC, the DIO): waits for the previous one to finish.  0, or -ETIMEDOUT
+static TError WaitForSpi(int offset)
+{
+    switch (offset)
+    {
+    case ofsDac:
+        return WaitUntilRegisterBitIsLow(ofsDacSpiBusy, bmDacSpiBusy);
+    case ofsDioDirections:
+    case ofsDioOutputs:
+    case ofsDioInputs:
+        return WaitUntilRegisterBitIsLow(ofsDioSpiBusy, bmDioSpiBusy);
+    default:
+        return 0;
+    }
+}
+
+// ======================== TREG_ReadBuf ========================
+
+TREG_ReadBuf::TREG_ReadBuf(DataItemIds id, TByteSpan FromBytes)
+    : TDataItem<REG_BufParams>(id, FromBytes), values(CurrentArena())
+{
+    GUARD(FromBytes.size() == 3, ERR_DId_BAD_PARAM, static_cast<int>(FromBytes.size()));
+    this->params.offset = FromBytes[0];
+    this->params.width  = widthFromOffset(this->params.offset);
+    GUARD(this->params.width != 0, ERR_DId_BAD_OFFSET, this->params.offset);
+    this->params.count  = static_cast<__u16>(FromBytes[1] | (FromBytes[2] << 8));
+    GUARD((this->params.count > 0) && (this->params.count * (this->params.width / 8) <= REG_BufMaxBytes),
+          ERR_DId_BAD_PARAM, this->params.count);
+}
+
+TREG_ReadBuf &TREG_ReadBuf::Go()
+{
+    this->values.resize(this->params.count * (this->params.width / 8));
+    this->resultCode = inBuf(this->params.offset, this->values.data(), this->params.count);
+    if (this->resultCode)
+        Error("REG_ReadBuf(" + to_hex<__u8>(this->params.offset) + ", " + std::to_string(this->params.count) + ") failed part way");
+    return *this;
+}
+
+TBytes TREG_ReadBuf::calcPayload(bool bAsReply)
+{
+    TBytes bytes(this->rawBytes.begin(), this->rawBytes.end());
+    if (bAsReply)
+        bytes.insert(bytes.end(), this->values.begin(), this->values.end());
+    return bytes;
+}
+
+std::string TREG_ReadBuf::AsString(bool bAsReply)
+{
+    std::stringstream dest;
+    dest << "REG_ReadBuf(" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(this->params.offset)
+         << ", " << std::dec << this->params.count << ")";
+    if (bAsReply)
+        dest << " → " << (this->values.size() / (this->params.width / 8)) << " × u" << this->params.width;
+    return dest.str();
+}
+
+// ======================== TREG_ReadAll ========================
+
+// registers REG_ReadAll doesn't read: write-only, or reading them changes the board
+static const __u8 RegReadAllSkip[] = {
+    ofsReset,            // write-only
+    ofsAdcSoftwareStart, // write-only; a write starts a scan
+    ofsAdcDataFifo,      // a read pops the FIFO
+    ofsFlashData,        // flash is factory-use only; a read steps the flash address
+    ofsFlashErase,       // write-only
+};
+
+// the offsets REG_ReadAll reads, worked out once
+static const std::vector<__u8> &RegReadAllOffsets()
+{
+    static const std::vector<__u8> offsets = [] {
+        std::vector<__u8> list;
+        for (int ofs = 0; ofs <= 0xFC; ofs++)
+            if (widthFromOffset(ofs) && (std::find(std::begin(RegReadAllSkip), std::end(RegReadAllSkip), ofs) == std::end(RegReadAllSkip)))
+                list.push_back(static_cast<__u8>(ofs));
+        return list;
+    }();
+    return offsets;
+}
+
+TREG_ReadAll::TREG_ReadAll(DataItemIds id, TByteSpan FromBytes)
+    : TDataItem<REG_BufParams>(id, FromBytes), values(CurrentArena())
+{
+    GUARD(FromBytes.size() == 0, ERR_DId_BAD_PARAM, static_cast<int>(FromBytes.size()));
+}
+
+TREG_ReadAll &TREG_ReadAll::Go()
+{
+    const std::vector<__u8> &offsets = RegReadAllOffsets();
+    this->values.resize(offsets.size() * 5); // at most; 8-bit registers take two bytes, not five
+    __u8 *dest = this->values.data();
+    for (__u8 ofs : offsets)
+    {
+        const __u32 value = in(ofs);
+        *dest++ = ofs;
+        const int bytes = widthFromOffset(ofs) / 8;
+        memcpy(dest, &value, bytes);
+        dest += bytes;
+    }
+    this->values.resize(dest - this->values.data());
+    this->params.count = static_cast<__u16>(offsets.size());
+    return *this;
+}
+
+TBytes TREG_ReadAll::calcPayload(bool bAsReply)
+{
+    return bAsReply ? TBytes(this->values.begin(), this->values.end()) : TBytes{};
+}
+
+std::string TREG_ReadAll::AsString(bool bAsReply)
+{
+    if (!bAsReply)
+        return "REG_ReadAll()";
+    return "REG_ReadAll() → " + std::to_string(this->params.count) + " registers";
+}
+
+// ======================== TREG_WriteBuf ========================
+
+TREG_WriteBuf::TREG_WriteBuf(DataItemIds id, TByteSpan FromBytes)
+    : TDataItem<REG_BufParams>(id, FromBytes)
+{
+    GUARD(FromBytes.size() >= 2, ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH, static_cast<int>(FromBytes.size()));
+    this->params.offset = FromBytes[0];
+    this->params.width  = widthFromOffset(this->params.offset);
+    GUARD(this->params.width != 0, ERR_DId_BAD_OFFSET, this->params.offset);
+    const size_t bytes = FromBytes.size() - 1;
+    GUARD((bytes % (this->params.width / 8) == 0) && (bytes <= REG_BufMaxBytes), ERR_DId_BAD_PARAM, static_cast<int>(bytes));
+    this->params.count  = static_cast<__u16>(bytes / (this->params.width / 8));
+}
+
+TREG_WriteBuf &TREG_WriteBuf::Go()
+{
+    const __u8 *from = this->rawBytes.data() + 1;
+    const int bytes = this->params.width / 8;
+    this->resultCode = 0;
+    switch (this->params.offset)
+    {
+    case ofsDac:
+    case ofsDioDirections:
+    case ofsDioOutputs:
+    case ofsDioInputs:
+        // each value has to wait for the SPI write before it, so no one-call path for these; a timeout ends the run
+        for (int i = 0; i < this->params.count; i++, from += bytes)
+        {
+            this->resultCode = WaitForSpi(this->params.offset);
+            if (this->resultCode)
+                break;
+            __u32 value = 0;
+            memcpy(&value, from, bytes);
+            out(this->params.offset, value);
+        }
+        break;
+    default:
+        this->resultCode = outBuf(this->params.offset, from, this->params.count);
+        break;
+    }
+    if (this->resultCode)
+        Error("REG_WriteBuf(" + to_hex<__u8>(this->params.offset) + ", " + std::to_string(this->params.count) + ") failed part way");
+    return *this;
+}
+
+TBytes TREG_WriteBuf::calcPayload(bool bAsReply)
+{
+    if (!bAsReply)
+        return TBytes(this->rawBytes.begin(), this->rawBytes.end());
+    return TBytes{this->params.offset, static_cast<__u8>(this->params.count & 0xFF), static_cast<__u8>(this->params.count >> 8)};
+}
+
+std::string TREG_WriteBuf::AsString(bool bAsReply)
+{
+    std::stringstream dest;
+    dest << "REG_WriteBuf(" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(this->params.offset)
+         << ", " << std::dec << this->params.count << " × u" << this->params.width << ")";
+    return dest.str();
+}
 
 TREG_Writes::TREG_Writes(DataItemIds id)
     : TDataItem<REG_WritesParams>(id, {})
@@ -174,7 +350,7 @@ TREG_Writes::TREG_Writes(const TBytes &buf)
     Trace("CHAINING1");
 }
 
-TREG_Writes::TREG_Writes(DataItemIds id, const TBytes &FromBytes)
+TREG_Writes::TREG_Writes(DataItemIds id, TByteSpan FromBytes)
     : TDataItem<REG_WritesParams>(id, FromBytes)
 {
     Trace("CHAINING2");
@@ -186,19 +362,7 @@ TREG_Writes &TREG_Writes::Go()
     for (auto &action : this->params.Writes)
     {
         // e.g., DAC / DIO SPI busy checks
-        switch (action.offset)
-        {
-        case ofsDac:
-            this->resultCode = WaitUntilRegisterBitIsLow(ofsDacSpiBusy, bmDacSpiBusy);
-            break;
-        case ofsDioDirections:
-        case ofsDioOutputs:
-        case ofsDioInputs:
-            this->resultCode = WaitUntilRegisterBitIsLow(ofsDioSpiBusy, bmDioSpiBusy);
-            break;
-        default:
-            break;
-        }
+        this->resultCode = WaitForSpi(action.offset);
         out(action.offset, action.value);
 
         if (action.width == 8)
@@ -249,7 +413,7 @@ TREG_Write1::~TREG_Write1()
     this->params.Writes.clear();
 }
 
-TREG_Write1::TREG_Write1(DataItemIds ID, const TBytes &buf)
+TREG_Write1::TREG_Write1(DataItemIds ID, TByteSpan buf)
     : TREG_Writes(DataItemIds::REG_Write1, buf)
 {
     GUARD(buf.size() > 0, ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH, 0);
@@ -293,7 +457,7 @@ TBytes TREG_Write1::calcPayload(bool bAsReply)
 }
 
 
-TREG_ReadBit::TREG_ReadBit(DataItemIds id, const TBytes &data)
+TREG_ReadBit::TREG_ReadBit(DataItemIds id, TByteSpan data)
     : TDataItem<REG_ReadBitParams>(id, data)
 {
     // Expect at least 2 bytes: offset and bitIndex.
@@ -319,15 +483,10 @@ TDataItemBase &TREG_ReadBit::Go() {
 }
 
 TBytes TREG_ReadBit::calcPayload(bool bAsReply) {
-    TBytes bytes;
-    // Always include offset and bitIndex.
-    bytes.push_back(this->params.offset);
-    bytes.push_back(this->params.bitIndex);
-    if (bAsReply) {
-        // Append the result bit.
-        bytes.push_back(this->params.bitValue);
-    }
-    return bytes;
+    // Always include offset and bitIndex; the reply appends the result bit.
+    if (bAsReply)
+        return TParamLayout<REG_ReadBitParams>::Encode(this->params);
+    return TBytes{this->params.offset, this->params.bitIndex};
 }
 
 std::string TREG_ReadBit::AsString(bool bAsReply) {
@@ -351,15 +510,9 @@ std::shared_ptr<void> TREG_ReadBit::getResultValue() {
 // TREG_WriteBit Implementation
 // --------------------------------------------------------------------------
 
-TREG_WriteBit::TREG_WriteBit(DataItemIds id, const TBytes &data)
+TREG_WriteBit::TREG_WriteBit(DataItemIds id, TByteSpan data)
     : TDataItem<REG_WriteBitParams>(id, data)
 {
-    // Expect at least 3 bytes: offset, bitIndex, value.
-    if(data.size() >= 3) {
-        this->params.offset = data[0];
-        this->params.bitIndex = data[1];
-        this->params.value = data[2];
-    }
 }
 
 TREG_WriteBit::TREG_WriteBit(DataItemIds id, __u8 offset, __u8 bitIndex, __u8 value)
@@ -371,7 +524,7 @@ TREG_WriteBit::TREG_WriteBit(DataItemIds id, __u8 offset, __u8 bitIndex, __u8 va
 }
 
 TDataItemBase &TREG_WriteBit::Go() {
-    __u32 regValue = in(this->params.offset);
+    __u32 regValue = Shadow.Read(this->params.offset);
     // Clear the target bit.
     regValue &= ~(1 << this->params.bitIndex);
     // Set the bit if value is 1.
@@ -382,15 +535,6 @@ TDataItemBase &TREG_WriteBit::Go() {
     return *this;
 }
 
-TBytes TREG_WriteBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    // Serialize the command: offset, bitIndex, value.
-    bytes.push_back(this->params.offset);
-    bytes.push_back(this->params.bitIndex);
-    bytes.push_back(this->params.value);
-    return bytes;
-}
-
 std::string TREG_WriteBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TREG_WriteBit(offset=0x" << std::hex << std::setw(2) << std::setfill('0')
@@ -404,14 +548,9 @@ std::string TREG_WriteBit::AsString(bool /*bAsReply*/) {
 // TREG_ClearBit Implementation
 // --------------------------------------------------------------------------
 
-TREG_ClearBit::TREG_ClearBit(DataItemIds id, const TBytes &data)
+TREG_ClearBit::TREG_ClearBit(DataItemIds id, TByteSpan data)
     : TDataItem<REG_ClearBitParams>(id, data)
 {
-    // Expect at least 2 bytes: offset and bitIndex.
-    if(data.size() >= 2) {
-        this->params.offset = data[0];
-        this->params.bitIndex = data[1];
-    }
 }
 
 TREG_ClearBit::TREG_ClearBit(DataItemIds id, __u8 offset, __u8 bitIndex)
@@ -423,7 +562,7 @@ TREG_ClearBit::TREG_ClearBit(DataItemIds id, __u8 offset, __u8 bitIndex)
 
 TDataItemBase &TREG_ClearBit::Go() {
     // Read the full register value.
-    __u32 regValue = in(this->params.offset);
+    __u32 regValue = Shadow.Read(this->params.offset);
     // Clear the target bit.
     regValue &= ~(1 << this->params.bitIndex);
     // Write the updated value back.
@@ -431,14 +570,6 @@ TDataItemBase &TREG_ClearBit::Go() {
     return *this;
 }
 
-TBytes TREG_ClearBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    // Serialize the command: offset and bitIndex.
-    bytes.push_back(this->params.offset);
-    bytes.push_back(this->params.bitIndex);
-    return bytes;
-}
-
 std::string TREG_ClearBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TREG_ClearBit(offset=0x" << std::hex << std::setw(2) << std::setfill('0')
@@ -451,14 +582,9 @@ std::string TREG_ClearBit::AsString(bool /*bAsReply*/) {
 // TREG_SetBit Implementation
 // --------------------------------------------------------------------------
 
-TREG_SetBit::TREG_SetBit(DataItemIds id, const TBytes &data)
+TREG_SetBit::TREG_SetBit(DataItemIds id, TByteSpan data)
     : TDataItem<REG_SetBitParams>(id, data)
 {
-    // Expect at least 2 bytes: offset and bitIndex.
-    if(data.size() >= 2) {
-        this->params.offset = data[0];
-        this->params.bitIndex = data[1];
-    }
 }
 
 TREG_SetBit::TREG_SetBit(DataItemIds id, __u8 offset, __u8 bitIndex)
@@ -469,21 +595,13 @@ TREG_SetBit::TREG_SetBit(DataItemIds id, __u8 offset, __u8 bitIndex)
 }
 
 TDataItemBase &TREG_SetBit::Go() {
-    __u32 regValue = in(this->params.offset);
+    __u32 regValue = Shadow.Read(this->params.offset);
     // Set the target bit.
     regValue |= (1 << this->params.bitIndex);
     out(this->params.offset, regValue);
     return *this;
 }
 
-TBytes TREG_SetBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    // Serialize the command: offset and bitIndex.
-    bytes.push_back(this->params.offset);
-    bytes.push_back(this->params.bitIndex);
-    return bytes;
-}
-
 std::string TREG_SetBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TREG_SetBit(offset=0x" << std::hex << std::setw(2) << std::setfill('0')
@@ -496,14 +614,9 @@ std::string TREG_SetBit::AsString(bool /*bAsReply*/) {
 // TREG_ToggleBit Implementation
 // --------------------------------------------------------------------------
 
-TREG_ToggleBit::TREG_ToggleBit(DataItemIds id, const TBytes &data)
+TREG_ToggleBit::TREG_ToggleBit(DataItemIds id, TByteSpan data)
     : TDataItem<REG_ToggleBitParams>(id, data)
 {
-    // Expect at least 2 bytes: offset and bitIndex.
-    if(data.size() >= 2) {
-        this->params.offset = data[0];
-        this->params.bitIndex = data[1];
-    }
 }
 
 TREG_ToggleBit::TREG_ToggleBit(DataItemIds id, __u8 offset, __u8 bitIndex)
@@ -514,21 +627,13 @@ TREG_ToggleBit::TREG_ToggleBit(DataItemIds id, __u8 offset, __u8 bitIndex)
 }
 
 TDataItemBase &TREG_ToggleBit::Go() {
-    __u32 regValue = in(this->params.offset);
+    __u32 regValue = Shadow.Read(this->params.offset);
     // Toggle the designated bit.
     regValue ^= (1 << this->params.bitIndex);
     out(this->params.offset, regValue);
     return *this;
 }
 
-TBytes TREG_ToggleBit::calcPayload(bool /*bAsReply*/) {
-    TBytes bytes;
-    // Serialize offset and bitIndex.
-    bytes.push_back(this->params.offset);
-    bytes.push_back(this->params.bitIndex);
-    return bytes;
-}
-
 std::string TREG_ToggleBit::AsString(bool /*bAsReply*/) {
     std::stringstream ss;
     ss << "TREG_ToggleBit(offset=0x" << std::hex << std::setw(2) << std::setfill('0')
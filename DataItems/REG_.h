@@ -16,13 +16,13 @@ struct REG_Read1Params {
 class TREG_Read1 : public TDataItem<REG_Read1Params>
 {
 public:
-    static TError validateDataItemPayload(DataItemIds DataItemID, TBytes Data);
+    static TError validateDataItemPayload(DataItemIds DataItemID, TByteSpan Data);
 
     // Constructors
     explicit TREG_Read1(const TBytes &data);
     TREG_Read1();
     TREG_Read1(DataItemIds id, int ofs);
-    TREG_Read1(DataItemIds id, const TBytes &FromBytes);
+    TREG_Read1(DataItemIds id, TByteSpan FromBytes);
 
     // Core methods
     virtual TBytes calcPayload(bool bAsReply=false) override;
@@ -37,6 +37,58 @@ private:
     // No separate Value field; it is in `this->params.regVal`
 };
 
+// -------------- TREG_ReadBuf / TREG_WriteBuf --------------
+// many reads or writes of one register (draining or filling a FIFO, say) in one DataItem, each widthFromOffset() wide,
+// little-endian; one inBuf()/outBuf() call instead of a REG_Read1/REG_Write1 apiece
+#define REG_BufMaxBytes (0xFFFF - 3) // values in one REG_ReadBuf reply or REG_WriteBuf request: the rest of a DataItem
+
+struct REG_BufParams {
+    __u8 offset  = 0;
+    int width    = 0;
+    __u16 count  = 0; // values to read, or in the request
+};
+
+// (u8 ofs, u16 count) → [u8 ofs, u16 count, count × (u8|u32)]
+class TREG_ReadBuf : public TDataItem<REG_BufParams>
+{
+public:
+    TREG_ReadBuf(DataItemIds id, TByteSpan FromBytes);
+
+    virtual TBytes calcPayload(bool bAsReply=false) override;
+    virtual TREG_ReadBuf &Go() override;
+    virtual std::string AsString(bool bAsReply = false) override;
+
+private:
+    TArenaBytes values; // what Go() read
+};
+
+// (u8 ofs, n × (u8|u32)) → [u8 ofs, u16 n]; the values aren't echoed back
+class TREG_WriteBuf : public TDataItem<REG_BufParams>
+{
+public:
+    TREG_WriteBuf(DataItemIds id, TByteSpan FromBytes);
+
+    virtual TBytes calcPayload(bool bAsReply=false) override;
+    virtual TREG_WriteBuf &Go() override;
+    virtual std::string AsString(bool bAsReply = false) override;
+};
+
+// -------------- TREG_ReadAll --------------
+// () → [(u8 ofs, u8|u32 value) for every register 0x00-0xFC that can be read without side effects]: the whole
+// register file in one DataItem, for diagnostics; the registers it leaves out are listed in REG_.cpp
+class TREG_ReadAll : public TDataItem<REG_BufParams>
+{
+public:
+    TREG_ReadAll(DataItemIds id, TByteSpan FromBytes);
+
+    virtual TBytes calcPayload(bool bAsReply=false) override;
+    virtual TREG_ReadAll &Go() override;
+    virtual std::string AsString(bool bAsReply = false) override;
+
+private:
+    TArenaBytes values; // what Go() read, as the reply lays it out
+};
+
 // -------------- TREG_Writes --------------
 // typedef struct
 // {
@@ -59,7 +111,7 @@ public:
     virtual ~TREG_Writes();
 
     explicit TREG_Writes(const TBytes &buf);
-    TREG_Writes(DataItemIds id, const TBytes &FromBytes);
+    TREG_Writes(DataItemIds id, TByteSpan FromBytes);
 
     virtual TREG_Writes &Go() override;
     TREG_Writes &addWrite(__u8 w, int ofs, __u32 value);
@@ -73,9 +125,9 @@ public:
 class TREG_Write1 : public TREG_Writes
 {
 public:
-    static TError validateDataItemPayload(DataItemIds DataItemID, TBytes Data);
+    static TError validateDataItemPayload(DataItemIds DataItemID, TByteSpan Data);
 
-    TREG_Write1(DataItemIds ID, const TBytes &buf);
+    TREG_Write1(DataItemIds ID, TByteSpan buf);
     virtual ~TREG_Write1();
 
     virtual TBytes calcPayload(bool bAsReply=false) override;
@@ -91,27 +143,37 @@ struct REG_ReadBitParams {
     __u8 bitIndex;  // Bit index within the register
     __u8 bitValue;  // Result (0 or 1) after reading
 };
+template <> struct TParamLayout<REG_ReadBitParams>
+    : TParamCodec<REG_ReadBitParams, PARAM_FIELD(REG_ReadBitParams, offset), PARAM_FIELD(REG_ReadBitParams, bitIndex), PARAM_FIELD(REG_ReadBitParams, bitValue)> {};
 
 struct REG_WriteBitParams {
     __u8 offset;    // Register offset to write to
     __u8 bitIndex;  // Bit index within the register
     __u8 value;     // Bit value to write (0 or 1)
 };
+template <> struct TParamLayout<REG_WriteBitParams>
+    : TParamCodec<REG_WriteBitParams, PARAM_FIELD(REG_WriteBitParams, offset), PARAM_FIELD(REG_WriteBitParams, bitIndex), PARAM_FIELD(REG_WriteBitParams, value)> {};
 
 struct REG_ClearBitParams {
     __u8 offset;    // Register offset
     __u8 bitIndex;  // Bit index to clear
 };
+template <> struct TParamLayout<REG_ClearBitParams>
+    : TParamCodec<REG_ClearBitParams, PARAM_FIELD(REG_ClearBitParams, offset), PARAM_FIELD(REG_ClearBitParams, bitIndex)> {};
 
 struct REG_SetBitParams {
     __u8 offset;    // Register offset
     __u8 bitIndex;  // Bit index to set
 };
+template <> struct TParamLayout<REG_SetBitParams>
+    : TParamCodec<REG_SetBitParams, PARAM_FIELD(REG_SetBitParams, offset), PARAM_FIELD(REG_SetBitParams, bitIndex)> {};
 
 struct REG_ToggleBitParams {
     __u8 offset;    // Register offset to modify
     __u8 bitIndex;  // Bit index within the register to toggle
 };
+template <> struct TParamLayout<REG_ToggleBitParams>
+    : TParamCodec<REG_ToggleBitParams, PARAM_FIELD(REG_ToggleBitParams, offset), PARAM_FIELD(REG_ToggleBitParams, bitIndex)> {};
 
 // --------------------------------------------------------------------------
 // Class declarations for individual-bit TREG_ data items
@@ -121,7 +183,7 @@ struct REG_ToggleBitParams {
 class TREG_ReadBit : public TDataItem<REG_ReadBitParams> {
 public:
     // Constructors: one from raw bytes and one from explicit parameters.
-    TREG_ReadBit(DataItemIds id, const TBytes &data);
+    TREG_ReadBit(DataItemIds id, TByteSpan data);
     TREG_ReadBit(DataItemIds id, __u8 offset, __u8 bitIndex);
 
     virtual TDataItemBase &Go() override;
@@ -133,11 +195,10 @@ public:
 // TREG_WriteBit: Reads the register, sets or clears the specified bit, and writes back.
 class TREG_WriteBit : public TDataItem<REG_WriteBitParams> {
 public:
-    TREG_WriteBit(DataItemIds id, const TBytes &data);
+    TREG_WriteBit(DataItemIds id, TByteSpan data);
     TREG_WriteBit(DataItemIds id, __u8 offset, __u8 bitIndex, __u8 value);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
 
@@ -145,32 +206,29 @@ public:
 class TREG_ClearBit : public TDataItem<REG_ClearBitParams> {
     public:
         // Constructors: one from raw bytes and one from explicit parameters.
-        TREG_ClearBit(DataItemIds id, const TBytes &data);
+        TREG_ClearBit(DataItemIds id, TByteSpan data);
         TREG_ClearBit(DataItemIds id, __u8 offset, __u8 bitIndex);
 
         virtual TDataItemBase &Go() override;
-        virtual TBytes calcPayload(bool bAsReply = false) override;
         virtual std::string AsString(bool bAsReply = false) override;
     };
 
     // TREG_SetBit: Sets a single bit (to 1) in a register.
     class TREG_SetBit : public TDataItem<REG_SetBitParams> {
     public:
-        TREG_SetBit(DataItemIds id, const TBytes &data);
+        TREG_SetBit(DataItemIds id, TByteSpan data);
         TREG_SetBit(DataItemIds id, __u8 offset, __u8 bitIndex);
 
         virtual TDataItemBase &Go() override;
-        virtual TBytes calcPayload(bool bAsReply = false) override;
         virtual std::string AsString(bool bAsReply = false) override;
     };
 
 // TREG_ToggleBit: Reads the register, toggles the specified bit, and writes back.
 class TREG_ToggleBit : public TDataItem<REG_ToggleBitParams> {
 public:
-    TREG_ToggleBit(DataItemIds id, const TBytes &data);
+    TREG_ToggleBit(DataItemIds id, TByteSpan data);
     TREG_ToggleBit(DataItemIds id, __u8 offset, __u8 bitIndex);
 
     virtual TDataItemBase &Go() override;
-    virtual TBytes calcPayload(bool bAsReply = false) override;
     virtual std::string AsString(bool bAsReply = false) override;
 };
\ No newline at end of file
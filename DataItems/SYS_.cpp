@@ -14,6 +14,9 @@
 
 #include "SYS_.h"
 #include "../TError.h"
+#include "../admission.h"
+#include "../coalesce.h"
+#include "../shadow.h"
 #include "../utilities.h"
 
 #define PATH_ROOT "/home/acces/eNET_TCP_Server/"
@@ -204,7 +207,7 @@ void UploadFilesByDataItem(TDataItemBase& item)
 }
 
 
-TSYS_UploadFileName::TSYS_UploadFileName(DataItemIds id, TBytes buf)
+TSYS_UploadFileName::TSYS_UploadFileName(DataItemIds id, TByteSpan buf)
      : TDataItemBase(id)
 {
     std::string str = std::string(buf.begin(), buf.end());
@@ -230,7 +233,7 @@ TBytes TSYS_UploadFileName::calcPayload(bool bAsReply)
 
 std::string TSYS_UploadFileName::AsString(bool bAsReply)
 {
-    return DIdDict.find(this->DId)->second.desc;
+    return std::string(DIdDict.find(this->DId)->desc);
 }
 
 TSYS_UploadFileName & TSYS_UploadFileName::Go()
@@ -247,10 +250,10 @@ TSYS_UploadFileName & TSYS_UploadFileName::Go()
 }
 
 
-TSYS_UploadFileData::TSYS_UploadFileData(DataItemIds id, TBytes buf)
+TSYS_UploadFileData::TSYS_UploadFileData(DataItemIds id, TByteSpan buf)
     : TDataItemBase(id)
 {
-    Data = buf;
+    Data.assign(buf.begin(), buf.end());
     //Debug("Buffer received: ", buf);
 }
 
@@ -263,7 +266,7 @@ TBytes TSYS_UploadFileData::calcPayload(bool bAsReply)
 
 std::string TSYS_UploadFileData::AsString(bool bAsReply)
 {
-    return DIdDict.find(this->DId)->second.desc;
+    return std::string(DIdDict.find(this->DId)->desc);
 }
 
 TSYS_UploadFileData & TSYS_UploadFileData::Go()
@@ -281,32 +284,6 @@ TSYS_UploadFileData & TSYS_UploadFileData::Go()
 
 // ---------------- TSYS_Error and TSYS_ItemError Utilities ----------------
 
-static inline __u16 ReadU16LE(const TBytes &b, size_t ofs)
-{
-	if (ofs + 2 > b.size()) return 0;
-	return static_cast<__u16>(static_cast<__u16>(b[ofs]) | (static_cast<__u16>(b[ofs + 1]) << 8));
-}
-
-static inline __u32 ReadU32LE(const TBytes &b, size_t ofs)
-{
-	if (ofs + 4 > b.size()) return 0;
-	return static_cast<__u32>(static_cast<__u32>(b[ofs]) | (static_cast<__u32>(b[ofs + 1]) << 8) | (static_cast<__u32>(b[ofs + 2]) << 16) | (static_cast<__u32>(b[ofs + 3]) << 24));
-}
-
-static inline void WriteU16LE(TBytes &out, __u16 v)
-{
-	out.push_back(static_cast<__u8>(v & 0xFF));
-	out.push_back(static_cast<__u8>((v >> 8) & 0xFF));
-}
-
-static inline void WriteU32LE(TBytes &out, __u32 v)
-{
-	out.push_back(static_cast<__u8>(v & 0xFF));
-	out.push_back(static_cast<__u8>((v >> 8) & 0xFF));
-	out.push_back(static_cast<__u8>((v >> 16) & 0xFF));
-	out.push_back(static_cast<__u8>((v >> 24) & 0xFF));
-}
-
 static inline const char *SafeErrMsgFromCode(__u32 code)
 {
 	const __u32 idx = static_cast<__u32>(-code);
@@ -319,12 +296,9 @@ static inline const char *SafeErrMsgFromCode(__u32 code)
 
 // ---------------- TSYS_Error ----------------
 
-TSYS_Error::TSYS_Error(DataItemIds id, const TBytes &FromBytes)
+TSYS_Error::TSYS_Error(DataItemIds id, TByteSpan FromBytes)
 	: TDataItem<SYS_ErrorParams>(id, FromBytes)
 {
-	this->params.Stage = ReadU32LE(FromBytes, 0);
-	this->params.ErrorCode = ReadU32LE(FromBytes, 4);
-	this->params.Info = ReadU32LE(FromBytes, 8);
 }
 
 TSYS_Error::TSYS_Error(__u32 stage, TError errorCode, __u32 info)
@@ -341,16 +315,6 @@ TSYS_Error &TSYS_Error::Go()
 	return *this;
 }
 
-TBytes TSYS_Error::calcPayload(bool /*bAsReply*/)
-{
-	TBytes out;
-	out.reserve(12);
-	WriteU32LE(out, this->params.Stage);
-	WriteU32LE(out, this->params.ErrorCode);
-	WriteU32LE(out, this->params.Info);
-	return out;
-}
-
 std::string TSYS_Error::AsString(bool /*bAsReply*/)
 {
 	const __u32 idx = static_cast<__u32>(-this->params.ErrorCode);
@@ -359,13 +323,9 @@ std::string TSYS_Error::AsString(bool /*bAsReply*/)
 
 // ---------------- TSYS_ItemError ----------------
 
-TSYS_ItemError::TSYS_ItemError(DataItemIds id, const TBytes &FromBytes)
+TSYS_ItemError::TSYS_ItemError(DataItemIds id, TByteSpan FromBytes)
 	: TDataItem<SYS_ItemErrorParams>(id, FromBytes)
 {
-	this->params.ItemIndex = ReadU16LE(FromBytes, 0);
-	this->params.DId = ReadU16LE(FromBytes, 2);
-	this->params.ErrorCode = ReadU32LE(FromBytes, 4);
-	this->params.Info = ReadU32LE(FromBytes, 8);
 }
 
 TSYS_ItemError::TSYS_ItemError(__u16 itemIndex, DataItemIds originalDid, TError errorCode, __u32 info)
@@ -383,19 +343,104 @@ TSYS_ItemError &TSYS_ItemError::Go()
 	return *this;
 }
 
-TBytes TSYS_ItemError::calcPayload(bool /*bAsReply*/)
-{
-	TBytes out;
-	out.reserve(12);
-	WriteU16LE(out, this->params.ItemIndex);
-	WriteU16LE(out, this->params.DId);
-	WriteU32LE(out, this->params.ErrorCode);
-	WriteU32LE(out, this->params.Info);
-	return out;
-}
-
 std::string TSYS_ItemError::AsString(bool /*bAsReply*/)
 {
 	const __u32 idx = static_cast<__u32>(-this->params.ErrorCode);
 	return "SYS_ItemError(ItemIndex=" + std::to_string(this->params.ItemIndex) + ", DId=0x" + to_hex<__u16>(this->params.DId) + ", ErrorCode=" + to_hex<__u32>(this->params.ErrorCode) + " (idx=" + std::to_string(idx) + " " + SafeErrMsgFromCode(this->params.ErrorCode) + "), Info=" + to_hex<__u32>(this->params.Info) + ")";
-}
\ No newline at end of file
+}
+
+// ---------------- TSYS_Admission ----------------
+
+TSYS_Admission::TSYS_Admission(DataItemIds id, TByteSpan FromBytes)
+	: TDataItem<SYS_AdmissionParams>(id, FromBytes)
+{
+}
+
+TSYS_Admission &TSYS_Admission::Go()
+{
+	this->params.MaxQueued = Admission.MaxQueued();
+	this->params.MaxQueuedBytes = Admission.MaxQueuedBytes();
+	this->params.Queued = Admission.Queued();
+	this->params.QueuedBytes = Admission.QueuedBytes();
+	this->params.ShedDepth = Admission.ShedForDepth();
+	this->params.ShedBytes = Admission.ShedForBytes();
+	this->resultCode = ERR_SUCCESS;
+	return *this;
+}
+
+std::string TSYS_Admission::AsString(bool bAsReply)
+{
+	if (!bAsReply)
+		return "SYS_Admission()";
+	return "SYS_Admission() → Queued " + std::to_string(this->params.Queued) + "/" + std::to_string(this->params.MaxQueued) +
+		   " (" + std::to_string(this->params.QueuedBytes) + "/" + std::to_string(this->params.MaxQueuedBytes) + " bytes), shed " +
+		   std::to_string(this->params.ShedDepth) + " for depth, " + std::to_string(this->params.ShedBytes) + " for bytes";
+}
+
+// ---------------- TSYS_Coalescing ----------------
+
+TSYS_Coalescing::TSYS_Coalescing(DataItemIds id, TByteSpan FromBytes)
+	: TDataItem<SYS_CoalescingParams>(id, FromBytes)
+{
+}
+
+TSYS_Coalescing &TSYS_Coalescing::Go()
+{
+	this->params.WindowUs = Coalescer.WindowUs();
+	this->params.Reads = Coalescer.Reads();
+	this->params.Shared = Coalescer.Shared();
+	this->resultCode = ERR_SUCCESS;
+	return *this;
+}
+
+std::string TSYS_Coalescing::AsString(bool bAsReply)
+{
+	if (!bAsReply)
+		return "SYS_Coalescing()";
+	return "SYS_Coalescing() → " + std::to_string(this->params.Shared) + " of " + std::to_string(this->params.Reads) +
+		   " reads shared, window " + std::to_string(this->params.WindowUs) + " µs";
+}
+
+// ---------------- TSYS_Shadow ----------------
+
+TSYS_Shadow::TSYS_Shadow(DataItemIds id, TByteSpan FromBytes)
+	: TDataItem<SYS_ShadowParams>(id, FromBytes)
+{
+}
+
+TSYS_Shadow &TSYS_Shadow::Go()
+{
+	this->params.Enabled = Shadow.Enabled();
+	this->params.ReadsSaved = Shadow.ReadsSaved();
+	this->params.WritesSaved = Shadow.WritesSaved();
+	this->resultCode = ERR_SUCCESS;
+	return *this;
+}
+
+std::string TSYS_Shadow::AsString(bool bAsReply)
+{
+	if (!bAsReply)
+		return "SYS_Shadow()";
+	if (!this->params.Enabled)
+		return "SYS_Shadow() → off";
+	return "SYS_Shadow() → saved " + std::to_string(this->params.ReadsSaved) + " reads, " + std::to_string(this->params.WritesSaved) +
+		   " writes";
+}
+
+// ---------------- TSYS_MaxAge ----------------
+
+TSYS_MaxAge::TSYS_MaxAge(DataItemIds id, TByteSpan FromBytes)
+	: TDataItem<SYS_MaxAgeParams>(id, FromBytes)
+{
+}
+
+TSYS_MaxAge &TSYS_MaxAge::Go()
+{
+	this->resultCode = ERR_SUCCESS;
+	return *this;
+}
+
+std::string TSYS_MaxAge::AsString(bool bAsReply)
+{
+	return "SYS_MaxAge(" + std::to_string(this->params.MaxAgeMs) + " ms)";
+}
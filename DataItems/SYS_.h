@@ -13,7 +13,7 @@ class TSYS_UploadFileName : public TDataItemBase
 {
 public:
 	explicit TSYS_UploadFileName(TBytes buf) : TSYS_UploadFileName(DataItemIds::SYS_UploadFileName, buf){};
-	explicit TSYS_UploadFileName(DataItemIds id, TBytes buf);
+	explicit TSYS_UploadFileName(DataItemIds id, TByteSpan buf);
 	//TSYS_UploadFileName() : TDataItem(SYS_UploadFileName){}
 
 	// returns the sanitized file name
@@ -30,7 +30,7 @@ class TSYS_UploadFileData : public TDataItemBase
 {
 public:
 	explicit TSYS_UploadFileData(TBytes buf) : TSYS_UploadFileData(DataItemIds::SYS_UploadFileName, buf){};
-	explicit TSYS_UploadFileData(DataItemIds id, TBytes buf);
+	explicit TSYS_UploadFileData(DataItemIds id, TByteSpan buf);
 
 	// returns the sanitized file name
 	virtual TBytes calcPayload(bool bAsReply = false);
@@ -54,26 +54,111 @@ struct SYS_ItemErrorParams
 	__u32 ErrorCode = ERR_SUCCESS;
 	__u32 Info = 0;
 };
+
+struct SYS_AdmissionParams // reply only; see admission.h
+{
+	__u32 MaxQueued = 0;
+	__u32 MaxQueuedBytes = 0;
+	__u32 Queued = 0;      // Messages queued or running right now
+	__u32 QueuedBytes = 0;
+	__u64 ShedDepth = 0;   // Messages answered ERR_BUSY since startup because MaxQueued were already in
+	__u64 ShedBytes = 0;   // ...because they would have passed MaxQueuedBytes
+};
+
+struct SYS_CoalescingParams // reply only; see coalesce.h
+{
+	__u32 WindowUs = 0; // AIOENET_COALESCE_US
+	__u64 Reads = 0;    // Coalesce() DataItems run since startup
+	__u64 Shared = 0;   // ...that were answered from an identical one's hardware read; Shared / Reads is the hit rate
+};
+
+struct SYS_ShadowParams // reply only; see shadow.h
+{
+	__u8 Enabled = 0;      // AIOENET_REGISTER_SHADOW isn't off
+	__u64 ReadsSaved = 0;  // read-modify-writes that didn't need an in() since startup
+	__u64 WritesSaved = 0; // out()s skipped because the register already held the value
+};
+
+struct SYS_MaxAgeParams // request and reply; see snapshot.h
+{
+	__u16 MaxAgeMs = 0;
+};
 #pragma pack(pop)
 
+template <> struct TParamLayout<SYS_ErrorParams>
+	: TParamCodec<SYS_ErrorParams, PARAM_FIELD(SYS_ErrorParams, Stage), PARAM_FIELD(SYS_ErrorParams, ErrorCode), PARAM_FIELD(SYS_ErrorParams, Info)> {};
+template <> struct TParamLayout<SYS_ItemErrorParams>
+	: TParamCodec<SYS_ItemErrorParams, PARAM_FIELD(SYS_ItemErrorParams, ItemIndex), PARAM_FIELD(SYS_ItemErrorParams, DId),
+	              PARAM_FIELD(SYS_ItemErrorParams, ErrorCode), PARAM_FIELD(SYS_ItemErrorParams, Info)> {};
+template <> struct TParamLayout<SYS_AdmissionParams>
+	: TParamCodec<SYS_AdmissionParams, PARAM_FIELD(SYS_AdmissionParams, MaxQueued), PARAM_FIELD(SYS_AdmissionParams, MaxQueuedBytes),
+	              PARAM_FIELD(SYS_AdmissionParams, Queued), PARAM_FIELD(SYS_AdmissionParams, QueuedBytes),
+	              PARAM_FIELD(SYS_AdmissionParams, ShedDepth), PARAM_FIELD(SYS_AdmissionParams, ShedBytes)> {};
+template <> struct TParamLayout<SYS_CoalescingParams>
+	: TParamCodec<SYS_CoalescingParams, PARAM_FIELD(SYS_CoalescingParams, WindowUs), PARAM_FIELD(SYS_CoalescingParams, Reads),
+	              PARAM_FIELD(SYS_CoalescingParams, Shared)> {};
+template <> struct TParamLayout<SYS_ShadowParams>
+	: TParamCodec<SYS_ShadowParams, PARAM_FIELD(SYS_ShadowParams, Enabled), PARAM_FIELD(SYS_ShadowParams, ReadsSaved),
+	              PARAM_FIELD(SYS_ShadowParams, WritesSaved)> {};
+template <> struct TParamLayout<SYS_MaxAgeParams>
+	: TParamCodec<SYS_MaxAgeParams, PARAM_FIELD(SYS_MaxAgeParams, MaxAgeMs)> {};
+
 class TSYS_Error : public TDataItem<SYS_ErrorParams>
 {
 public:
-	TSYS_Error(DataItemIds id, const TBytes &FromBytes);
+	TSYS_Error(DataItemIds id, TByteSpan FromBytes);
 	TSYS_Error(__u32 stage, TError errorCode, __u32 info);
 
 	virtual TSYS_Error &Go() override;
-	virtual TBytes calcPayload(bool bAsReply = false) override;
 	virtual std::string AsString(bool bAsReply = false) override;
 };
 
 class TSYS_ItemError : public TDataItem<SYS_ItemErrorParams>
 {
 public:
-	TSYS_ItemError(DataItemIds id, const TBytes &FromBytes);
+	TSYS_ItemError(DataItemIds id, TByteSpan FromBytes);
 	TSYS_ItemError(__u16 itemIndex, DataItemIds originalDid, TError errorCode, __u32 info);
 
 	virtual TSYS_ItemError &Go() override;
-	virtual TBytes calcPayload(bool bAsReply = false) override;
+	virtual std::string AsString(bool bAsReply = false) override;
+};
+
+// Go() snapshots the admission counters; the request carries nothing
+class TSYS_Admission : public TDataItem<SYS_AdmissionParams>
+{
+public:
+	TSYS_Admission(DataItemIds id, TByteSpan FromBytes);
+
+	virtual TSYS_Admission &Go() override;
+	virtual std::string AsString(bool bAsReply = false) override;
+};
+
+// Go() snapshots the read-coalescing counters; the request carries nothing
+class TSYS_Coalescing : public TDataItem<SYS_CoalescingParams>
+{
+public:
+	TSYS_Coalescing(DataItemIds id, TByteSpan FromBytes);
+
+	virtual TSYS_Coalescing &Go() override;
+	virtual std::string AsString(bool bAsReply = false) override;
+};
+
+// Go() snapshots the register shadow's counters; the request carries nothing
+class TSYS_Shadow : public TDataItem<SYS_ShadowParams>
+{
+public:
+	TSYS_Shadow(DataItemIds id, TByteSpan FromBytes);
+
+	virtual TSYS_Shadow &Go() override;
+	virtual std::string AsString(bool bAsReply = false) override;
+};
+
+// says how stale the rest of its 'Q' may be; the Control run-loop acts on that (see snapshot.h), Go() only echoes
+class TSYS_MaxAge : public TDataItem<SYS_MaxAgeParams>
+{
+public:
+	TSYS_MaxAge(DataItemIds id, TByteSpan FromBytes);
+
+	virtual TSYS_MaxAge &Go() override;
 	virtual std::string AsString(bool bAsReply = false) override;
 };
@@ -3,10 +3,14 @@
 #include <map>
 #include <iterator>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <type_traits>
 
 #include "../logging.h"
 #include "../utilities.h"
+#include "../checksum.h"
+#include "../shadow.h"
 #include "TDataItem.h"
 #include "ADC_.h"
 #include "BRD_.h"
@@ -23,34 +27,27 @@ static inline std::shared_ptr<T> SafeMakeShared(Args&&... args) {
 }
 
 
-#define DIdNYI(d) { DataItemIds::d, { 0, 0, 0, construct<TDataItemNYI>, #d " (NYI)", {} } }
+#define DIdNYI(d) { DataItemIds::d, 0, 0, 0, construct<TDataItemNYI>, #d " (NYI)", nullptr, LaneByGroup, CostByDefault, false }
 
-#define DATA_ITEM_IMPL_2(x, aclass, a, b, c, y, z)                                                 \
-	{                                                                                              \
-		DataItemIds::x,                                                                                         \
-		{                                                                                          \
-			a, b, c, [](DataItemIds q, TBytes bytes) { return construct<aclass>(DataItemIds::x, bytes); }, y, z \
-		}                                                                                          \
-	}
-#define DATA_ITEM_IMPL_1(x, aclass, a, b, c, y)                                                 \
-	{                                                                                           \
-		DataItemIds::x,                                                                                      \
-		{                                                                                       \
-			a, b, c, [](DataItemIds q, TBytes bytes) { return construct<aclass>(DataItemIds::x, bytes); }, y \
-		}                                                                                       \
-	}
+// the "TLA_" documentation DIds touch no hardware at all; everything else gets its group's lanes (see DIdGroupLanes())
+#define DATA_ITEM_LANES(aclass) (std::is_same_v<aclass, TDataItemDoc> ? LaneNone : LaneByGroup)
+#define DATA_ITEM_IMPL_2(x, aclass, a, b, c, y, z) { DataItemIds::x, a, b, c, construct<aclass>, y, z, DATA_ITEM_LANES(aclass), CostByDefault, false }
+#define DATA_ITEM_IMPL_1(x, aclass, a, b, c, y) { DataItemIds::x, a, b, c, construct<aclass>, y, nullptr, DATA_ITEM_LANES(aclass), CostByDefault, false }
 #define DATA_ITEM_GET_MACRO(_1, _2, _3, _4, _5, _6, _7, NAME, ...) NAME
 #define DATA_ITEM(...) DATA_ITEM_GET_MACRO(__VA_ARGS__, DATA_ITEM_IMPL_2, DATA_ITEM_IMPL_1)(__VA_ARGS__)
+// fixed-length DIds whose payload is exactly aclass's ParamStruct; lengths come from its TParamLayout (see paramcodec.h)
+#define DATA_ITEM_PARAMS(x, aclass, y) DATA_ITEM(x, aclass, DIdParamsLen(aclass), DIdParamsLen(aclass), DIdParamsLen(aclass), y)
+#define DIdParamsLen(aclass) TParamLayout<typename aclass::TParams>::WireSize
 
 #pragma region TDataItemRaw
 
 // stores raw bytes as parameters instead of struct-style
 class TDataItemRaw : public TDataItem<GenericParams> {
 public:
-	TDataItemRaw(DataItemIds id, const TBytes &bytes)
+	TDataItemRaw(DataItemIds id, TByteSpan bytes)
 		: TDataItem<GenericParams>(id, bytes)
 	{
-		this->Data = bytes;
+		this->Data.assign(this->rawBytes.begin(), this->rawBytes.end());
 	}
 
 	// No hardware action
@@ -62,7 +59,7 @@ public:
 		return "TDataItemRaw, DId=" + to_hex<__u16>((__u16)this->DId)
 				+ " " + getDIdDesc()
 				+ ", size=" + std::to_string(this->rawBytes.size())
-				+ ": " + to_hex(this->rawBytes);
+				+ ": " + to_hex(TBytes(this->rawBytes.begin(), this->rawBytes.end()));
 	}
 };
 
@@ -70,49 +67,89 @@ public:
 #pragma GCC push_options
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 
-std::shared_ptr<TDataItemBase> construct_ADC_StreamStart(DataItemIds id, TBytes FromBytes)
+std::shared_ptr<TDataItemBase> construct_ADC_StreamStart(DataItemIds id, TByteSpan FromBytes)
+{
+    return construct<TADC_StreamStart>(id, FromBytes);
+}
+
+std::shared_ptr<TDataItemBase> construct_ADC_StreamStop(DataItemIds id, TByteSpan FromBytes)
+{
+    return construct<TADC_StreamStop>(id, FromBytes);
+}
+
+// the lanes (see TLanes) a DId uses unless its DIdList entry is wrapped in Lanes()
+static constexpr TLanes DIdGroupLanes(DataItemIds DId)
+{
+	const __u16 d = static_cast<__u16>(DId);
+	if (d < 0x0100) return LaneConfig; // BRD_: model, serial number, submux settings
+	if (d < 0x0200) return LaneAll;    // REG_: any register at all
+	if (d < 0x0300) return LaneDac;    // DAC_
+	if (d < 0x0400) return LaneDio;    // DIO_
+	if (d < 0x0500) return LaneDio;    // PWM_: the PWM pin is a DIO bit
+	if ((d >= 0x1000) && (d < 0x2000)) return LaneAdc;    // ADC_, ADC_Stream
+	if ((d >= 0x7000) && (d < 0x8000)) return LaneNone;   // TCP_
+	if ((d >= 0x9000) && (d < 0xA000)) return LaneConfig; // CFG_
+	if ((d >= 0xEF00) && (d < 0xF000)) return LaneConfig; // SYS_
+	if (DId == DataItemIds::DOC_Get) return LaneNone;
+	return LaneAll; // anything not sorted out yet
+}
+
+// a DIdList entry that doesn't use its group's lanes
+static constexpr TDIdDictEntry Lanes(TLanes lanes, TDIdDictEntry entry)
+{
+	entry.lanes = lanes;
+	return entry;
+}
+
+// a DIdList entry that costs more than CostDefault (see TCost)
+static constexpr TDIdDictEntry Cost(TCost cost, TDIdDictEntry entry)
 {
-    return std::make_shared<TADC_StreamStart>(id, FromBytes);
+	entry.cost = cost;
+	return entry;
 }
 
-std::shared_ptr<TDataItemBase> construct_ADC_StreamStop(DataItemIds id, TBytes FromBytes)
+// a DIdList entry that only reads the hardware, so identical requests close together may share one read (see coalesce.h)
+static constexpr TDIdDictEntry Coalesce(TDIdDictEntry entry)
 {
-    return std::make_shared<TADC_StreamStop>(id, FromBytes);
+	entry.bCoalesce = true;
+	return entry;
 }
 
-const std::map<DataItemIds, TDIdDictEntry> DIdDict =
+// every DId, in any order; DIdDict (below) sorts and indexes this at compile time
+static constexpr TDIdDictEntry DIdList[] =
 	{
-		//{INVALID, { 9, 9, 9,( [](DataItemIds x, TBytes bytes) { return construct<TDataItem>(x, bytes); }), "DAC_Calibrate1(u8 iDAC, single Offset, single Scale)", nullptr}},
+		//{INVALID, { 9, 9, 9,( [](DataItemIds x, TByteSpan bytes) { return construct<TDataItem>(x, bytes); }), "DAC_Calibrate1(u8 iDAC, single Offset, single Scale)", nullptr}},
 		DATA_ITEM(INVALID, TDataItemRaw, 0, 0, 0, "Invalid DId -1", nullptr),
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
 	#pragma region BRD_
 #endif
 		DATA_ITEM(BRD_, TDataItemDoc, 0, 0, 0, "Documentation: list of BRD_ DataItems", nullptr),
-		DATA_ITEM(BRD_Reset, TDataItemRaw, 0, 0, 0, "BRD_Reset()", nullptr),
-		DATA_ITEM(BRD_DeviceID, TBRD_DeviceID, 0, 0, 0, "BRD_DeviceID() → u32", nullptr),
-		DATA_ITEM(BRD_Features, TBRD_Features, 0, 4, 4, "BRD_Features() → u8"),
-		DATA_ITEM(BRD_FpgaID, TBRD_FpgaId, 0, 4, 4, "BRD_FpgaID() → u32"),
-		DATA_ITEM(BRD_Model, TBRD_Model, 12, 40, 40, "BRD_Model(ASCII)", nullptr),
+		Lanes(LaneAll, DATA_ITEM(BRD_Reset, TDataItemRaw, 0, 0, 0, "BRD_Reset()", nullptr)),
+		Coalesce(Lanes(LaneNone, DATA_ITEM(BRD_DeviceID, TBRD_DeviceID, 0, 0, 0, "BRD_DeviceID() → u32", nullptr))), // read-only registers
+		Coalesce(DATA_ITEM(BRD_Features, TBRD_Features, 0, 4, 4, "BRD_Features() → u8")),
+		Coalesce(Lanes(LaneNone, DATA_ITEM(BRD_FpgaID, TBRD_FpgaId, 0, 4, 4, "BRD_FpgaID() → u32"))),
+		Cost(CostFileIo, Lanes(LaneAll, DATA_ITEM(BRD_Model, TBRD_Model, 12, 40, 40, "BRD_Model(ASCII)", nullptr))), // changes the DAC and ADC channel counts
 		DATA_ITEM(BRD_GetModel, TBRD_GetModel, 0, 0, 0, "BRD_GetModel() → ASCII", nullptr),
-		DATA_ITEM(BRD_SerialNumber, TBRD_SerialNumber, 12, 12, 14, "BRD_SetSerialNumber(ASCII SN)", nullptr),
+		Cost(CostFileIo, DATA_ITEM(BRD_SerialNumber, TBRD_SerialNumber, 12, 12, 14, "BRD_SetSerialNumber(ASCII SN)", nullptr)),
 		DATA_ITEM(BRD_GetSerialNumber, TBRD_GetSerialNumber, 0, 0, 0, "BRD_GetSerialNumber() → ASCII", nullptr),
 		DATA_ITEM(BRD_GetNumberOfAdcChannels, TBRD_GetNumberOfAdcChannels, 0, 0, 0, "BRD_GetNumberOfAdcChannels() → u8"),
-		DATA_ITEM(BRD_NumberOfSubmuxes, TBRD_NumberOfSubmuxes, 1, 1, 1, "BRD_NumberOfSubmuxes(u8 count)", nullptr),
-		DATA_ITEM(BRD_SubmuxScale, TBRD_SubmuxScale, 6, 6, 6, "BRD_SubmuxScale(u8 submuxIndex, u8 gainGroupIndex, f32 Scale)", nullptr),
-		DATA_ITEM(BRD_SubmuxOffset, TBRD_SubmuxOffset, 6, 6, 6, "BRD_SubmuxOffset(u8 submuxIndex, u8 gainGroupIndex, f32 Offset)", nullptr),
+		// the ADC's Volts conversions read the submux settings
+		Lanes(LaneAdc | LaneConfig, DATA_ITEM_PARAMS(BRD_NumberOfSubmuxes, TBRD_NumberOfSubmuxes, "BRD_NumberOfSubmuxes(u8 count)")),
+		Lanes(LaneAdc | LaneConfig, DATA_ITEM_PARAMS(BRD_SubmuxScale, TBRD_SubmuxScale, "BRD_SubmuxScale(u8 submuxIndex, u8 gainGroupIndex, f32 Scale)")),
+		Lanes(LaneAdc | LaneConfig, DATA_ITEM_PARAMS(BRD_SubmuxOffset, TBRD_SubmuxOffset, "BRD_SubmuxOffset(u8 submuxIndex, u8 gainGroupIndex, f32 Offset)")),
 		DATA_ITEM(BRD_GetNumberOfSubmuxes, TBRD_GetNumberOfSubmuxes, 0, 0, 0, "BRD_GetNumberOfSubmuxes() → [u8]", nullptr),
 		DATA_ITEM(BRD_GetSubmuxScale, TBRD_GetSubmuxScale, 2, 2, 2, "BRD_GetSubmuxScale(u8 submuxIndex, u8 gainGroupIndex) → [float]", nullptr),
 		DATA_ITEM(BRD_GetSubmuxOffset, TBRD_GetSubmuxOffset, 2, 2, 2, "BRD_GetSubmuxOffset(u8 submuxIndex, u8 gainGroupIndex) → [float]", nullptr),
 
-		DATA_ITEM(BRD_REBOOT, TDataItemRaw, 8, 8, 8, "BRD_REBOOT(double)",
+		Lanes(LaneAll, DATA_ITEM(BRD_REBOOT, TDataItemRaw, 8, 8, 8, "BRD_REBOOT(double)",
 				  [](const TBytes &buf)
 				  {
 					  const __u8 *p = buf.data();
 					  double token = *(double *)p;
 					  if (token == M_PI)
 						  done = true;
-				  }),
+				  })),
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
 	#pragma region REG_
@@ -121,9 +158,10 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 		// the "in()" and "out()" functions deal with this
 		DATA_ITEM(REG_, TDataItemDoc, 0, 0, 0, "Documentation: list of REG_ DataItems", nullptr),
 		DATA_ITEM(REG_Read1, TREG_Read1, 1, 1, 1, "REG_Read1(u8 offset) → [u8|u32]", nullptr),
-		DIdNYI(REG_ReadBuf),
+		DATA_ITEM(REG_ReadAll, TREG_ReadAll, 0, 0, 0, "REG_ReadAll() → [u8 ofs, u8|u32 value] for each readable register", nullptr),
+		Cost(CostAdcScan, DATA_ITEM(REG_ReadBuf, TREG_ReadBuf, 3, 3, 3, "REG_ReadBuf(u8 ofs, u16 count) → [u8 ofs, u16 count, count × (u8|u32)]", nullptr)),
 		DATA_ITEM(REG_Write1, TREG_Write1, 2, 5, 5, "REG_Write1(u8 ofs, [u8|u32] data)", nullptr),
-		DIdNYI(REG_WriteBuf),
+		Cost(CostAdcScan, DATA_ITEM(REG_WriteBuf, TREG_WriteBuf, 2, 5, 65535, "REG_WriteBuf(u8 ofs, n × (u8|u32) data) → [u8 ofs, u16 n]", nullptr)),
 
 		DATA_ITEM(REG_ClearBits, TDataItemRaw, 2, 5, 5, "REG_ClearBits(u8 ofs, u8|u32 bitsToClear)",
 				  [](const TBytes &buf)
@@ -132,7 +170,7 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 						__u8 ofs = *pargs++;
 						__u32 bitsToClear = regextract(pargs, ofs);
 
-						__u32 regValue = in(ofs);
+						__u32 regValue = Shadow.Read(ofs);
 						regValue &= ~ bitsToClear;
 						out(ofs, regValue);
 					}),
@@ -144,7 +182,7 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 						__u8 ofs = *pargs++;
 						__u32 bitsToToggle = regextract(pargs, ofs);
 
-						__u32 regValue = in(ofs);
+						__u32 regValue = Shadow.Read(ofs);
 						regValue ^= bitsToToggle;
 						out(ofs,regValue);
 					}),
@@ -155,15 +193,15 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 						__u8 ofs = *pargs++;
 						__u32 bitsToSet = regextract(pargs, ofs);
 
-						__u32 regValue = in(ofs);
+						__u32 regValue = Shadow.Read(ofs);
 						regValue |= bitsToSet;
 						out(ofs,regValue);
 					}),
 		DATA_ITEM(REG_ReadBit, TREG_ReadBit, 2, 2, 2, "TREG_ReadBit(u8 offset, u8 bitIndex) → [u8]", nullptr),
-		DATA_ITEM(REG_WriteBit, TREG_WriteBit, 3, 3, 3, "TREG_WriteBit(u8 offset, u8 bitIndex, u8 one_or_zero)", nullptr),
-		DATA_ITEM(REG_ClearBit, TREG_ClearBit, 2, 2, 2, "TREG_ClearBit(u8 offset, u8 bitIndex)", nullptr),
-		DATA_ITEM(REG_SetBit, TREG_SetBit, 2, 2, 2, "TREG_SetBit(u8 offset, u8 bitIndex)", nullptr),
-		DATA_ITEM(REG_ToggleBit, TREG_ToggleBit, 2, 2, 2, "TREG_ToggleBit(u8 offset, u8 bitIndex)", nullptr),
+		DATA_ITEM_PARAMS(REG_WriteBit, TREG_WriteBit, "TREG_WriteBit(u8 offset, u8 bitIndex, u8 one_or_zero)"),
+		DATA_ITEM_PARAMS(REG_ClearBit, TREG_ClearBit, "TREG_ClearBit(u8 offset, u8 bitIndex)"),
+		DATA_ITEM_PARAMS(REG_SetBit, TREG_SetBit, "TREG_SetBit(u8 offset, u8 bitIndex)"),
+		DATA_ITEM_PARAMS(REG_ToggleBit, TREG_ToggleBit, "TREG_ToggleBit(u8 offset, u8 bitIndex)"),
 
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
@@ -175,10 +213,10 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 		DATA_ITEM(DAC_, TDataItemDoc, 0, 0, 0, "Documentation: list of DAC_ DataItems", nullptr),
 		DATA_ITEM(DAC_Output1, TDAC_Output, 3, 5, 5, "DAC_Output1(u8 iDAC, u16 counts)", nullptr),
 		DATA_ITEM(DAC_Output1V, TDAC_OutputV, 3, 5, 5, "DAC_Output1(u8 iDAC, single Volts)", nullptr),
-		DATA_ITEM(DAC_Range1, TDAC_Range1, 5, 5, 5, "DAC_Range1(u8 iDAC, u32 RangeCode)", nullptr),
+		Cost(CostFileIo, DATA_ITEM_PARAMS(DAC_Range1, TDAC_Range1, "DAC_Range1(u8 iDAC, u32 RangeCode)")),
 		DIdNYI(DAC_Configure1),
 		DIdNYI(DAC_ConfigAndOutput1),
-		DATA_ITEM(DAC_Calibrate1, TDataItemRaw, 9, 9, 9, "DAC_Calibrate1(u8 iDAC, single Offset, single Scale)",
+		Cost(CostFileIo, DATA_ITEM(DAC_Calibrate1, TDataItemRaw, 9, 9, 9, "DAC_Calibrate1(u8 iDAC, single Offset, single Scale)",
 					[](const TBytes &buf)
 					{
 						const __u8 *p = buf.data();
@@ -200,9 +238,9 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 						Debug("inside lambda: DAC " + std::to_string(dacnum) +
 								", scale = " + std::to_string(scale) +
 								", offset = " + std::to_string(offset));
-					}),
+					})),
 
-		DATA_ITEM(DAC_Offset1, TDataItemRaw, 5, 5, 5, "DAC_Offset1(u8 iDac, single Offset)",
+		Cost(CostFileIo, DATA_ITEM(DAC_Offset1, TDataItemRaw, 5, 5, 5, "DAC_Offset1(u8 iDac, single Offset)",
 					[](const TBytes &buf)
 					{
 						const __u8 *p = buf.data();
@@ -218,9 +256,9 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 
 						Debug("inside lambda: DAC " + std::to_string(dacnum) +
 							", offset = " + std::to_string(offset));
-					}),
+					})),
 
-		DATA_ITEM(DAC_OffsetAll, TDataItemRaw, 8, 8, 16, "DAC_OffsetAll(single offset0, offset1[, offset2, offset3])",
+		Cost(CostFileIo, DATA_ITEM(DAC_OffsetAll, TDataItemRaw, 8, 8, 16, "DAC_OffsetAll(single offset0, offset1[, offset2, offset3])",
 				  [](const TBytes &buf)
 				  {
 						size_t n = buf.size() / sizeof(float);
@@ -234,8 +272,8 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 							WriteConfigString("DAC_OffsetCh" + std::to_string(dacnum), to_hex<__u32>(bit_cast<__u32>(v)));
 
 							Debug("inside lambda: DAC " + std::to_string(dacnum) + ", offset = " + std::to_string(Config.dacOffsetCoefficients[dacnum]));
-						} }),
-		DATA_ITEM(DAC_Scale1, TDataItemRaw, 5, 5, 5, "DAC_Scale1(u8 iDac, single Scale)",
+						} })),
+		Cost(CostFileIo, DATA_ITEM(DAC_Scale1, TDataItemRaw, 5, 5, 5, "DAC_Scale1(u8 iDac, single Scale)",
 				  [](const TBytes &buf)
 				  {
 						const __u8 *p = buf.data();
@@ -251,10 +289,10 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 
 						Debug("inside lambda: DAC " + std::to_string(dacnum) +
 							", scale = " + std::to_string(scale));
-				  }),
+				  })),
 
 		// DAC_ScaleAll(single scale0, scale1[, scale2, scale3])  --> 8 or 16 bytes
-		DATA_ITEM(DAC_ScaleAll, TDataItemRaw, 8, 8, 16, "DAC_ScaleAll(single scale0, scale1[, scale2, scale3])",
+		Cost(CostFileIo, DATA_ITEM(DAC_ScaleAll, TDataItemRaw, 8, 8, 16, "DAC_ScaleAll(single scale0, scale1[, scale2, scale3])",
 				  [](const TBytes &buf)
 				  {
 						const __u8 *p = buf.data();
@@ -273,7 +311,7 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 							Debug("inside lambda: DAC " + std::to_string(dacnum) +
 									", scale = " + std::to_string(scale));
 						}
-				  }),
+				  })),
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
 	#pragma region DIO_
@@ -296,15 +334,15 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 		// @ this bit is available for use as PWM output or input
 		// * 3 bits are consumed when a submux is attached. They are forced to output and are under FPGA control; writes are ignored
 		// + these 8 bits are SPI-driven thus slower
-		DATA_ITEM(DIO_Configure, TDIO_Configure, 2, 2, 2, "TDIO_Configure(u16 value) - each bit: 1=input, 0=output", nullptr),
-		DATA_ITEM(DIO_Input, TDIO_Input, 0, 0, 0, "TDIO_Input() → returns u16 value", nullptr),
-		DATA_ITEM(DIO_Output, TDIO_Output, 2, 2, 2, "TDIO_Output(u16 value) - sets digital outputs", nullptr),
-		DATA_ITEM(DIO_ConfigureBit, TDIO_ConfigureBit, 2, 2, 2, "DIO_ConfigureBit(u8 bitNumber, u8 direction)", nullptr),
-		DATA_ITEM(DIO_InputBit, TDIO_InputBit, 1, 1, 1, "DIO_InputBit(u8 bitNumber) → [u8]", nullptr),
-		DATA_ITEM(DIO_OutputBit, TDIO_OutputBit, 2, 2, 2, "DIO_OutputBit(u8 bitNumber, u8 value)", nullptr),
-		DATA_ITEM(DIO_ClearBit, TDIO_ClearBit, 1, 1, 1, "DIO_ClearBit(u8 bitNumber)", nullptr),
-		DATA_ITEM(DIO_SetBit, TDIO_SetBit, 1, 1, 1, "DIO_SetBit(u8 bitNumber)", nullptr),
-		DATA_ITEM(DIO_ToggleBit, TDIO_ToggleBit, 1, 1, 1, "DIO_ToggleBit(u8 bitNumber)", nullptr),
+		DATA_ITEM_PARAMS(DIO_Configure, TDIO_Configure, "TDIO_Configure(u16 value) - each bit: 1=input, 0=output"),
+		Coalesce(DATA_ITEM(DIO_Input, TDIO_Input, 0, 0, 0, "TDIO_Input() → returns u16 value", nullptr)),
+		DATA_ITEM_PARAMS(DIO_Output, TDIO_Output, "TDIO_Output(u16 value) - sets digital outputs"),
+		DATA_ITEM_PARAMS(DIO_ConfigureBit, TDIO_ConfigureBit, "DIO_ConfigureBit(u8 bitNumber, u8 direction)"),
+		Coalesce(DATA_ITEM(DIO_InputBit, TDIO_InputBit, 1, 1, 1, "DIO_InputBit(u8 bitNumber) → [u8]", nullptr)),
+		DATA_ITEM_PARAMS(DIO_OutputBit, TDIO_OutputBit, "DIO_OutputBit(u8 bitNumber, u8 value)"),
+		DATA_ITEM_PARAMS(DIO_ClearBit, TDIO_ClearBit, "DIO_ClearBit(u8 bitNumber)"),
+		DATA_ITEM_PARAMS(DIO_SetBit, TDIO_SetBit, "DIO_SetBit(u8 bitNumber)"),
+		DATA_ITEM_PARAMS(DIO_ToggleBit, TDIO_ToggleBit, "DIO_ToggleBit(u8 bitNumber)"),
 
 		DIdNYI(DIO_PulseBit),
 		DIdNYI(DIO_ConfigureReadWriteReadSome),
@@ -321,28 +359,28 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 		DATA_ITEM(ADC_StartDivisor, TDataItemRaw, 4, 4, 4, "ADC_StartDivisor(u32)", nullptr),
 		DIdNYI(ADC_ConfigurationOfEverything),
 
-		DATA_ITEM(ADC_Differential1, TADC_Differential1, 2, 2, 2, "ADC_Differential1(u8 channelGroup, u8 singleEnded)", nullptr),
-		DATA_ITEM(ADC_DifferentialAll, TADC_DifferentialAll, 8, 8, 8, "ADC_DifferentialAll(8 bytes: one per channelGroup)", nullptr),
+		DATA_ITEM_PARAMS(ADC_Differential1, TADC_Differential1, "ADC_Differential1(u8 channelGroup, u8 singleEnded)"),
+		DATA_ITEM_PARAMS(ADC_DifferentialAll, TADC_DifferentialAll, "ADC_DifferentialAll(8 bytes: one per channelGroup)"),
 
-		DATA_ITEM(ADC_Range1, TADC_Range1, 2, 2, 2, "ADC_Range1(u8 channelGroup, u8 range)", nullptr),
-		DATA_ITEM(ADC_RangeAll, TADC_RangeAll, 8, 8, 8, "ADC_RangeAll(8 bytes: range for each channelGroup)", nullptr),
+		DATA_ITEM_PARAMS(ADC_Range1, TADC_Range1, "ADC_Range1(u8 channelGroup, u8 range)"),
+		DATA_ITEM_PARAMS(ADC_RangeAll, TADC_RangeAll, "ADC_RangeAll(8 bytes: range for each channelGroup)"),
 
-		DATA_ITEM(ADC_Scale1, TADC_Scale1, 5, 5, 5, "ADC_Scale1(u8 rangeIndex, float scale)", nullptr),
-		DATA_ITEM(ADC_ScaleAll, TADC_ScaleAll, 8 * sizeof(float), 8 * sizeof(float), 8 * sizeof(float), "ADC_ScaleAll(8 floats for scale calibration)", nullptr),
+		DATA_ITEM_PARAMS(ADC_Scale1, TADC_Scale1, "ADC_Scale1(u8 rangeIndex, float scale)"),
+		DATA_ITEM_PARAMS(ADC_ScaleAll, TADC_ScaleAll, "ADC_ScaleAll(8 floats for scale calibration)"),
 
-		DATA_ITEM(ADC_Offset1, TADC_Offset1, 5, 5, 5, "ADC_Offset1(u8 rangeIndex, float offset)", nullptr),
-		DATA_ITEM(ADC_OffsetAll, TADC_OffsetAll, 8 * sizeof(float), 8 * sizeof(float), 8 * sizeof(float), "ADC_OffsetAll(8 floats for offset calibration)", nullptr),
+		DATA_ITEM_PARAMS(ADC_Offset1, TADC_Offset1, "ADC_Offset1(u8 rangeIndex, float offset)"),
+		DATA_ITEM_PARAMS(ADC_OffsetAll, TADC_OffsetAll, "ADC_OffsetAll(8 floats for offset calibration)"),
 
-		DATA_ITEM(ADC_Calibration1, TADC_Calibration1, 9, 9, 9, "ADC_Calibration1(u8 rangeIndex, float scale, float offset)", nullptr),
+		DATA_ITEM_PARAMS(ADC_Calibration1, TADC_Calibration1, "ADC_Calibration1(u8 rangeIndex, float scale, float offset)"),
 		DATA_ITEM(ADC_CalibrationAll, TADC_CalibrationAll, 16 * sizeof(float), 16 * sizeof(float), 16 * sizeof(float), "ADC_CalibrationAll(8 scales followed by 8 offsets)", nullptr),
 
 		DIdNYI(ADC_Raw1),
 		DIdNYI(ADC_Counts1),
 		DIdNYI(ADC_Volts1),
-		DATA_ITEM(ADC_RawAll,    TADC_RawAll,    0, 0, 0, "ADC_RawAll() -> nChannels * u32", nullptr),
-		DATA_ITEM(ADC_CountsAll, TADC_CountsAll, 0, 0, 0, "ADC_CountsAll() -> nChannels * u16", nullptr),
-		DATA_ITEM(ADC_VoltsAll, TADC_VoltsAll, 0, 0, 0, "ADC_VoltsAll() → float[nChannels]", nullptr),
-		DATA_ITEM(ADC_StreamStart, TADC_StreamStart, 4, 4, 4, "ADC_StreamStart((u32)AdcConnectionId)", nullptr),
+		Coalesce(Cost(CostAdcScan, DATA_ITEM(ADC_RawAll,    TADC_RawAll,    0, 0, 0, "ADC_RawAll() -> nChannels * u32", nullptr))),
+		Coalesce(Cost(CostAdcScan, DATA_ITEM(ADC_CountsAll, TADC_CountsAll, 0, 0, 0, "ADC_CountsAll() -> nChannels * u16", nullptr))),
+		Coalesce(Cost(CostAdcScan, DATA_ITEM(ADC_VoltsAll, TADC_VoltsAll, 0, 0, 0, "ADC_VoltsAll() → float[nChannels]", nullptr))),
+		DATA_ITEM_PARAMS(ADC_StreamStart, TADC_StreamStart, "ADC_StreamStart((u32)AdcConnectionId)"),
 		DATA_ITEM(ADC_StreamStop, TADC_StreamStop, 0, 0, 0, "ADC_StreamStop()", nullptr),
 		// DIdNYI(ADC_Streaming_stuff_including_Hz_config),
 //---------------------------------------------------------------------------------------------------------------------------------
@@ -377,15 +415,19 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 	#pragma region CFG_
 #endif
 		DATA_ITEM(CFG_, TDataItemDoc, 0, 0, 0, "Documentation: list of CFG_ DataItems", nullptr),
-		DATA_ITEM(CFG_Hostname, TCFG_Hostname, 1, 20, 253, "CFG_Hostname({valid Hostname})", nullptr),
+		Lanes(LaneFile, DATA_ITEM(CFG_Hostname, TCFG_Hostname, 1, 20, 253, "CFG_Hostname({valid Hostname})", nullptr)), // /etc/hostname, /etc/hosts, hostnamectl
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
 	#pragma region SYS_
 #endif
-		DATA_ITEM(SYS_UploadFileName, TSYS_UploadFileName, 1, 255, 255, "SYS_UploadFileName({valid filepath})", nullptr),
-		DATA_ITEM(SYS_UploadFileData, TSYS_UploadFileData, 1, 65534, 65534, "SYS_UploadFileData({valid file data})", nullptr),
-		DATA_ITEM(SYS_Error, TSYS_Error, 0, 12, 12, "SYS_Error() → u32 Stage, u32 error code, u32 info", nullptr),
-		DATA_ITEM(SYS_ItemError, TSYS_ItemError, 0, 12, 12, "SYS_ItemError() → u16 itemIndex, u16 DId, u32 error code, u32 info", nullptr),
+		Lanes(LaneFile, DATA_ITEM(SYS_UploadFileName, TSYS_UploadFileName, 1, 255, 255, "SYS_UploadFileName({valid filepath})", nullptr)),
+		Lanes(LaneFile, DATA_ITEM(SYS_UploadFileData, TSYS_UploadFileData, 1, 65534, 65534, "SYS_UploadFileData({valid file data})", nullptr)),
+		Lanes(LaneNone, DATA_ITEM(SYS_Admission, TSYS_Admission, 0, 0, 0, "SYS_Admission() → u32 MaxQueued, u32 MaxQueuedBytes, u32 Queued, u32 QueuedBytes, u64 ShedDepth, u64 ShedBytes", nullptr)),
+		Lanes(LaneNone, DATA_ITEM(SYS_Coalescing, TSYS_Coalescing, 0, 0, 0, "SYS_Coalescing() → u32 WindowUs, u64 Reads, u64 Shared", nullptr)),
+		Lanes(LaneNone, DATA_ITEM(SYS_Shadow, TSYS_Shadow, 0, 0, 0, "SYS_Shadow() → u8 Enabled, u64 ReadsSaved, u64 WritesSaved", nullptr)),
+		Lanes(LaneNone, DATA_ITEM_PARAMS(SYS_MaxAge, TSYS_MaxAge, "SYS_MaxAge(u16 ms): the rest of this 'Q' may be answered from values read up to ms ago")),
+		Lanes(LaneNone, DATA_ITEM(SYS_Error, TSYS_Error, 0, 12, 12, "SYS_Error() → u32 Stage, u32 error code, u32 info", nullptr)),
+		Lanes(LaneNone, DATA_ITEM(SYS_ItemError, TSYS_ItemError, 0, 12, 12, "SYS_ItemError() → u16 itemIndex, u16 DId, u32 error code, u32 info", nullptr)),
 //---------------------------------------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER) || defined(__clang__)
 	#pragma region PWM_
@@ -406,6 +448,80 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 		DATA_ITEM(DOC_Get, TDataItemDocGet, 0, 0, 0, "Documentation: list of All top-level DataItem groups", nullptr),
 };
 #pragma GCC pop_options
+
+// DIdList in DId order, lanes filled in; this is what DIdDict iterates over
+static constexpr auto DIdEntries = []
+{
+	std::array<TDIdDictEntry, std::size(DIdList)> sorted{};
+	std::copy(std::begin(DIdList), std::end(DIdList), sorted.begin());
+	for (TDIdDictEntry &entry : sorted)
+	{
+		if (entry.lanes == LaneByGroup)
+			entry.lanes = DIdGroupLanes(entry.DId);
+		if (entry.cost == CostByDefault)
+			entry.cost = (entry.lanes & LaneFile) ? CostFileIo : CostDefault;
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const TDIdDictEntry &a, const TDIdDictEntry &b) { return a.DId < b.DId; });
+	return sorted;
+}();
+static_assert(std::adjacent_find(DIdEntries.begin(), DIdEntries.end(),
+								 [](const TDIdDictEntry &a, const TDIdDictEntry &b) { return a.DId == b.DId; }) == DIdEntries.end(),
+			  "a DId is listed twice in DIdList");
+
+#define DIdNone 0xFF // DIdSlots value for a DId that isn't in DIdEntries
+static_assert(std::size(DIdList) < DIdNone, "DIdSlots entries are __u8");
+
+// one per DId group (high byte): where the group's slots start in DIdSlots, and how many low bytes it covers
+typedef struct
+{
+	__u16 first;
+	__u16 count;
+} TDIdGroup;
+
+static constexpr auto DIdGroups = []
+{
+	std::array<TDIdGroup, 256> groups{};
+	for (const TDIdDictEntry &entry : DIdEntries)
+	{
+		const __u16 id = static_cast<__u16>(entry.DId);
+		groups[id >> 8].count = std::max<__u16>(groups[id >> 8].count, (id & 0xFF) + 1);
+	}
+	__u16 first = 0;
+	for (TDIdGroup &group : groups)
+	{
+		group.first = first;
+		first += group.count;
+	}
+	return groups;
+}();
+
+// DIdEntries index of every DId, group by group, indexed by low byte; sparse groups only cost a byte per gap
+static constexpr auto DIdSlots = []
+{
+	std::array<__u8, DIdGroups.back().first + DIdGroups.back().count> slots{};
+	std::fill(slots.begin(), slots.end(), DIdNone);
+	for (size_t i = 0; i < DIdEntries.size(); i++)
+	{
+		const __u16 id = static_cast<__u16>(DIdEntries[i].DId);
+		slots[DIdGroups[id >> 8].first + (id & 0xFF)] = static_cast<__u8>(i);
+	}
+	return slots;
+}();
+
+const TDIdDictEntry *TDIdDict::find(DataItemIds DId) const
+{
+	const __u16 id = static_cast<__u16>(DId);
+	const TDIdGroup &group = DIdGroups[id >> 8];
+	if ((id & 0xFF) >= group.count)
+		return end();
+	const __u8 slot = DIdSlots[group.first + (id & 0xFF)];
+	return (slot == DIdNone) ? end() : &DIdEntries[slot];
+}
+
+const TDIdDictEntry *TDIdDict::begin() const { return DIdEntries.data(); }
+const TDIdDictEntry *TDIdDict::end() const { return DIdEntries.data() + DIdEntries.size(); }
+
+const TDIdDict DIdDict;
 #pragma endregion
 
 
@@ -432,7 +548,7 @@ const std::map<DataItemIds, TDIdDictEntry> DIdDict =
 // NOTE:
 //   This should be implemented OOP-style: each TDataItem ID should be a descendant-class that provides the
 //   specific validate and parse appropriate to that DataItemID
-int TDataItemBase::validateDataItemPayload(DataItemIds id, const TBytes &bytes)
+int TDataItemBase::validateDataItemPayload(DataItemIds id, TByteSpan bytes)
 {
 	//Trace("ENTER, DId: " + to_hex<TDataId>(id) + ": ", bytes);
 	int result = ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH;
@@ -452,7 +568,7 @@ int TDataItemBase::validateDataItemPayload(DataItemIds id, const TBytes &bytes)
 
 std::string TDataItemBase::AsStringBase(bool bAsReply) const {
     auto it = DIdDict.find(this->DId);
-    std::string desc = (it != DIdDict.end()) ? it->second.desc : "Unknown DId";
+    std::string desc = (it != DIdDict.end()) ? std::string(it->desc) : "Unknown DId";
     return desc + " (DId=" + std::to_string(static_cast<__u16>(this->DId)) + ")";
 }
 
@@ -461,7 +577,7 @@ int TDataItemBase::getDIdIndex(DataItemIds id)
 	auto item = DIdDict.find(id);
 	if (item != DIdDict.end())
 	{
-		return static_cast<int>(std::distance(DIdDict.begin(), item));
+		return static_cast<int>(item - DIdDict.begin());
 	}
 	throw std::logic_error("DId not found in list");
 }
@@ -469,22 +585,22 @@ int TDataItemBase::getDIdIndex(DataItemIds id)
 // returns human-readable description of this TDataItem
 std::string TDataItemBase::getDIdDesc(DataItemIds id)
 {
-	return DIdDict.find(id)->second.desc;
+	return std::string(DIdDict.find(id)->desc);
 }
 
 TDataItemLength TDataItemBase::getMinLength(DataItemIds id)
 {
-	return DIdDict.find(id)->second.minLen;
+	return DIdDict.find(id)->minLen;
 }
 
 TDataItemLength TDataItemBase::getTargetLength(DataItemIds id)
 {
-	return DIdDict.find(id)->second.maxLen;
+	return DIdDict.find(id)->maxLen;
 }
 
 TDataItemLength TDataItemBase::getMaxLength(DataItemIds id)
 {
-	return DIdDict.find(id)->second.maxLen;
+	return DIdDict.find(id)->maxLen;
 }
 
 int TDataItemBase::isValidDataItemID(DataItemIds id)
@@ -494,7 +610,7 @@ int TDataItemBase::isValidDataItemID(DataItemIds id)
 	return (item != DIdDict.end());
 }
 
-int TDataItemBase::validateDataItem(const TBytes &bytes)
+int TDataItemBase::validateDataItem(TByteSpan bytes)
 {
 	int result = 0;
 	if (bytes.size() < sizeof(TDataItemHeader))
@@ -502,9 +618,9 @@ int TDataItemBase::validateDataItem(const TBytes &bytes)
 		Error(err_msg[-ERR_MSG_DATAITEM_TOO_SHORT]);
 		return ERR_MSG_DATAITEM_TOO_SHORT;
 	}
-	TDataItemHeader *head = (TDataItemHeader *)bytes.data();
+	const TDataItemHeader *head = reinterpret_cast<const TDataItemHeader *>(bytes.data());
 
-	TDataItemLength DataItemSize = head->dataLength; // WARN: only works if TDataItemHeader length field is one byte
+	TDataItemLength DataItemSize = head->dataLength;
 	DataItemIds Id = head->DId;
 	if (!isValidDataItemID(Id))
 	{
@@ -519,21 +635,22 @@ int TDataItemBase::validateDataItem(const TBytes &bytes)
 	}
 	else
 	{
-		TBytes Data = bytes;
-		Data.erase(Data.cbegin(), Data.cbegin() + sizeof(TDataItemHeader));
-		result = validateDataItemPayload(Id, Data);
+		if (bytes.size() < sizeof(TDataItemHeader) + DataItemSize)
+			return ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH;
+		result = validateDataItemPayload(Id, bytes.subspan(sizeof(TDataItemHeader), DataItemSize));
 	}
 
 	Trace("validateDataItem status: " + std::to_string(result) + ", " + err_msg[-result]);
 	return result;
 }
 
-// factory method receives an entire DataItem in TBytes form.
+// factory method receives an entire DataItem as a view into the received Message;
+// the constructed TDataItem is handed a sub-span of just its data bytes
 // eg 10 02 05 00 00 00 00 80 3F is DAC_Scale1, DAC # 0, 3F80000
 //    --DId --LEN --PayloadBytes
 //       |     |  DAC      Scale
 //     0210  0005   0    3F80000
-PTDataItem TDataItemBase::fromBytes(const TBytes &bytes, TError &result)
+PTDataItem TDataItemBase::fromBytes(TByteSpan bytes, TError &result)
 {
 	LOG_IT;
 	result = ERR_SUCCESS;
@@ -541,30 +658,24 @@ PTDataItem TDataItemBase::fromBytes(const TBytes &bytes, TError &result)
 
 	GUARD((bytes.size() >= sizeof(TDataItemHeader)), ERR_MSG_DATAITEM_TOO_SHORT, static_cast<int>(bytes.size()));
 
-	TDataItemHeader *head = (TDataItemHeader *)bytes.data();
+	const TDataItemHeader *head = reinterpret_cast<const TDataItemHeader *>(bytes.data());
 	GUARD(isValidDataItemID(head->DId), ERR_DId_INVALID, static_cast<__u16>(head->DId));
 
-	// PTDataItem anItem;
-	TDataItemLength DataSize = head->dataLength; // MessageLength
-	TBytes data{};
-	if (DataSize == 0)
-	{
-	}
-	else
-	{
-		data.insert(data.end(), bytes.cbegin() + sizeof(TDataItemHeader), bytes.cbegin() + sizeof(TDataItemHeader) + DataSize);
+	TDataItemLength DataSize = head->dataLength;
+	GUARD((bytes.size() >= sizeof(TDataItemHeader) + DataSize), ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH, DataSize);
 
+	TByteSpan data = bytes.subspan(sizeof(TDataItemHeader), DataSize);
+	if (DataSize != 0)
+	{
 		result = validateDataItemPayload(head->DId, data);
 		if (result != ERR_SUCCESS)
 		{
 			Error("TDataItem::fromBytes() failed validateDataItemPayload with status: "
 				  + std::to_string(-result) + ", " + err_msg[-result]);
-			return SafeMakeShared<TDataItemNYI>(DataItemIds::INVALID, TBytes{});
+			return SafeMakeShared<TDataItemNYI>(DataItemIds::INVALID, TByteSpan{});
 		}
 	}
-	//Debug("TDataItem::fromBytes sending to constructor: ", data);
-	// auto item = DIdDict.find(head->DId)->second.Construct(head->DId, data); // TODO: FIX: WARN: FIX: WARN: ASfdafasdfasdfasdfasdfasdfas dfasd fasdf asd fasd fased f
-	auto item = DIdDict.find(head->DId)->second.Construct(head->DId, data); // TODO: FIX: WARN: FIX: WARN: ASfdafasdfasdfasdfasdfasdfas dfasd fasdf asd fasd fased f
+	auto item = DIdDict.find(head->DId)->Construct(head->DId, data);
 	Log("Constructed Item as string:" + item->AsString(), item->Data);
 	return item;
 }
@@ -603,18 +714,39 @@ bool TDataItemBase::isValidDataLength() const
 
 TBytes TDataItemBase::AsBytes(bool bAsReply)
 {
-	TBytes bytes;
-	stuff<TDataId>(bytes, static_cast<__u16>(this->DId));
+	TBytes bytes(EncodedSize(bAsReply));
+	TCheckSum unused = 0;
+	WriteTo(bytes.data(), unused);
+	return bytes;
+}
+
+size_t TDataItemBase::EncodedSize(bool bAsReply)
+{
 	this->Data = this->calcPayload(bAsReply);
-	stuff<TDataItemLength>(bytes, static_cast<TDataItemLength>(this->Data.size()));
+	return sizeof(TDataItemHeader) + static_cast<TDataItemLength>(this->Data.size());
+}
 
-	bytes.insert(end(bytes), begin(Data), end(Data));
-	return bytes;
+__u8 *TDataItemBase::WriteTo(__u8 *dest, TCheckSum &sum) const
+{
+	const __u16 dId = static_cast<__u16>(this->DId);
+	const TDataItemLength len = static_cast<TDataItemLength>(this->Data.size());
+	const __u8 head[sizeof(TDataItemHeader)] = {
+		static_cast<__u8>(dId & 0xFF), static_cast<__u8>(dId >> 8),
+		static_cast<__u8>(len & 0xFF), static_cast<__u8>(len >> 8)};
+	for (__u8 aByte : head)
+	{
+		*dest++ = aByte;
+		sum = static_cast<TCheckSum>(sum + aByte);
+	}
+	if (len)
+		std::memcpy(dest, this->Data.data(), len);
+	sum = static_cast<TCheckSum>(sum + Checksum(TByteSpan(dest, len))); // summed while still in cache
+	return dest + len;
 }
 
 std::string TDataItemBase::getDIdDesc() const
 {
-	return DIdDict.find(this->getDId())->second.desc;
+	return std::string(DIdDict.find(this->getDId())->desc);
 }
 
 // returns human-readable, formatted (multi-line) string version of this TDataItem
@@ -640,9 +772,9 @@ TDataItemBase &TDataItemBase::Go()
 	LOG_IT;
 
 	auto it = DIdDict.find(this->getDId());
-    if (it != DIdDict.end() && it->second.go) {
+    if (it != DIdDict.end() && it->go) {
         Debug("Lambda GO call...");
-        it->second.go(this->Data);            // pass the whole buffer
+        it->go(this->Data);            // pass the whole buffer
     } else {
         Debug("ENTER - NYI!!!! : " + to_hex<__u16>(static_cast<__u16>(this->getDId())));
         this->resultCode = ERR_NYI;
@@ -674,7 +806,7 @@ static inline __u8 GetMSB(DataItemIds id) {
     return static_cast<__u8>(static_cast<unsigned>(id) >> 8);
 }
 
-TDataItemDoc::TDataItemDoc(DataItemIds id, const TBytes &data)
+TDataItemDoc::TDataItemDoc(DataItemIds id, TByteSpan data)
     : TDataItem<DOC_Params>(id, data)
 {
     // Ignore incoming payload.
@@ -691,12 +823,12 @@ TDataItemBase &TDataItemDoc::Go() {
     std::stringstream ss;
     // Iterate over all entries in the global DIdDict.
     for (const auto &entry : DIdDict) {
-        DataItemIds id = entry.first;
+        DataItemIds id = entry.DId;
         __u8 msb = GetMSB(id);
         __u8 lsb = static_cast<__u8>(static_cast<unsigned>(id) & 0xFF);
         // Only include items from the same group (MSB equals) and with LSB != 0.
         if (msb == group && lsb != 0) {
-            ss << entry.second.desc << "\n";
+            ss << entry.desc << "\n";
         }
     }
     std::string payload = ss.str();
@@ -719,7 +851,7 @@ std::string TDataItemDoc::AsString(bool /*bAsReply*/) {
 #pragma endregion
 
 #pragma region TDataItemDocGet
-TDataItemDocGet::TDataItemDocGet(DataItemIds id, const TBytes &data)
+TDataItemDocGet::TDataItemDocGet(DataItemIds id, TByteSpan data)
     : TDataItem<DOC_Get_Params>(id, data)
 {
     // No parameters expected.
@@ -735,10 +867,10 @@ TDataItemBase &TDataItemDocGet::Go() {
     // Iterate through the global dictionary.
     for (const auto &entry : DIdDict) {
         // The low byte of the DataItemId:
-        __u8 lsb = static_cast<__u8>(static_cast<unsigned>(entry.first) & 0xFF);
+        __u8 lsb = static_cast<__u8>(static_cast<unsigned>(entry.DId) & 0xFF);
         // Only include items where LSB is 0.
         if (lsb == 0) {
-            ss << entry.second.desc << "\n";
+            ss << entry.desc << "\n";
         }
     }
     std::string docPayload = ss.str();
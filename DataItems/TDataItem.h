@@ -34,6 +34,7 @@ TDataItemParent - virtual / interface
 #pragma once
 #include <functional>
 #include <map>
+#include <string_view>
 #include <memory>
 #include <iterator>
 #include <fmt/core.h>
@@ -44,6 +45,8 @@ TDataItemParent - virtual / interface
 #include "../eNET-AIO16-16F.h"
 #include "../TError.h"
 #include "../apci.h"
+#include "../arena.h"
+#include "../paramcodec.h"
 
 template<typename> class TDataItem;
 struct GenericParams {};
@@ -59,7 +62,7 @@ using TDataItemLength=__u16;
 
 #pragma pack(push, 1)
 
-int validateDataItemPayload(DataItemIds DataItemID, TBytes Data);
+int validateDataItemPayload(DataItemIds DataItemID, TByteSpan Data);
 // return register width for given offset as defined for eNET-AIO registers
 // returns 0 if offset is invalid
 int widthFromOffset(int ofs);
@@ -98,11 +101,11 @@ public:
 	virtual std::string AsString(bool bAsReply = false) = 0;
 
 	// ========== Static / Factory Methods ==========
-    static PTDataItemBase fromBytes(const TBytes &msg, TError &result);
+    static PTDataItemBase fromBytes(TByteSpan msg, TError &result);
 
-    static int validateDataItemPayload(DataItemIds DataItemID, const TBytes &Data);
+    static int validateDataItemPayload(DataItemIds DataItemID, TByteSpan Data);
     static int isValidDataItemID(DataItemIds DataItemID);
-    static int validateDataItem(const TBytes &msg);
+    static int validateDataItem(TByteSpan msg);
     static __u16 getMinLength(DataItemIds DId);
     static __u16 getTargetLength(DataItemIds DId);
     static __u16 getMaxLength(DataItemIds DId);
@@ -112,6 +115,10 @@ public:
     DataItemIds getDId() const;
     bool isValidDataLength() const;
     TBytes AsBytes(bool bAsReply);
+    // encoded size (header + payload); calls calcPayload() and keeps its result in Data for WriteTo()
+    size_t EncodedSize(bool bAsReply);
+    // writes DId, Len(Data), Data at dest, adding each byte into sum; returns one past the last byte written
+    __u8 *WriteTo(__u8 *dest, TCheckSum &sum) const;
     std::string getDIdDesc() const;
     TError getResultCode();
     std::shared_ptr<void> getResultValue();
@@ -120,14 +127,14 @@ public:
 };
 #pragma endregion
 
-typedef std::shared_ptr<TDataItemBase> DIdConstructor(DataItemIds DId, TBytes FromBytes);
+typedef std::shared_ptr<TDataItemBase> DIdConstructor(DataItemIds DId, TByteSpan FromBytes);
 
 
 template <class q>
-std::shared_ptr<TDataItemBase> construct(DataItemIds id, TBytes FromBytes)
+std::shared_ptr<TDataItemBase> construct(DataItemIds id, TByteSpan FromBytes)
 {
-    // q must inherit from TDataItemBase
-    return std::make_shared<q>(id, FromBytes);
+    // q must inherit from TDataItemBase; lands in the current TMessageArena, if any (see arena.h)
+    return std::allocate_shared<q>(std::pmr::polymorphic_allocator<q>(CurrentArena()), id, FromBytes);
 }
 typedef struct
 {
@@ -135,19 +142,58 @@ typedef struct
 	TDataItemLength dataLength;
 } TDataItemHeader;
 
+// a DId's hardware action, for DIds that don't need a class of their own; must be a captureless lambda or a function
+typedef void TDIdGo(const TBytes &Data);
+
+// the parts of the board a DId's Go() uses.  Messages whose DataItems share no lane can run at the same time, each on
+// its own ActionThread (see aioenetd.cpp [ActionLanes])
+typedef __u8 TLanes;
+#define LaneNone    0x00
+#define LaneAdc     0x01
+#define LaneDac     0x02
+#define LaneDio     0x04
+#define LaneConfig  0x08 // the Config struct
+#define LaneAll     0x0F // every hardware lane; LaneFile isn't one
+#define LaneFile    0x10 // Go() does its own (fsync'd) file I/O: the Message runs on the FileThread, never an ActionThread
+#define LaneByGroup 0x80 // DIdList only: whatever the DId's group uses (see TDataItem.cpp DIdGroupLanes())
+
+// roughly how long a DId's Go() keeps the action pipeline busy, in microseconds; what the per-client scheduler charges a
+// Message (see aioenetd.cpp [ActionLanes]).  Estimates, not measurements; only their ratios matter
+typedef __u16 TCost;
+#define CostByDefault 0     // DIdList only: CostDefault, or CostFileIo for a LaneFile DId
+#define CostDefault   10    // a register or two, plus parsing and the reply
+#define CostAdcScan   200   // a software-started ADC scan, polling the FIFO until every channel is in
+#define CostFileIo    1000  // an fsync()ed file write or two
+
+#pragma pack(push, 8) // not a wire struct; the pointers and the string_view want their natural alignment
 typedef struct __DIdDictEntry_inner
 {
+	DataItemIds DId;
 	TDataItemLength minLen;
 	TDataItemLength typLen;
 	TDataItemLength maxLen;
-	// std::function<std::unique_ptr<TDataItem>(TBytes)> Construct;
 	DIdConstructor *Construct;
-	std::string desc;
-	std::function<void(const TBytes&)> go;
+	std::string_view desc;
+	TDIdGo *go;
+	TLanes lanes;
+	TCost cost;
+	bool bCoalesce; // a side-effect-free read: identical ones may share one hardware access (see coalesce.h)
 } TDIdDictEntry;
+#pragma pack(pop)
 
-//  __DIdDictEntry_inner ;
-extern const std::map<DataItemIds, TDIdDictEntry> DIdDict;
+/*	DIdDict: every DId this build knows about, built at compile time (see TDataItem.cpp [DIdDict definition]).
+	find() is two array lookups, by the DId's group (high byte) and then its index (low byte); iterating visits the
+	entries in DId order.  No static initialization, nothing on the heap.
+*/
+class TDIdDict
+{
+public:
+	const TDIdDictEntry *find(DataItemIds DId) const; // end() if DId is unknown
+	const TDIdDictEntry *begin() const;
+	const TDIdDictEntry *end() const;
+	size_t size() const { return static_cast<size_t>(end() - begin()); }
+};
+extern const TDIdDict DIdDict;
 
 
 
@@ -157,31 +203,32 @@ template <typename ParamStruct>
 class TDataItem : public TDataItemBase
 {
 public:
-    ParamStruct params;  // e.g., DAC_OutputParams
-	TBytes rawBytes;
+    using TParams = ParamStruct;
+    ParamStruct params{};  // e.g., DAC_OutputParams
+	TArenaBytes rawBytes; // the received data bytes, in the same arena as this TDataItem
 
+    // ParamStructs with a TParamLayout (see paramcodec.h) encode themselves; anything else echoes what was received
 	TBytes calcPayload(bool bAsReply = false) override {
-        TBytes bytes;
-        bytes.resize(sizeof(ParamStruct));
-        std::memcpy(bytes.data(), &params, sizeof(ParamStruct));
-        return rawBytes;
-		//return bytes;
+        if constexpr (HasParamLayout<ParamStruct>)
+            return TParamLayout<ParamStruct>::Encode(params);
+        else
+            return TBytes(rawBytes.begin(), rawBytes.end());
     }
 
     // Constructor
-    TDataItem(DataItemIds dId, const TBytes &bytes)
+    TDataItem(DataItemIds dId, TByteSpan bytes)
         : TDataItemBase(dId),
-          rawBytes(bytes)
+          rawBytes(bytes.begin(), bytes.end(), CurrentArena())
     {
         Trace("TDataItem<ParamStruct>(dId, bytes) constructor");
 
-        // By default, copy entire `bytes` into `params` if it fits
-        if (bytes.size() >= sizeof(ParamStruct)) {
-            std::memcpy(&params, bytes.data(), sizeof(ParamStruct));
-        }
-        else {
-            // We'll let the derived class handle partial or custom parsing if it wants
-            Trace("ParamStruct is bigger than rawBytes; derived constructor may fix this." + to_hex<size_t>(bytes.size()) + " > " + to_hex<size_t>(sizeof(ParamStruct)));
+        // decode `bytes` into `params` if it carries every field; derived classes handle shorter/custom forms
+        if constexpr (HasParamLayout<ParamStruct>)
+        {
+            if (bytes.size() >= TParamLayout<ParamStruct>::WireSize)
+                TParamLayout<ParamStruct>::Decode(params, bytes);
+            else
+                Trace("payload shorter than ParamStruct's wire size; derived constructor may fix this." + to_hex<size_t>(bytes.size()) + " < " + to_hex<size_t>(TParamLayout<ParamStruct>::WireSize));
         }
     }
 
@@ -199,7 +246,7 @@ struct DOC_Params { };
 class TDataItemDoc : public TDataItem<DOC_Params> {
 public:
     // Constructors: the incoming TBytes payload is ignored.
-    TDataItemDoc(DataItemIds id, const TBytes &data);
+    TDataItemDoc(DataItemIds id, TByteSpan data);
     TDataItemDoc(DataItemIds id);
 
     // Assemble documentation payload into this->Data.
@@ -215,7 +262,7 @@ struct DOC_Get_Params { };
 class TDataItemDocGet : public TDataItem<DOC_Get_Params> {
 public:
     // Constructors – incoming payload is ignored.
-    TDataItemDocGet(DataItemIds id, const TBytes &data);
+    TDataItemDocGet(DataItemIds id, TByteSpan data);
     TDataItemDocGet(DataItemIds id);
 
     // In Go() we assemble the documentation payload into this->Data.
@@ -233,8 +280,8 @@ struct NYIParams {
 class TDataItemNYI : public TDataItem<NYIParams>
 {
 public:
-    // Must match the TDataItem<NYIParams>(DataItemIds id, TBytes bytes) signature
-    TDataItemNYI(DataItemIds id, TBytes bytes)
+    // Must match the TDataItem<NYIParams>(DataItemIds id, TByteSpan bytes) signature
+    TDataItemNYI(DataItemIds id, TByteSpan bytes)
         : TDataItem(id, bytes)
     {
         // Possibly do debug logs
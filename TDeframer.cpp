@@ -0,0 +1,82 @@
+#include <cstring>
+#include <endian.h>
+
+#include "TDeframer.h"
+
+void TDeframer::MakeRoom(size_t room)
+{
+	if (head == tail)
+	{
+		head = tail = 0;
+		if (buf.size() > DeframerIdleCapacity)
+		{
+			buf.resize(DeframerIdleCapacity);
+			buf.shrink_to_fit();
+		}
+	}
+	if (buf.size() - tail >= room)
+		return;
+
+	if (head > 0) // slide the partial frame down to the front
+	{
+		std::memmove(buf.data(), buf.data() + head, tail - head);
+		tail -= head;
+		head = 0;
+	}
+	if (buf.size() - tail < room)
+		buf.resize(tail + room);
+}
+
+__u8 *TDeframer::WritePtr(size_t &room)
+{
+	room = DeframerMinRecv;
+	if ((frameLength > 0) && (frameLength - Pending() > room))
+		room = frameLength - Pending();
+	MakeRoom(room);
+	room = buf.size() - tail;
+	return buf.data() + tail;
+}
+
+void TDeframer::Commit(size_t bytesReceived)
+{
+	tail += bytesReceived;
+}
+
+void TDeframer::Append(const __u8 *data, size_t length)
+{
+	MakeRoom(length);
+	std::memcpy(buf.data() + tail, data, length);
+	tail += length;
+}
+
+TDeframer::TResult TDeframer::Next(const __u8 *&frame, size_t &aFrameLength, __u32 &payloadLength)
+{
+	if (frameLength == 0)
+	{
+		if (Pending() < sizeof(TMessageId) + sizeof(TMessagePayloadSize))
+			return TResult::NeedMore;
+
+		__u32 payloadLenLe = 0;
+		std::memcpy(&payloadLenLe, buf.data() + head + sizeof(TMessageId), sizeof(payloadLenLe));
+		payloadLength = MessagePayloadLength(le32toh(payloadLenLe)); // bits 31:21 are flags, the TTL; see TMessage.h
+		if (payloadLength > maxPayloadLength)
+			return TResult::Oversize;
+
+		frameLength = sizeof(TMessageId) + sizeof(TMessagePayloadSize) + payloadLength + sizeof(TCheckSum);
+	}
+
+	if (Pending() < frameLength)
+		return TResult::NeedMore;
+
+	frame = buf.data() + head;
+	aFrameLength = frameLength;
+	payloadLength = static_cast<__u32>(frameLength - (sizeof(TMessageId) + sizeof(TMessagePayloadSize) + sizeof(TCheckSum)));
+	head += frameLength;
+	frameLength = 0;
+	return TResult::Frame;
+}
+
+void TDeframer::Clear()
+{
+	head = tail = frameLength = 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+/*
+TDeframer: per-connection reassembly of received bytes into MLLLL_C Message frames (see TMessage.h [MESSAGE FORMAT])
+
+	Bytes are received straight into the deframer's buffer (WritePtr()/Commit()) or copied in (Append()), and Next() hands
+	back each complete frame as a pointer+length into that buffer; no per-frame copy and no erase-from-front.
+	The LLLL header of the frame in progress is decoded once, when its 5th byte arrives, no matter how the frame is split
+	across recv()s.
+
+	Consumed bytes are reclaimed by sliding the unconsumed tail to the front of the buffer, which only happens when more
+	room is needed (and never while a frame handed out by Next() is still in use by the caller).
+*/
+
+#include <vector>
+#include <linux/types.h>
+
+#include "TMessage.h"
+
+#pragma pack(push, 8) // TDataItem.h leaves pack(1) in effect; see uring.h
+class TDeframer
+{
+public:
+	enum class TResult { Frame, NeedMore, Oversize };
+
+	// room to recv() into; at least DeframerMinRecv bytes, or enough for the rest of the frame in progress
+	__u8 *WritePtr(size_t &room);
+	void Commit(size_t bytesReceived);
+	void Append(const __u8 *data, size_t length);
+
+	// TResult::Frame: frame/frameLength describe the next complete Message (valid until the next WritePtr()/Append())
+	// TResult::Oversize: payloadLength is the unacceptable stated length; the stream can't be resynchronized
+	TResult Next(const __u8 *&frame, size_t &frameLength, __u32 &payloadLength);
+
+	size_t Pending() const { return tail - head; }
+	void Clear();
+
+private:
+	void MakeRoom(size_t room);
+
+	std::vector<__u8> buf;
+	size_t head = 0;          // first unconsumed byte
+	size_t tail = 0;          // one past the last received byte
+	size_t frameLength = 0;   // length of the frame starting at head, once its header has arrived; 0 until then
+};
+#pragma pack(pop)
+
+#define DeframerMinRecv 16384
+#define DeframerIdleCapacity 65536 // an idle connection gives back anything beyond this after a large Message
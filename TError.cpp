@@ -17,5 +17,8 @@ const char *err_msg[] = {
 	/* -13 */ "Not Yet Implemented",
 	/* -14 */ "ADC Busy",
 	/* -15 */ "ADC FATAL",
+	/* -16 */ "Server busy; retry later",
+	/* -17 */ "Message expired before it ran",
+	/* -18 */ "Output write superseded by a newer one",
 	0
 };
\ No newline at end of file
@@ -30,6 +30,9 @@ using TError = __u32;
 #define ERR_NYI -13
 #define ERR_ADC_BUSY -14
 #define ERR_ADC_FATAL -15
+#define ERR_BUSY -16 // admission control turned the Message away; the client should back off and retry
+#define ERR_EXPIRED -17 // the Message's time-to-live ran out before it could run; nothing in it was done
+#define ERR_SUPERSEDED -18 // a newer write to the same output was queued before this one ran; it wasn't done
 
 
 extern const char *err_msg[];
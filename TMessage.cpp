@@ -7,6 +7,7 @@
 #include "logging.h"
 #include "TError.h"
 #include "TMessage.h"
+#include "checksum.h"
 #include "DataItems/TDataItem.h"
 #include "eNET-AIO16-16F.h"
 #include "adc.h"
@@ -24,14 +25,11 @@ const std::vector<TMessageId> ValidMessageIDs{
 };
 
 #pragma region TMessage implementation
-TCheckSum TMessage::calculateChecksum(TBytes Message)
+TCheckSum TMessage::calculateChecksum(TByteSpan Message)
 {
 	LOG_IT;
 
-	TCheckSum checksum = 0;
-	for (__u8 aByte : Message)
-		checksum = static_cast<TCheckSum>(checksum + aByte);
-	return checksum;
+	return Checksum(Message); // vectorized; see checksum.h
 }
 
 bool TMessage::isValidMessageID(TMessageId MessageId)
@@ -52,38 +50,33 @@ bool TMessage::isValidMessageID(TMessageId MessageId)
 // returns 0 if the Payload is well-formed
 // this means that all the Data Items are well formed and the total size matches the expectation
 // "A Message has an optional Payload, which is a sequence of zero or more Data Items"
-TError TMessage::validatePayload(TBytes Payload)
+TError TMessage::validatePayload(TByteSpan Payload)
 {
 	LOG_IT;
 
-	// WARN: Does not seem to work as expected when parsing multiple DataItems
 	TError result = ERR_SUCCESS;
 	if (Payload.size() == 1) // one-byte Payload is "the checksum byte".
 		return result;
 
 	if (Payload.size() == 0) // zero-length Payload size is a valid payload
 		return ERR_MSG_DATAITEM_TOO_SHORT;
-	if (Payload.size() < sizeof(DataItemIds)+sizeof(TDataItemLength))
-		return ERR_MSG_DATAITEM_TOO_SHORT;
-
-	TDataItemHeader *head = (TDataItemHeader *)Payload.data();
 
-	__u32 DataItemSize = static_cast<__u32>(sizeof(TDataItemHeader) + head->dataLength);
-	if (DataItemSize > Payload.size())
+	// walk the Data Items in place; each one is checked as a sub-span of Payload, and a lone trailing byte is the checksum
+	while ((result == ERR_SUCCESS) && (Payload.size() > 1))
 	{
-		Error("--ERR: data item thinks it is longer than payload, disize: " + std::to_string(DataItemSize) + ", psize: " + std::to_string(Payload.size()));
-		result = ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH;
-	}
-	else
-	{
-		TBytes DataItem = slicing(Payload, 0, DataItemSize);
-		result = TDataItemBase::validateDataItem(DataItem);
-		if (result == 0) // if the Data Item is well-formed, check the next one
+		if (Payload.size() < sizeof(TDataItemHeader))
+			return ERR_MSG_DATAITEM_TOO_SHORT;
+
+		const TDataItemHeader *head = reinterpret_cast<const TDataItemHeader *>(Payload.data());
+		size_t DataItemSize = sizeof(TDataItemHeader) + head->dataLength;
+		if (DataItemSize > Payload.size())
 		{
-			Payload.erase(Payload.cbegin(), Payload.cbegin() + DataItemSize);
-			if (Payload.size() > 0)
-				result = validatePayload(Payload);
+			Error("--ERR: data item thinks it is longer than payload, disize: " + std::to_string(DataItemSize) + ", psize: " + std::to_string(Payload.size()));
+			return ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH;
 		}
+
+		result = TDataItemBase::validateDataItem(Payload.first(DataItemSize));
+		Payload = Payload.subspan(DataItemSize);
 	}
 
 	return result;
@@ -91,7 +84,7 @@ TError TMessage::validatePayload(TBytes Payload)
 
 // Checks the Message for well-formedness
 // returns 0 if Message is well-formed
-TError TMessage::validateMessage(TBytes buf) // "NAK()" is shorthand for return error condition etc
+TError TMessage::validateMessage(TByteSpan buf) // "NAK()" is shorthand for return error condition etc
 {
 	LOG_IT;
 
@@ -99,26 +92,25 @@ TError TMessage::validateMessage(TBytes buf) // "NAK()" is shorthand for return
 	if (buf.size() < minimumMessageLength)
 		return ERR_MSG_TOO_SHORT; // NAK(received insufficient data, yet) until more data (the rest of the Message/header) received?
 
-	TMessageHeader *head = (TMessageHeader *)buf.data();
+	const TMessageHeader *head = reinterpret_cast<const TMessageHeader *>(buf.data());
 
 	if (!isValidMessageID(head->type))
 		return ERR_MSG_ID_UNKNOWN; // NAK(invalid MessageId Category byte)
 
-	__u32 statedMessageLength = minimumMessageLength + head->payload_size;
+	size_t statedMessageLength = minimumMessageLength + static_cast<size_t>(MessagePayloadLength(head->payload_size));
 	if (buf.size() < statedMessageLength)
 		return ERR_MSG_LEN_MISMATCH; // NAK(received insufficient data, yet) until more data
 
-	TCheckSum checksum = TMessage::calculateChecksum(buf);
+	TCheckSum checksum = TMessage::calculateChecksum(buf.first(statedMessageLength));
 
 	if (__valid_checksum__ != checksum)
 	{
 		Error("calculated csum: " + std::to_string(checksum) + " ERROR should be zero\n");
 		return ERR_MSG_CHECKSUM; // NAK(invalid checksum)
 	}
-	TBytes payload = buf;
-	payload.erase(payload.cbegin(), payload.cbegin() + sizeof(TMessageHeader));
 
-	TError validPayload = validatePayload(payload);
+	// payload plus the checksum byte, which validatePayload() expects to find on the end
+	TError validPayload = validatePayload(buf.subspan(sizeof(TMessageHeader), statedMessageLength - sizeof(TMessageHeader)));
 	if (validPayload != 0)
 		return validPayload;
 
@@ -127,34 +119,34 @@ TError TMessage::validateMessage(TBytes buf) // "NAK()" is shorthand for return
 /* A Payload consists of zero or more DataItems
  * This function parses an array of bytes that is supposed to be a Payload
  * ...then returns a vector of those TDataItems and sets result to indicate error/success
+ * Each TDataItem is constructed from its own sub-span of Payload; nothing is copied until the item stores its data
  */
-TPayload TMessage::parsePayload(TBytes Payload, __u32 payload_length, TError &result)
+TPayload TMessage::parsePayload(TByteSpan Payload, TError &result)
 {
 	LOG_IT;
 
 	TPayload dataItems; // an empty vector<>
 	result = ERR_SUCCESS;
-	if (payload_length == 0)
+	if (Payload.size() == 0)
 	{ // zero-length payload size is a valid payload
 		return dataItems;
 	}
 
-	TBytes DataItemBytes = Payload; // pointer to start of byte[] Payload
 	Trace("Parsing Each Data Item in Payload generated by TMessage::FromBytes");
-	while (payload_length >= sizeof(TDataItemHeader))
+	while (Payload.size() >= sizeof(TDataItemHeader))
 	{
-		TDataItemHeader *head = (TDataItemHeader *)DataItemBytes.data();
+		const TDataItemHeader *head = reinterpret_cast<const TDataItemHeader *>(Payload.data());
 		// DataItemLength is the size of the Data Item, including the size of the Data Item Length
 		// + Data Item ID, and the Data Item's payload's bytelength
-		__u32 DataItemLength = static_cast<__u32>(sizeof(TDataItemHeader) + head->dataLength); // DataItem[3] is payload length
-		if (DataItemLength > payload_length)
+		size_t DataItemLength = sizeof(TDataItemHeader) + head->dataLength;
+		if (DataItemLength > Payload.size())
 		{
 			result = ERR_MSG_PAYLOAD_DATAITEM_LEN_MISMATCH;
 			Error("TMessage::parsePayload: DataItemLength > payload_length returned error " + std::to_string(result) + ", " + err_msg[-result]);
 			break;
 		}
 
-		PTDataItemBase item = TDataItemBase::fromBytes(DataItemBytes, result);
+		PTDataItemBase item = TDataItemBase::fromBytes(Payload.first(DataItemLength), result);
 		if (result != ERR_SUCCESS)
 		{
 			Error("TMessage::parsePayload: DIAG::fromBytes returned error " + std::to_string(result) + ", " + err_msg[-result]);
@@ -162,14 +154,12 @@ TPayload TMessage::parsePayload(TBytes Payload, __u32 payload_length, TError &re
 		}
 		dataItems.push_back(item);
 
-		// remove the bytes from the Payload that were parsed into 'item'
-		DataItemBytes.erase(DataItemBytes.cbegin(), DataItemBytes.cbegin() + DataItemLength);
-		payload_length -= DataItemLength;
+		Payload = Payload.subspan(DataItemLength);
 	}
 	return dataItems;
 }
 
-TMessage TMessage::FromBytes(TBytes buf, TError &result)
+TMessage TMessage::FromBytes(TByteSpan buf, TError &result)
 {
 	LOG_IT;
 
@@ -183,7 +173,7 @@ TMessage TMessage::FromBytes(TBytes buf, TError &result)
 		Error("Message Size < minimumMessageLength (" + std::to_string(siz) + " < " + std::to_string(minimumMessageLength));
 		return TMessage(_INVALID_MESSAGEID_); // NAK(received insufficient data, yet) until more data (the rest of the Message/header) received?
 	}
-	TMessageHeader *head = (TMessageHeader *)buf.data();
+	const TMessageHeader *head = reinterpret_cast<const TMessageHeader *>(buf.data());
 
 	if (!isValidMessageID(head->type))
 	{
@@ -191,25 +181,15 @@ TMessage TMessage::FromBytes(TBytes buf, TError &result)
 		Error("TMessage::FromBytes: detected invalid MId: " + std::to_string(result) + ", " + err_msg[-result]);
 		return TMessage();
 	}
-	__u32 statedMessageLength = minimumMessageLength + head->payload_size;
+	size_t statedMessageLength = minimumMessageLength + static_cast<size_t>(MessagePayloadLength(head->payload_size));
 	if (siz < statedMessageLength)
 	{
 		result = ERR_MSG_LEN_MISMATCH; // NAK(received insufficient data, yet) until more data
 		return TMessage();
 	}
 
-	TPayload dataItems;
-	if (head->payload_size > 0)
-	{
-		Trace("TMessage::FromBytes: Payload is " + std::to_string(head->payload_size) + " bytes");
-		TBytes payload = buf;
-		payload.erase(payload.cbegin(), payload.cbegin() + sizeof(TMessageHeader));
-		Trace("TMessage::FromBytes generated payload: ", payload);
-		dataItems = parsePayload(payload, head->payload_size, result);
-		Trace("parsePayload returned " + std::to_string(dataItems.size()) + " with resultCode " + std::to_string(result));
-	}
-
-	TCheckSum checksum = calculateChecksum(buf);
+	// checksum before building any TDataItems, so a corrupt Message costs one pass over its bytes and nothing more
+	TCheckSum checksum = calculateChecksum(buf.first(statedMessageLength));
 	if (__valid_checksum__ != checksum)
 	{
 		result = ERR_MSG_CHECKSUM; // NAK(invalid checksum)
@@ -217,7 +197,18 @@ TMessage TMessage::FromBytes(TBytes buf, TError &result)
 		return TMessage();
 	}
 
-	TMessage message = TMessage(head->type, dataItems);
+	TPayload dataItems;
+	const TMessagePayloadSize payloadSize = MessagePayloadLength(head->payload_size);
+	if (payloadSize > 0)
+	{
+		Trace("TMessage::FromBytes: Payload is " + std::to_string(payloadSize) + " bytes");
+		TByteSpan payload = buf.subspan(sizeof(TMessageHeader), payloadSize);
+		Trace("TMessage::FromBytes generated payload: ", payload);
+		dataItems = parsePayload(payload, result);
+		Trace("parsePayload returned " + std::to_string(dataItems.size()) + " with resultCode " + std::to_string(result));
+	}
+
+	TMessage message = TMessage(head->type, std::move(dataItems));
 	Trace("TMessage::FromBytes: TMessage constructed...Payload DataItem Count: " + std::to_string(message.DataItems.size()));
 	return message;
 }
@@ -234,11 +225,7 @@ TMessage::TMessage(TMessageId MId, TPayload Payload)
 	LOG_IT;
 
 	this->setMId(MId);
-	for (auto one : Payload)
-	{
-		DataItems.push_back(one);
-	}
-	// DataItems = Payload;
+	DataItems = std::move(Payload);
 }
 
 TMessage::TMessage(TBytes Msg)
@@ -278,46 +265,56 @@ TMessage &TMessage::addDataItem(PTDataItemBase item)
 	return *this;
 }
 
-void TMessage::appendLengthBytes(TBytes& bytes, TMessagePayloadSize length)
+size_t TMessage::EncodedSize(bool bAsReply)
 {
-    for (uint i = 0; i < sizeof(TMessagePayloadSize); i++)
-    {
-        __u8 lsb = length & 0xFF;
-        bytes.push_back(lsb);
-        length >>= 8;
-    }
+	size_t size = minimumMessageLength;
+	for (auto &item : this->DataItems)
+		size += item->EncodedSize(bAsReply);
+	return size;
 }
-void TMessage::appendPayloadLengthAndItems(TBytes& bytes, bool bAsReply)
-{
-    TMessagePayloadSize payloadLength = 0;
-    TBytes payloadBytes;
-
-    for (auto item : this->DataItems)
-    {
-        TBytes itemBytes = item->TDataItemBase::AsBytes(bAsReply);
-        payloadBytes.insert(end(payloadBytes), begin(itemBytes), end(itemBytes));
-        payloadLength = static_cast<TMessagePayloadSize>(payloadLength + itemBytes.size());
-    }
-
-    appendLengthBytes(bytes, payloadLength);
-    bytes.insert(end(bytes), begin(payloadBytes), end(payloadBytes));
-}
-TBytes TMessage::AsBytes(bool bAsReply)
+
+// one pass over the output: every byte is summed as it is written, and the checksum byte goes last
+size_t TMessage::WriteTo(__u8 *dest, size_t encodedSize)
 {
-    LOG_IT;
-    Trace("AsBytes"+ bAsReply?", as Reply":", NOT reply");
+	__u8 *p = dest;
+	TCheckSum sum = 0;
+
+	*p++ = this->Id;
+	sum = static_cast<TCheckSum>(sum + this->Id);
 
-    TBytes bytes;
-    bytes.push_back(this->Id);
-    appendPayloadLengthAndItems(bytes, bAsReply);
+	TMessagePayloadSize payloadLength = static_cast<TMessagePayloadSize>(encodedSize - minimumMessageLength);
+	for (uint i = 0; i < sizeof(TMessagePayloadSize); i++)
+	{
+		__u8 lsb = payloadLength & 0xFF;
+		*p++ = lsb;
+		sum = static_cast<TCheckSum>(sum + lsb);
+		payloadLength >>= 8;
+	}
 
-    TCheckSum csum = static_cast<TCheckSum>(-calculateChecksum(bytes));
-    bytes.push_back(csum); // WARN: only works because TCheckSum == __u8
-    Trace("Built: ", bytes);
+	for (auto &item : this->DataItems)
+		p = item->WriteTo(p, sum);
 
-    return bytes;
+	*p++ = static_cast<TCheckSum>(-sum); // WARN: only works because TCheckSum == __u8
+	return static_cast<size_t>(p - dest);
 }
 
+void TMessage::AsBytes(TBytes &bytes, bool bAsReply)
+{
+	LOG_IT;
+	Trace("AsBytes"+ bAsReply?", as Reply":", NOT reply");
+
+	size_t size = EncodedSize(bAsReply);
+	bytes.resize(size); // keeps the caller's capacity; only grows when this Message is the biggest yet
+	WriteTo(bytes.data(), size);
+	Trace("Built: ", bytes);
+}
+
+TBytes TMessage::AsBytes(bool bAsReply)
+{
+	TBytes bytes;
+	AsBytes(bytes, bAsReply);
+	return bytes;
+}
 
 std::string TMessage::AsString(bool bAsReply)
 {
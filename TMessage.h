@@ -35,7 +35,10 @@ This TMessage Library provides functions to:
 		MLLLL_C
 	where
 		M       is a Message ID# ("MId"), which may be mnemonic/logical; proposed MId include "C", "Q", "E", "X", "R", and "M"
-		LLLL    is the Length of an optional payload; the 21 LSBits are significant; bits 31:21 are reserved flag bits
+		LLLL    is the Length of an optional payload; the 21 LSBits are significant; bits 31:21 are flag bits:
+				bits 30:21 are an optional time-to-live, 0 for none; bit 31 says it counts 100 ms units instead of 1 ms
+				A Message still waiting to run when its TTL (from when the server received it) runs out isn't run; its
+				Response is "E" with a SYS_Error whose ErrorCode is ERR_EXPIRED
 				// TODO: confirm 21 bits is the minimum to hold 16*(sizeof(TDataItemHeader)+maxDataLength)
 		_       is zero or more bytes, the optional payload's data
 		C       is the checksum for all bytes in MMMM, LL, and _
@@ -147,6 +150,21 @@ using TCheckSum = __u8;
 #define maxDataLength (std::numeric_limits<TDataItemLength>::max())
 #define maxPayloadLength ((TMessagePayloadSize)(sizeof(TDataItemHeader) + maxDataLength) * 16)
 
+// the LLLL field's parts; see [MESSAGE FORMAT]
+#define MessageLengthMask 0x001FFFFFu
+#define MessageTtlShift 21
+#define MessageTtlMask 0x3FFu         // after shifting
+#define MessageTtlCoarse 0x80000000u  // the TTL counts 100 ms units
+
+// the payload length LLLL says
+inline TMessagePayloadSize MessagePayloadLength(__u32 LLLL) { return LLLL & MessageLengthMask; }
+// the time-to-live LLLL carries, in ms; 0 if it has none
+inline __u32 MessageTtlMs(__u32 LLLL)
+{
+	const __u32 ttl = (LLLL >> MessageTtlShift) & MessageTtlMask;
+	return (LLLL & MessageTtlCoarse) ? ttl * 100 : ttl;
+}
+
 // using TMessageHeader =  struct
 // {
 // 	TMessageId type;
@@ -159,24 +177,24 @@ class TMessage
 public:
 	// Sums all bytes in Message, specifically including the checksum byte
 	// WARNING: this algorithm only works if TChecksum is a byte
-	static TCheckSum calculateChecksum(TBytes Message);
+	static TCheckSum calculateChecksum(TByteSpan Message);
 	static bool isValidMessageID(TMessageId MessageId);
 	// Checks the Payload for well-formedness
 	// returns 0 if the Payload is well-formed
 	// this means that all the Data Items are well formed and the total size matches the expectation
 	// "A Message has an optional Payload, which is a sequence of zero or more Data Items"
-	static TError validatePayload(TBytes Payload);
+	static TError validatePayload(TByteSpan Payload);
 	// Checks the Message for well-formedness
 	// returns 0 if Message is well-formed
-	static TError validateMessage(TBytes buf);
+	static TError validateMessage(TByteSpan buf);
 	/* A Payload consists of zero or more DataItems
 	 * This function parses an array of bytes that is supposed to be a Payload
 	 * ...then returns a vector of those TDataItems and sets result to indicate error/success
 	 */
-	static TPayload parsePayload(TBytes Payload, __u32 payload_length, TError &result);
+	static TPayload parsePayload(TByteSpan Payload, TError &result);
 	// factory method but might not be as good as TDataItem::fromBytes()
 	// TODO: figure out F or f for the name
-	static TMessage FromBytes(TBytes buf, TError &result);
+	static TMessage FromBytes(TByteSpan buf, TError &result);
 
 	static void pushLen(TBytes & buf, TMessagePayloadSize len)
 	{
@@ -199,8 +217,6 @@ public:
 	 * It throws exceptions on errors
 	 */
 	explicit TMessage(TBytes Msg);
-	void appendLengthBytes(TBytes &bytes, TMessagePayloadSize length);
-	void appendPayloadLengthAndItems(TBytes &bytes, bool bAsReply);
 
 	TMessageId getMId();
 	TCheckSum getChecksum(bool bAsReply = false);
@@ -211,6 +227,12 @@ public:
 
 	// returns this Message serialized into TBytes suitable for TCP send()
 	TBytes AsBytes(bool bAsReply = false);
+	// as above, but into bytes (resized to fit), so a reused buffer costs no allocation
+	void AsBytes(TBytes &bytes, bool bAsReply = false);
+	// serialized size; runs each TDataItem's calcPayload(), which WriteTo() then copies out
+	size_t EncodedSize(bool bAsReply = false);
+	// serializes into dest, which must hold encodedSize (the EncodedSize() just called) bytes; returns bytes written
+	size_t WriteTo(__u8 *dest, size_t encodedSize);
 	// returns this Message as a human-readable std::string
 	std::string AsString(bool bAsReply = false);
 
@@ -10,10 +10,15 @@
 #include "TError.h"
 #include "eNET-AIO16-16F.h"
 #include "apcilib.h"
+#include "apci.h"
 #include "adc.h"
+#include "uring.h"
 extern volatile sig_atomic_t done;
 static uint32_t ring_buffer[RING_BUFFER_SLOTS][SAMPLES_PER_TRANSFER];
 
+#define AdcUringBatch 32 // full DMA slots log_main() hands the kernel in one io_uring_enter(); a power of 2
+bool bAdcUseIoUring = false; // AIOENET_IO_BACKEND=io_uring; log_main() falls back to send() if the kernel can't
+
 volatile bool AdcStreamTerminate;
 
 pthread_t worker_thread;
@@ -32,6 +37,61 @@ int AdcWorkerThreadID = -1;
 
 bool AdcLoggerTerminate = false;
 
+// log_main(), io_uring: sends `slots` DMA slots from `first` on as one linked chain of sends, with one io_uring_enter()
+// when the socket has room.  What a short send left, and the sends the kernel cancelled after it, go out with send().
+// Returns the bytes sent, or -1 with errno set (EIO: the ring itself failed)
+static ssize_t SendAdcSlotsUring(TIoUring &ring, int conn, int first, int slots)
+{
+	const size_t slotBytes = sizeof(uint32_t) * SAMPLES_PER_TRANSFER;
+	size_t sent[AdcUringBatch] = {};
+	int queued = 0;
+	while ((queued < slots) && ring.PrepSend(conn, ring_buffer[(first + queued) % RING_BUFFER_SLOTS], slotBytes, queued, queued + 1 < slots))
+		queued++;
+
+	int error = 0;
+	for (int seen = 0; seen < queued;)
+	{
+		if (!ring.WaitForCompletions(1000, static_cast<unsigned>(queued - seen)))
+		{
+			errno = EIO;
+			return -1;
+		}
+		while (struct io_uring_cqe *cqe = ring.PeekCompletion())
+		{
+			if (cqe->res > 0)
+				sent[cqe->user_data] = static_cast<size_t>(cqe->res);
+			else if ((cqe->res < 0) && (cqe->res != -ECANCELED) && !error)
+				error = -cqe->res;
+			ring.CompletionSeen();
+			seen++;
+		}
+	}
+	if (error)
+	{
+		errno = error;
+		return -1;
+	}
+
+	ssize_t total = 0;
+	for (int i = 0; i < slots; i++)
+	{
+		const __u8 *slot = reinterpret_cast<const __u8 *>(ring_buffer[(first + i) % RING_BUFFER_SLOTS]);
+		while (sent[i] < slotBytes)
+		{
+			ssize_t more = send(conn, slot + sent[i], slotBytes - sent[i], MSG_NOSIGNAL);
+			if (more < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return -1;
+			}
+			sent[i] += static_cast<size_t>(more);
+		}
+		total += static_cast<ssize_t>(slotBytes);
+	}
+	return total;
+}
+
 void *log_main(void *arg)
 {
 	AdcLoggerTerminate = false;
@@ -40,6 +100,12 @@ void *log_main(void *arg)
 	int conn = *(int *)arg;
 	int ring_read_index = 0;
 
+	// the ring's recv buffers go unused here; Open() wants at least one
+	TIoUring ring;
+	bool bRing = bAdcUseIoUring && ring.Open(AdcUringBatch, 1, 64);
+	if (bAdcUseIoUring)
+		Log(std::string("ADC streaming using ") + (bRing ? "io_uring" : "send(), as io_uring isn't available"));
+
 	while (!AdcLoggerTerminate)
 	{
 		clock_gettime(CLOCK_REALTIME, &AdcLogTimeout);
@@ -52,8 +118,14 @@ void *log_main(void *arg)
 			break;
 		}
 
+		// io_uring: this slot and every other one already full go out together
+		int slots = 1;
+		while (bRing && (slots < AdcUringBatch) && (sem_trywait(&full) == 0))
+			slots++;
+
 		pthread_mutex_lock(&mutex);
-		ssize_t sent = send(conn, ring_buffer[ring_read_index], (sizeof(uint32_t) * SAMPLES_PER_TRANSFER), MSG_NOSIGNAL);
+		ssize_t sent = bRing ? SendAdcSlotsUring(ring, conn, ring_read_index, slots)
+							 : send(conn, ring_buffer[ring_read_index], (sizeof(uint32_t) * SAMPLES_PER_TRANSFER), MSG_NOSIGNAL);
 		pthread_mutex_unlock(&mutex);
 
 		if (sent < 0 && errno == EPIPE)
@@ -63,11 +135,18 @@ void *log_main(void *arg)
 			AdcLoggerTerminate = true;
 			continue;
 		}
+		if (sent < 0 && bRing && errno == EIO)
+		{
+			Error("io_uring failed; ADC streaming falls back to send()");
+			ring.Close(); // cancels what it still had
+			bRing = false;
+		}
 
-		sem_post(&empty);
+		for (int i = 0; i < slots; i++)
+			sem_post(&empty);
 		Trace("Sent ADC Data " + std::to_string(sent) + " bytes, on ConnectionID: " + std::to_string(conn));
 
-		ring_read_index++;
+		ring_read_index += slots;
 		ring_read_index %= RING_BUFFER_SLOTS;
 	};
 
@@ -162,7 +241,7 @@ void *worker_main(void *arg)
 		Error(e.what());
 	}
 	Debug("Setting AdcStreamingConnection to idle");
-	apci_write8(apci, 1, BAR_REGISTER, 0x12, 0); // turn off ADC start modes
+	out(ofsAdcTriggerOptions, 0); // turn off ADC start modes; through out() so the shadow sees it
 
 	AdcLoggerTerminate = 1;
 	sem_post(&full); // wake logger if it’s waiting
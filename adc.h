@@ -8,4 +8,5 @@ void *worker_main(void *arg);
 extern pthread_t worker_thread;
 extern pthread_t AdcLogger_thread;
 extern int AdcStreamingConnection;
-extern int AdcWorkerThreadID;
\ No newline at end of file
+extern int AdcWorkerThreadID;
+extern bool bAdcUseIoUring;
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+/*
+admission.h
+
+TAdmission: how much work the Control run-loop has let into the action pipeline, and what it has turned away.
+
+	Every Message the run-loop frames is Admit()ted (counted, with its size in bytes) before it goes on the ActionQueue,
+	and Release()d when its reply is queued.  Once either budget (MaxQueued Messages, MaxQueuedBytes) would be passed,
+	Admit() says no and the run-loop answers the Message with an 'E' carrying SYS_Error ERR_BUSY instead of queueing
+	it: a client gets a prompt "back off" rather than a reply that comes seconds later, or not at all before its own
+	timeout.  The budgets come from AIOENET_MAX_QUEUED / AIOENET_MAX_QUEUED_BYTES; SYS_Admission reads the counters.
+
+	Admit() is the Control run-loop's alone (one thread, so it never overshoots); Release() and the getters may be
+	called from any thread.
+*/
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics below must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <linux/types.h>
+
+#define AdmissionMaxQueued 512            // default budget: Messages queued or running, all clients together
+#define AdmissionMaxQueuedBytes (4 << 20) // default budget: their encoded size
+
+class TAdmission
+{
+public:
+	enum TShed : __u32 { Admitted = 0, ShedDepth = 1, ShedBytes = 2 }; // what SYS_Error's Info says for ERR_BUSY
+
+	// Control run-loop: counts a Message of `bytes` in, or says which budget it would pass.  One Message bigger than
+	// the whole byte budget still gets in when nothing else is queued
+	TShed Admit(__u32 bytes)
+	{
+		const __u32 bytesNow = queuedBytes.load(std::memory_order_relaxed);
+		if (queued.load(std::memory_order_relaxed) >= maxQueued)
+		{
+			shedDepth.fetch_add(1, std::memory_order_relaxed);
+			return ShedDepth;
+		}
+		if (bytesNow && (static_cast<__u64>(bytesNow) + bytes > maxQueuedBytes))
+		{
+			shedBytes.fetch_add(1, std::memory_order_relaxed);
+			return ShedBytes;
+		}
+		queued.fetch_add(1, std::memory_order_relaxed);
+		queuedBytes.fetch_add(bytes, std::memory_order_relaxed);
+		return Admitted;
+	}
+
+	// any thread: an Admit()ted Message of `bytes` has been answered
+	void Release(__u32 bytes)
+	{
+		queued.fetch_sub(1, std::memory_order_relaxed);
+		queuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+
+	// at startup, before any Admit()
+	void SetLimits(__u32 aMaxQueued, __u32 aMaxQueuedBytes)
+	{
+		maxQueued = aMaxQueued;
+		maxQueuedBytes = aMaxQueuedBytes;
+	}
+
+	__u32 MaxQueued() const { return maxQueued; }
+	__u32 MaxQueuedBytes() const { return maxQueuedBytes; }
+	__u32 Queued() const { return queued.load(std::memory_order_relaxed); }
+	__u32 QueuedBytes() const { return queuedBytes.load(std::memory_order_relaxed); }
+	__u64 ShedForDepth() const { return shedDepth.load(std::memory_order_relaxed); }
+	__u64 ShedForBytes() const { return shedBytes.load(std::memory_order_relaxed); }
+
+private:
+	__u32 maxQueued = AdmissionMaxQueued;
+	__u32 maxQueuedBytes = AdmissionMaxQueuedBytes;
+	std::atomic<__u32> queued{0};
+	std::atomic<__u32> queuedBytes{0};
+	std::atomic<__u64> shedDepth{0}; // Messages answered busy because MaxQueued were already in
+	std::atomic<__u64> shedBytes{0}; // ...because they would have passed MaxQueuedBytes
+};
+
+extern TAdmission Admission; // the daemon's one; defined in aioenetd.cpp
+
+#pragma pack(pop)
@@ -124,6 +124,8 @@ from discord code-review conversation with Daria; these do not belong in this so
 	Main spawns one action-thread for handling Protocol 2.
 	NOTE: Main might also spawn a singleton receive/action/send thread, or one set per "Streaming" type (ADC in the eNET-AIO case), to handle the streaming Protocol(s).
 	Each Client that connects spawns a receive-thread.
+		NOTE: the per-Client receive-threads have since been replaced by a single epoll loop in the Control listener thread; everything
+		described for "receive-threads" below now happens per-connection inside that loop, see HandleNewControlClients()
 
 	EITHER
 	1	the action-thread is responsible for sending data to the correct client
@@ -167,6 +169,9 @@ from discord code-review conversation with Daria; these do not belong in this so
 		3	added to a single send-thread Queue to be sent asynchronously.
 			NOTE: this means ActionBundles AND SendBundles need a reference to the Client's Socket (the SendBundle just inherits it from the ActionBundle)
 		TBD: once I know more about TCP Sockets and such in Linux I can figure out which is best.
+		DONE: a variant of 2.  Each Control connection has a TSendQueue (sendqueue.h) that the action-thread only ever
+			enqueues into; instead of a send-thread per Client, the Control run-loop that already owns the Client's socket
+			drains it with non-blocking writev()-style sends, so a Client that stops reading can't stall anybody else.
 
 		The send-thread run-loop has now completed one loop, so the TMessage it popped out of the Action Queue goes out of scope and is destroyed.
 	[1. no send-thread exists separate from the action-thread]
@@ -178,6 +183,9 @@ from discord code-review conversation with Daria; these do not belong in this so
 	The single Action Thread serves to serialize device operations, ensuring the Actions dictated in each received Message's payload get executed "atomically",
 	BUT the execution order is determined by the "parsing-finished" time, not by the "Message-received" time; i.e., each Client gets its turn in the order the
 	receive-threads' constructed TMessage gets added to the Action Queue.
+	UPDATE: there are now ActionThreads of them, one per hardware "lane" (ADC, DAC, DIO, Config; see TLanes).  A Message still runs "atomically": it
+	holds every lane its DataItems use for as long as it runs, so only Messages on disjoint lanes run at the same time.  See [ActionLanes].
+	File I/O (config files, /etc/hostname, uploads) is the FileThread's job, so an fsync() never holds up a hardware lane.
 
 	The Main run-loop should act as a Watchdog, monitoring the various threads to ensure they haven't dead-locked.
 
@@ -190,15 +198,23 @@ from discord code-review conversation with Daria; these do not belong in this so
 #include <arpa/inet.h>
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fcntl.h>
 #include <filesystem>
 #include <netinet/in.h>
+#include <poll.h>
 #include <signal.h>
+#include <sys/epoll.h>
 #include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <cstdlib>
+#include <mutex>
 
 #include "apci.h"
+#include "checksum.h"
 #include "logging.h"
 #include "TMessage.h"
 #include "adc.h"
@@ -210,6 +226,12 @@ from discord code-review conversation with Daria; these do not belong in this so
 #include "DataItems/REG_.h"
 #include "DataItems/TDataItem.h"
 #include "aioenetd.h"
+#include "uring.h"
+#include "admission.h"
+#include "coalesce.h"
+#include "snapshot.h"
+#include "rmw.h"
+#include "shadow.h"
 // #define MG_ARCH MG_ARCH_NEWLIB
 // extern "C" {
 // #include "mongoose.h"
@@ -219,16 +241,27 @@ from discord code-review conversation with Daria; these do not belong in this so
 
 int apci = -1;
 volatile sig_atomic_t done = 0;
+TAdmission Admission;
 
 static int ControlListenPort = 18767; // 0x494f, ASCII for "IO"
+static const int ControlMaxEpollEvents = 64; // events handled per epoll_wait() in the Control run-loop
+static bool bControlUseIoUring = false;        // AIOENET_IO_BACKEND=io_uring; falls back to epoll if the kernel can't
+static bool bMapRegisters = false;             // AIOENET_REGISTER_ACCESS=mmap; falls back to ioctls if the BAR can't be mapped
+static const unsigned ControlUringEntries = 256;
+static const unsigned ControlUringBuffers = 64;       // power of 2; shared by every Control connection
+static const unsigned ControlUringBufferSize = 16384;
+static const size_t ControlSendQueueLimit = 1 << 20; // unsent reply bytes per Control client before it is dropped
+static std::unordered_map<std::string, unsigned> ClientWeights; // AIOENET_CLIENT_WEIGHTS, by peer address; see ClientWeight()
+static std::unordered_set<std::string> SupersedeClients;        // AIOENET_SUPERSEDE, by peer address; see ClientSupersedes()
 
 int AdcListenPort = ControlListenPort + 1;
 
-pthread_t action_thread;
+pthread_t action_threads[ActionThreads];
+pthread_t file_thread;
 pthread_t controlListener_thread;
 pthread_t adcListener_thread;
 
-enum class SysErrStage : __u32 { Parse = 1, Execute = 2 };
+enum class SysErrStage : __u32 { Parse = 1, Execute = 2, Admit = 3 };
 
 static inline __u32 ErrIndex(TError rc) { return static_cast<__u32>(-rc); }
 
@@ -288,7 +321,9 @@ int main(int argc, char *argv[])
 	ApplyConfig();
 	OpenDevFile(); // sets apci
 
-	pthread_create(&action_thread, NULL, (void *(*)(void *)) & ActionThread, &ActionQueue);
+	for (pthread_t &action_thread : action_threads)
+		pthread_create(&action_thread, NULL, (void *(*)(void *)) & ActionThread, &ActionQueue);
+	pthread_create(&file_thread, NULL, FileThread, NULL);
 	pthread_create(&controlListener_thread, NULL, ControlListenerThread, (void *)AF_INET6);
 	pthread_create(&adcListener_thread, NULL, AdcListenerThread, (void *)AF_INET6);
 
@@ -348,7 +383,9 @@ void exit_handler(int s)
 
 	pthread_join(adcListener_thread, NULL);
 	pthread_join(controlListener_thread, NULL);
-	pthread_join(action_thread, NULL);
+	for (pthread_t &action_thread : action_threads)
+		pthread_join(action_thread, NULL);
+	pthread_join(file_thread, NULL); // any config writes it didn't get to, SaveConfig() below covers
 
 	/* put the card back in the power-up state */
 	out(ofsReset, bmResetEverything);
@@ -388,6 +425,7 @@ void Intro(int argc, char **argv)
 
 	std::time_t start_time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 	Log("AIOeNET Daemon " VersionString " STARTING, it is now: " + std::string(std::ctime(&start_time)));
+	Debug("Message checksum kernel: " + std::string(ChecksumKernelName()));
 
 	struct sigaction sigIntHandler;
 	sigIntHandler.sa_handler = abort_handler;
@@ -407,6 +445,115 @@ void Intro(int argc, char **argv)
 		sscanf(argv[1], "%d", &ControlListenPort);
 
 	Trace("Control port: " + std::to_string(ControlListenPort));
+
+	const char *backend = std::getenv("AIOENET_IO_BACKEND");
+	if (backend)
+	{
+		std::string be = backend;
+		std::transform(be.begin(), be.end(), be.begin(), ::tolower);
+		bControlUseIoUring = (be == "io_uring") || (be == "uring");
+		bAdcUseIoUring = bControlUseIoUring;
+		Log("AIOENET_IO_BACKEND='" + be + "', Control connections will use " + (bControlUseIoUring ? "io_uring" : "epoll") +
+			", ADC streams " + (bAdcUseIoUring ? "io_uring" : "send()"));
+	}
+
+	const char *access = std::getenv("AIOENET_REGISTER_ACCESS");
+	if (access)
+	{
+		std::string ra = access;
+		std::transform(ra.begin(), ra.end(), ra.begin(), ::tolower);
+		bMapRegisters = (ra == "mmap");
+		if (!bMapRegisters && (ra != "ioctl"))
+			Warn("AIOENET_REGISTER_ACCESS='" + ra + "' isn't mmap or ioctl; using ioctl");
+		Log("AIOENET_REGISTER_ACCESS='" + ra + "', registers will be accessed through " + (bMapRegisters ? "a mapping of the BAR" : "ioctls"));
+	}
+
+	// the register shadow (see shadow.h) is on unless AIOENET_REGISTER_SHADOW=off
+	if (const char *shadow = std::getenv("AIOENET_REGISTER_SHADOW"))
+	{
+		std::string rs = shadow;
+		std::transform(rs.begin(), rs.end(), rs.begin(), ::tolower);
+		if ((rs != "on") && (rs != "off"))
+			Warn("AIOENET_REGISTER_SHADOW='" + rs + "' isn't on or off; leaving it on");
+		Shadow.SetEnabled(rs != "off");
+		Log("AIOENET_REGISTER_SHADOW='" + rs + "', register shadow " + (Shadow.Enabled() ? "on" : "off"));
+	}
+
+	// "addr=weight[,addr=weight...]": a client connecting from addr gets `weight` shares of the ActionThreads (default 1)
+	const char *weights = std::getenv("AIOENET_CLIENT_WEIGHTS");
+	if (weights)
+	{
+		std::string list = weights;
+		for (size_t start = 0; start < list.size();)
+		{
+			size_t end = list.find(',', start);
+			if (end == std::string::npos)
+				end = list.size();
+			const std::string pair = list.substr(start, end - start);
+			start = end + 1;
+			const size_t eq = pair.find('=');
+			const unsigned long weight = (eq != std::string::npos) ? std::strtoul(pair.c_str() + eq + 1, nullptr, 10) : 0;
+			if ((eq == 0) || (weight < 1) || (weight > ClientMaxWeight))
+			{
+				Warn("AIOENET_CLIENT_WEIGHTS: ignoring '" + pair + "'; expected addr=weight, weight 1.." + std::to_string(ClientMaxWeight));
+				continue;
+			}
+			ClientWeights[pair.substr(0, eq)] = static_cast<unsigned>(weight);
+			Log("AIOENET_CLIENT_WEIGHTS: Control clients from " + pair.substr(0, eq) + " get weight " + std::to_string(weight));
+		}
+	}
+
+	// "addr[,addr...]", or "*" for everybody: a client connecting from addr lets a newer write to a DAC channel or the DIO
+	// outputs supersede one still queued (see SupersedeMessage())
+	if (const char *supersede = std::getenv("AIOENET_SUPERSEDE"))
+	{
+		std::string list = supersede;
+		for (size_t start = 0; start < list.size();)
+		{
+			size_t end = list.find(',', start);
+			if (end == std::string::npos)
+				end = list.size();
+			const std::string address = list.substr(start, end - start);
+			start = end + 1;
+			if (address.empty())
+				continue;
+			SupersedeClients.insert(address);
+			Log("AIOENET_SUPERSEDE: Control clients from " + address + " get last-writer-wins output writes");
+		}
+	}
+
+	// admission control's budgets (see admission.h); Messages past either one are answered ERR_BUSY
+	unsigned long maxQueued = AdmissionMaxQueued;
+	unsigned long maxQueuedBytes = AdmissionMaxQueuedBytes;
+	if (const char *depth = std::getenv("AIOENET_MAX_QUEUED"))
+		maxQueued = std::strtoul(depth, nullptr, 0);
+	if (const char *bytes = std::getenv("AIOENET_MAX_QUEUED_BYTES"))
+		maxQueuedBytes = std::strtoul(bytes, nullptr, 0);
+	if ((maxQueued < 1) || (maxQueued > ActionQueueDepth / 2))
+	{
+		Warn("AIOENET_MAX_QUEUED must be 1.." + std::to_string(ActionQueueDepth / 2) + "; using " + std::to_string(AdmissionMaxQueued));
+		maxQueued = AdmissionMaxQueued;
+	}
+	if ((maxQueuedBytes < 1) || (maxQueuedBytes > UINT32_MAX / 2))
+	{
+		Warn("AIOENET_MAX_QUEUED_BYTES out of range; using " + std::to_string(AdmissionMaxQueuedBytes));
+		maxQueuedBytes = AdmissionMaxQueuedBytes;
+	}
+	Admission.SetLimits(static_cast<__u32>(maxQueued), static_cast<__u32>(maxQueuedBytes));
+	Debug("Admission budget: " + std::to_string(maxQueued) + " Messages, " + std::to_string(maxQueuedBytes) + " bytes");
+
+	// how old a shared read may be for a Message that arrived after it started (see coalesce.h)
+	if (const char *window = std::getenv("AIOENET_COALESCE_US"))
+	{
+		const unsigned long us = std::strtoul(window, nullptr, 0);
+		if (us > CoalesceMaxWindowUs)
+			Warn("AIOENET_COALESCE_US must be 0.." + std::to_string(CoalesceMaxWindowUs) + "; using 0");
+		else
+		{
+			Coalescer.SetWindow(static_cast<__u32>(us));
+			Log("AIOENET_COALESCE_US: identical reads are shared for up to " + std::to_string(us) + " µs");
+		}
+	}
 }
 
 void OpenDevFile()
@@ -423,6 +570,8 @@ void OpenDevFile()
 		}
 	}
 	Log("Opening device @ " + devicefile);
+	if (bMapRegisters && (apci >= 0) && !apciMapRegisters())
+		Warn("AIOENET_REGISTER_ACCESS=mmap: couldn't map the registers; every access stays an ioctl");
 }
 
 void Bind(int &Socket, int &Port, void *structaddr, int iNET)
@@ -504,6 +653,11 @@ void *ControlListenerThread(void *arg)
 
 	Trace("Listen for Control Socket");
 	Listen(ControlSocket, 32);
+	if (bControlUseIoUring && !HandleNewControlClientsUring(ControlSocket))
+	{
+		Warn("io_uring unavailable for Control connections, falling back to epoll");
+		bControlUseIoUring = false;
+	}
 	for (; done == 0;)
 		HandleNewControlClients(ControlSocket, ControlAddrSize, ControlAddr);
 	ControlClients.clear();
@@ -603,8 +757,10 @@ void *AdcListenerThread(void *arg)
 	return nullptr;
 }
 
-void SendControlHello(int Socket)
+// queues the Hello for a new Control client; the run-loop sends it along with everything else in Client
+void SendControlHello(TSendQueue &Client)
 {
+	const int Socket = Client.Socket();
 	TMessageId MId_Hello = 'H';
 	TPayload Payload;
 	TBytes data{};
@@ -664,59 +820,89 @@ void SendControlHello(int Socket)
 	TMessage HelloControl = TMessage(MId_Hello, Payload);
 
 	TBytes rbuf = HelloControl.AsBytes(true);
-	ssize_t bytesSent = send(Socket, rbuf.data(), rbuf.size(), MSG_NOSIGNAL);
-	if (bytesSent == -1)
+	Log("Queued 'Hello' for Control Client# " + to_hex<__u32>(Socket) + ":\n		  " + HelloControl.AsString() + ", bytes=", rbuf);
+	Client.Enqueue(std::move(rbuf));
+}
+
+// the far end of aSocket as text, and its port; false if getpeername() fails
+static bool PeerAddress(int aSocket, std::string &address, uint16_t &port)
+{
+	struct sockaddr_storage addr; // Can hold IPv4 or IPv6
+	socklen_t addrSize = sizeof(addr);
+
+	if (getpeername(aSocket, reinterpret_cast<struct sockaddr *>(&addr), &addrSize) == -1)
+		return false;
+
+	char ipStr[INET6_ADDRSTRLEN] = {0}; // Enough space for IPv6 text
+	port = 0;
+
+	if (addr.ss_family == AF_INET) // IPv4
 	{
-		Error("! TCP Send of Control Hello appears to have failed, bytesSent != Message Length (" + std::to_string(bytesSent) + " != " + std::to_string(rbuf.size()) + ")");
-		// handle xmit error
+		auto *v4 = reinterpret_cast<struct sockaddr_in *>(&addr);
+		inet_ntop(AF_INET, &(v4->sin_addr), ipStr, sizeof(ipStr));
+		port = ntohs(v4->sin_port);
+	}
+	else if (addr.ss_family == AF_INET6) // IPv6
+	{
+		auto *v6 = reinterpret_cast<struct sockaddr_in6 *>(&addr);
+		inet_ntop(AF_INET6, &(v6->sin6_addr), ipStr, sizeof(ipStr));
+		port = ntohs(v6->sin6_port);
 	}
 	else
 	{
-		Log("Sent 'Hello' to Control Client# " + to_hex<__u32>(Socket) + ":\n		  " + HelloControl.AsString() + ", bytes=", rbuf);
+		// Some other address family?
+		strncpy(ipStr, "UnknownAF", sizeof(ipStr));
+		port = 0;
 	}
+	address = ipStr;
+	return true;
 }
 
-void Disconnect(int aClient)
+// "IP: <addr>, Port <port>" of the far end of aSocket, or "" if getpeername() fails
+std::string PeerToString(int aSocket)
 {
-	struct sockaddr_storage addr; // Can hold IPv4 or IPv6
-	socklen_t addrSize = sizeof(addr);
-
-	if (getpeername(aClient, reinterpret_cast<struct sockaddr *>(&addr), &addrSize) == -1)
-		Error("getpeername() failed");
-	else
+	std::string address;
+	uint16_t port = 0;
+	if (!PeerAddress(aSocket, address, port))
 	{
-		char ipStr[INET6_ADDRSTRLEN] = {0}; // Enough space for IPv6 text
-		uint16_t port = 0;
+		Error("getpeername() failed");
+		return "";
+	}
+	return "IP: " + address + ", Port " + std::to_string(port);
+}
 
-		if (addr.ss_family == AF_INET) // IPv4
-		{
-			auto *v4 = reinterpret_cast<struct sockaddr_in *>(&addr);
-			inet_ntop(AF_INET, &(v4->sin_addr), ipStr, sizeof(ipStr));
-			port = ntohs(v4->sin_port);
-		}
-		else if (addr.ss_family == AF_INET6) // IPv6
-		{
-			auto *v6 = reinterpret_cast<struct sockaddr_in6 *>(&addr);
-			inet_ntop(AF_INET6, &(v6->sin6_addr), ipStr, sizeof(ipStr));
-			port = ntohs(v6->sin6_port);
-		}
-		else
-		{
-			// Some other address family?
-			strncpy(ipStr, "UnknownAF", sizeof(ipStr));
-			port = 0;
-		}
+// aSocket's AIOENET_CLIENT_WEIGHTS weight; an IPv4 client on a dual-stack socket shows up as ::ffff:a.b.c.d, and
+// matches either spelling
+static unsigned ClientWeight(int aSocket)
+{
+	std::string address;
+	uint16_t port;
+	if (ClientWeights.empty() || !PeerAddress(aSocket, address, port))
+		return 1;
+	auto found = ClientWeights.find(address);
+	if ((found == ClientWeights.end()) && (address.rfind("::ffff:", 0) == 0))
+		found = ClientWeights.find(address.substr(7));
+	return (found != ClientWeights.end()) ? found->second : 1;
+}
 
-		Log("Host " + to_hex<__u32>(aClient) + " disconnected; IP: " + ipStr + ", Port " + std::to_string(port));
-	}
-	close(aClient);
+// whether AIOENET_SUPERSEDE lists aSocket's peer; either spelling of an IPv4 address matches, as for ClientWeight()
+static bool ClientSupersedes(int aSocket)
+{
+	std::string address;
+	uint16_t port;
+	if (SupersedeClients.count("*"))
+		return true;
+	if (SupersedeClients.empty() || !PeerAddress(aSocket, address, port))
+		return false;
+	return SupersedeClients.count(address) || ((address.rfind("::ffff:", 0) == 0) && SupersedeClients.count(address.substr(7)));
+}
 
-	// // Remove from list
-	// auto it = std::find(ClientList.begin(), ClientList.end(), aClient);
-	// if (it != ClientList.end())
-	//     ClientList.erase(it);
-	// else
-	//     Error("INTERNAL ERROR: Attempted to remove socket not in ClientList");
+void Disconnect(int aClient)
+{
+	std::string peer = PeerToString(aClient);
+	if (!peer.empty())
+		Log("Host " + to_hex<__u32>(aClient) + " disconnected; " + peer);
+	close(aClient);
 }
 
 static bool TryParseGuardWhat(const char *what, __u32 &errIndex, __u32 &info)
@@ -814,14 +1000,14 @@ static PTDataItemBase BuildSysItemError(__u16 itemIndex, DataItemIds originalDid
 // }
 
 
-ssize_t ReceiveFromSocket(int aSocket, std::vector<char> &buffer)
+// recv()s straight into the deframer's buffer; no intermediate copy
+ssize_t ReceiveFromSocket(int aSocket, TDeframer &deframer)
 {
-	char tempBuffer[65536];
-	ssize_t bytesRead = recv(aSocket, tempBuffer, sizeof(tempBuffer), MSG_NOSIGNAL);
+	size_t room = 0;
+	__u8 *into = deframer.WritePtr(room);
+	ssize_t bytesRead = recv(aSocket, into, room, MSG_NOSIGNAL);
 	if (bytesRead > 0)
-	{
-		buffer.insert(buffer.end(), tempBuffer, tempBuffer + bytesRead);
-	}
+		deframer.Commit(static_cast<size_t>(bytesRead));
 	return bytesRead;
 }
 
@@ -832,14 +1018,13 @@ int CheckDisconnect(ssize_t bytesRead, int aSocket)
 	return false;
 }
 
-bool GotMessage(const char *theBuffer, int bytesRead, TMessage &outMessage)
+bool GotMessage(const __u8 *theBuffer, size_t bytesRead, TMessage &outMessage)
 {
 	TError result = ERR_SUCCESS;
-	TBytes buf(theBuffer, theBuffer + bytesRead);
 
 	try
 	{
-		outMessage = TMessage::FromBytes(buf, result);
+		outMessage = TMessage::FromBytes(TByteSpan(theBuffer, bytesRead), result);
 	}
 	catch (const std::logic_error &e)
 	{
@@ -849,40 +1034,221 @@ bool GotMessage(const char *theBuffer, int bytesRead, TMessage &outMessage)
 
 		TMessage x('X');
 		if (PTDataItemBase di = BuildSysError(SysErrStage::Parse, errIndex, info, e.what())) x.addDataItem(di);
-		outMessage = x;
+		outMessage = std::move(x);
 	}
 	return true;
 }
 
-void ProcessMessages(std::vector<char> &buffer, int aSocket)
+// an ActionQueue item with an empty arena and Message for Connection; reuses one the ActionThread sent back if there is
+// one (Control thread only: it is SpareActionQueueItems' one consumer)
+static PTActionQueueItem NewActionQueueItem(const TControlConnection &Connection)
 {
-	for (;;)
+	PTActionQueueItem item = SpareActionQueueItems.tryDequeue();
+	if (!item)
+		item.reset(new TActionQueueItem{nullptr, false, LaneNone, 0, 1, 0, {}, {}, -1, 0, {}, std::make_unique<TMessageArena>(), nullptr});
+	item->Client = Connection.sendQueue;
+	item->bCloseAfter = false;
+	item->Lanes = LaneNone;
+	item->Cost = 0;
+	item->Weight = Connection.weight;
+	item->Bytes = 0;
+	item->Received = {};
+	item->Deadline = {};
+	item->Output = -1;
+	item->OutputNumber = 0;
+	item->theMessage = std::make_unique<TMessage>();
+	return item;
+}
+
+// ActionThread: finished with anAction; destroys its Message and hands the item and its arena back for reuse
+static void RecycleActionQueueItem(PTActionQueueItem anAction)
+{
+	anAction->theMessage.reset(); // before the arena its DataItems live in
+	anAction->Client.reset();     // a spare item mustn't keep a closed connection's send queue alive
+	anAction->ConfigWrites.clear();
+	if (!anAction->Arena)
+		return; // 'X' replies never had an arena; not worth keeping
+	anAction->Arena->Reset();
+	SpareActionQueueItems.tryEnqueue(anAction); // no room: anAction is freed on return
+}
+
+// every lane aMessage's DataItems use (see TLanes), and what they cost together (see TCost); a DId DIdDict doesn't
+// know takes every lane.  Never free: the round robin needs every Message to use up some of its client's deficit
+static TLanes MessageLanes(const TMessage &aMessage, __u32 &cost)
+{
+	TLanes lanes = LaneNone;
+	cost = 0;
+	for (const PTDataItemBase &item : aMessage.DataItems)
+	{
+		if (!item)
+			continue;
+		const TDIdDictEntry *entry = DIdDict.find(item->getDId());
+		lanes |= (entry != DIdDict.end()) ? entry->lanes : static_cast<TLanes>(LaneAll);
+		cost += (entry != DIdDict.end()) ? entry->cost : CostDefault;
+	}
+	cost = std::max<__u32>(cost, CostDefault);
+	return lanes;
+}
+
+// the TSendQueue output (SendQueueOutputs) aMessage writes, when that write is all it does: a 'C' or 'M' of one
+// DIO_Output, DAC_Output1 or DAC_Output1V.  -1 for anything else
+static int LoneOutputWrite(TMessage &aMessage)
+{
+	const TMessageId mid = aMessage.getMId();
+	if (((mid != 'C') && (mid != 'M')) || (aMessage.DataItems.size() != 1) || !aMessage.DataItems[0])
+		return -1;
+	const TDataItemBase &item = *aMessage.DataItems[0];
+	switch (item.getDId())
+	{
+	case DataItemIds::DIO_Output:
+		return 0;
+	case DataItemIds::DAC_Output1:
+	case DataItemIds::DAC_Output1V:
+	{
+		const unsigned channel = static_cast<const TDataItem<DAC_OutputParams> &>(item).params.dacChannel;
+		return (channel < SendQueueOutputs - 1) ? static_cast<int>(1 + channel) : -1;
+	}
+	default:
+		return -1;
+	}
+}
+
+// answers a Message Admission turned away with 'E' + SYS_Error(Admission stage, ERR_BUSY, Info = which budget).  Straight
+// into the send queue when the client is waiting on nothing else; otherwise through the ActionQueue, as a ready-made
+// reply that costs no lane and goes out as soon as the client's earlier replies have (they must arrive in order)
+static void RefuseMessage(TControlConnection &Connection, TAdmission::TShed shed)
+{
+	// at most one warning a second; a client hammering a full queue would otherwise log every Message
+	static std::chrono::steady_clock::time_point lastWarned;
+	static __u64 shedWhenWarned = 0;
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastWarned >= std::chrono::seconds(1))
+	{
+		const __u64 shedNow = Admission.ShedForDepth() + Admission.ShedForBytes();
+		Warn("Admission: " + std::string((shed == TAdmission::ShedDepth) ? "Message" : "byte") + " budget full (" +
+			 std::to_string(Admission.Queued()) + " Messages, " + std::to_string(Admission.QueuedBytes()) + " bytes queued); " +
+			 std::to_string(shedNow - shedWhenWarned) + " Messages answered busy since the last warning");
+		lastWarned = now;
+		shedWhenWarned = shedNow;
+	}
+	auto busy = std::make_unique<TMessage>('E');
+	if (PTDataItemBase di = BuildSysError(SysErrStage::Admit, ErrIndex(ERR_BUSY), shed, "")) busy->addDataItem(di);
+	if (Connection.sendQueue->Outstanding() == 0)
 	{
-		if (buffer.size() < (sizeof(TMessageId) + sizeof(TMessagePayloadSize))) return;
+		TBytes rbuf = Connection.sendQueue->Buffer();
+		busy->AsBytes(rbuf, true);
+		Connection.sendQueue->Enqueue(std::move(rbuf));
+		return;
+	}
+	Connection.sendQueue->Asked();
+	ActionQueue.enqueue(PTActionQueueItem(new TActionQueueItem{Connection.sendQueue, false, LaneNone, CostDefault, Connection.weight, 0, {}, {}, -1, 0, {}, nullptr, std::move(busy)}));
+}
 
-		__u32 payloadLenLe = 0;
-		std::memcpy(&payloadLenLe, buffer.data() + 1, sizeof(payloadLenLe));
-		__u32 payloadLen = le32toh(payloadLenLe);
+// a 'Q' that starts with SYS_MaxAge, from a client waiting on nothing else: answers it from the Snapshot (see snapshot.h)
+// right here if it can, and returns true; false if it must go through the ActionQueue like any other Message
+static bool AnswerFromSnapshot(TControlConnection &Connection, const __u8 *frame, size_t frameLen)
+{
+	// cheap tests first; nearly every Message fails one of them
+	const size_t firstDId = sizeof(TMessageId) + sizeof(__u32);
+	if ((frameLen < firstDId + sizeof(TDataItemHeader)) || (frame[0] != 'Q') ||
+		(ReadLE<__u16>(frame + firstDId) != static_cast<__u16>(DataItemIds::SYS_MaxAge)) || Connection.sendQueue->Outstanding())
+		return false;
+
+	TMessage aMessage; // on the heap, not in an arena: this is the run-loop, and a miss is parsed again into its ActionQueue item
+	(void)GotMessage(frame, frameLen, aMessage);
+	if (!Snapshot.Answer(aMessage))
+		return false;
+	TBytes rbuf = Connection.sendQueue->Buffer();
+	aMessage.AsBytes(rbuf, true);
+	Connection.sendQueue->Enqueue(std::move(rbuf));
+	return true;
+}
 
-		if (payloadLen > maxPayloadLength)
+// enqueues every complete TMessage Connection's deframer holds; returns false if the connection must stop reading: its
+// last reply ('X') closes it once sent.  Stops early, leaving the rest in the deframer, once ClientMaxOutstanding of
+// the client's Messages are unanswered or ClientMaxUnsent bytes of its replies unsent: then Connection.bThrottled is
+// set and the run-loop stops reading from it until ResumeControlConnection(), so one client pipelining requests can't
+// fill the ActionQueue for everybody, nor outrun its own replies
+bool ProcessMessages(TControlConnection &Connection)
+{
+	TDeframer &deframer = Connection.deframer;
+	const PTSendQueue &aClient = Connection.sendQueue;
+	const __u8 *frame = nullptr;
+	size_t frameLen = 0;
+	__u32 payloadLen = 0;
+	for (;;)
+	{
+		if ((aClient->Outstanding() >= ClientMaxOutstanding) || (aClient->Unsent() >= ClientMaxUnsent))
 		{
-			TMessage x('X');
-			if (PTDataItemBase di = BuildSysError(SysErrStage::Parse, ErrIndex(ERR_MSG_LEN_MISMATCH), payloadLen, "Payload length exceeds maxPayloadLength")) x.addDataItem(di);
-			ActionQueue.enqueue(new TActionQueueItem{aSocket, x});
-			buffer.clear();
-			Disconnect(aSocket);
-			return;
+			Connection.bThrottled = true;
+			return true;
 		}
+		switch (deframer.Next(frame, frameLen, payloadLen))
+		{
+		case TDeframer::TResult::NeedMore:
+			return true;
 
-		const size_t frameLen = sizeof(TMessageId) + sizeof(TMessagePayloadSize) + payloadLen + sizeof(TCheckSum);
-		if (buffer.size() < frameLen) return;
+		case TDeframer::TResult::Oversize:
+		{
+			PTActionQueueItem item(new TActionQueueItem{aClient, true, LaneNone, CostDefault, Connection.weight, 0, {}, {}, -1, 0, {}, nullptr, std::make_unique<TMessage>('X')});
+			if (PTDataItemBase di = BuildSysError(SysErrStage::Parse, ErrIndex(ERR_MSG_LEN_MISMATCH), payloadLen, "Payload length exceeds maxPayloadLength")) item->theMessage->addDataItem(di);
+			aClient->Asked();
+			ActionQueue.enqueue(std::move(item));
+			deframer.Clear();
+			return false;
+		}
 
-		TMessage *aMessage = new TMessage;
-		(void)GotMessage(buffer.data(), static_cast<int>(frameLen), *aMessage);
-		ActionQueue.enqueue(new TActionQueueItem{aSocket, *aMessage});
+		case TDeframer::TResult::Frame:
+		{
+			if (AnswerFromSnapshot(Connection, frame, frameLen))
+				break;
+			const TAdmission::TShed shed = Admission.Admit(static_cast<__u32>(frameLen));
+			if (shed != TAdmission::Admitted)
+			{
+				RefuseMessage(Connection, shed);
+				break;
+			}
+			PTActionQueueItem item = NewActionQueueItem(Connection);
+			item->Bytes = static_cast<__u32>(frameLen);
+			item->Received = std::chrono::steady_clock::now();
+			if (const __u32 ttl = MessageTtlMs(ReadLE<__u32>(frame + sizeof(TMessageId))))
+				item->Deadline = item->Received + std::chrono::milliseconds(ttl);
+			{
+				TArenaScope scope(*item->Arena);
+				(void)GotMessage(frame, frameLen, *item->theMessage); // moves the parsed Message in; no copy
+			}
+			item->Lanes = MessageLanes(*item->theMessage, item->Cost);
+			// a write with a TTL may yet expire, so it mustn't supersede another; nor, for symmetry, be superseded
+			if (Connection.bSupersede && (item->Deadline == std::chrono::steady_clock::time_point{}) &&
+				((item->Output = LoneOutputWrite(*item->theMessage)) >= 0))
+				item->OutputNumber = aClient->QueueOutput(static_cast<unsigned>(item->Output));
+			aClient->Asked();
+			ActionQueue.enqueue(std::move(item));
+			break;
+		}
+		}
+	}
+}
 
-		buffer.erase(buffer.begin(), buffer.begin() + frameLen);
+// run-loop, after Connection's replies have been flushed: if it was throttled and enough of its Messages have been
+// answered (and its replies sent) since, frames what its deframer already holds and lets it be read again.  true if it was resumed (it may
+// be throttled again, or draining, by the time this returns)
+static bool ResumeControlConnection(TControlConnection &Connection)
+{
+	if (!Connection.bThrottled || Connection.bDraining || Connection.bClosing ||
+		(Connection.sendQueue->Outstanding() > ClientResumeOutstanding) || (Connection.sendQueue->Unsent() > ClientResumeUnsent))
+		return false;
+	Connection.bThrottled = false;
+	try
+	{
+		if (!ProcessMessages(Connection))
+			Connection.bDraining = true; // the 'X' just queued closes the connection once it has been sent
+	}
+	catch (const std::logic_error &e)
+	{
+		Error(e.what());
 	}
+	return true;
 }
 
 
@@ -911,135 +1277,512 @@ void ProcessMessages(std::vector<char> &buffer, int aSocket)
 // 	}
 // }
 
-// J2H: In progress
-void *threadReceiver(void *arg)
+// sends what the ActionThread has queued for Connection, as far as its socket allows; false once the connection is
+// finished (its close-after reply has gone out, or it was dropped) and should be closed
+static bool FlushControlConnection(TControlConnection &Connection)
 {
-	int controlSocket = static_cast<int>((__u64)arg);
-	struct sockaddr_storage addr; // Can hold IPv4 or IPv6
-	socklen_t addrSize = sizeof(addr);
-
-	if (getpeername(controlSocket, reinterpret_cast<struct sockaddr *>(&addr), &addrSize) == -1)
-		Error("getpeername() failed");
-	else
+	switch (Connection.sendQueue->Flush())
 	{
-		char ipStr[INET6_ADDRSTRLEN] = {0}; // Enough space for IPv6 text
-		uint16_t port = 0;
+	case TSendQueue::TResult::Empty:
+		Connection.bWantWrite = false;
+		return true;
+	case TSendQueue::TResult::Blocked:
+		Connection.bWantWrite = true;
+		return true;
+	case TSendQueue::TResult::Close:
+	case TSendQueue::TResult::Drop:
+		break;
+	}
+	return false;
+}
 
-		if (addr.ss_family == AF_INET) // IPv4
-		{
-			auto *v4 = reinterpret_cast<struct sockaddr_in *>(&addr);
-			inet_ntop(AF_INET, &(v4->sin_addr), ipStr, sizeof(ipStr));
-			port = ntohs(v4->sin_port);
-		}
-		else if (addr.ss_family == AF_INET6) // IPv6
+// accept every pending Control connection, queue its Hello, and add it to the epoll set
+static void AcceptControlClients(int epfd, int ControlListenSocket, TControlConnections &Connections)
+{
+	for (;;)
+	{
+		sockaddr_storage socka;
+		socklen_t sockl = sizeof(socka);
+		int new_socket = accept4(ControlListenSocket, (struct sockaddr *)&socka, &sockl, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (new_socket < 0)
 		{
-			auto *v6 = reinterpret_cast<struct sockaddr_in6 *>(&addr);
-			inet_ntop(AF_INET6, &(v6->sin6_addr), ipStr, sizeof(ipStr));
-			port = ntohs(v6->sin6_port);
+			if ((errno != EAGAIN) && (errno != EINTR)) // EAGAIN is EWOULDBLOCK on Linux
+			{
+				Error("accept failed");
+				perror("accept failed");
+			}
+			return; // listen socket is level-triggered; anything left will wake us again
 		}
-		else
+
+		Log("New Control connection, socket fd is: " + to_hex<__u32>(new_socket) + " " + PeerToString(new_socket));
+
+		struct epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.fd = new_socket;
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, new_socket, &ev) < 0)
 		{
-			// Some other address family?
-			strncpy(ipStr, "UnknownAF", sizeof(ipStr));
-			port = 0;
+			Error("epoll_ctl(ADD) failed for Control connection " + to_hex<__u32>(new_socket) + ": " + strerror(errno));
+			Disconnect(new_socket);
+			continue;
 		}
-		Log("New Control connection thread, socket fd is: " + to_hex<__u32>(controlSocket) + " IP: " + ipStr + ", Port " + std::to_string(port));
+		TControlConnection &Connection = Connections[new_socket] = TControlConnection{new_socket, {}, std::make_shared<TSendQueue>(new_socket, ControlSendQueueLimit)};
+		Connection.weight = ClientWeight(new_socket);
+		Connection.bSupersede = ClientSupersedes(new_socket);
+		SendControlHello(*Connection.sendQueue); // sent when the run-loop picks up the send queue's wakeup
 	}
-	SendControlHello(controlSocket);
+}
 
-	std::vector<char> buffer;
+// one recv() worth of bytes from a readable Control connection; returns false if the connection must be dropped
+static bool ReceiveFromControlClient(TControlConnection &Connection)
+{
+	ssize_t bytesRead = ReceiveFromSocket(Connection.Socket, Connection.deframer);
+	if (bytesRead < 0)
+	{
+		if ((errno == EAGAIN) || (errno == EINTR)) // EAGAIN is EWOULDBLOCK on Linux
+			return true;
+		Error("error on Control recv(): " + std::to_string(errno));
+		return false;
+	}
+	if (CheckDisconnect(bytesRead, Connection.Socket))
+		return false;
 
-	while (done == 0)
+	try
 	{
-		ssize_t bytesRead = ReceiveFromSocket(controlSocket, buffer);
-		if (bytesRead < 0)
-		{
-			Error("error on Control recv(): " + std::to_string(errno));
-			break; // error handling? frex "connection closed" or EAGAIN or EINTR?
-		}
-		if (CheckDisconnect(bytesRead, controlSocket))
-		{
-			Disconnect(controlSocket);
-			break;
-		}
+		Trace("control receiver got " + std::to_string(bytesRead) + " bytes");
+		if (!ProcessMessages(Connection))
+			Connection.bDraining = true; // the 'X' just queued closes the connection once it has been sent
+	}
+	catch (const std::logic_error &e)
+	{
+		Error(e.what());
+	}
+	return true;
+}
 
-		try
-		{
-			Trace("control receiver got " + std::to_string(bytesRead) + " bytes");
-			ProcessMessages(buffer, controlSocket);
-		}
-		catch (const std::logic_error &e)
-		{
-			Error(e.what());
-		}
-	};
-	Log("Closing threadReceiver for connection " + to_hex<__u32>(controlSocket));
-	Disconnect(controlSocket);
-	return nullptr;
+// epoll: registers Connection for what it is waiting on now: requests, room to send, or (draining, throttled) neither
+static void UpdateControlEvents(int epfd, TControlConnection &Connection)
+{
+	const __u32 want = ((Connection.bDraining || Connection.bThrottled) ? 0u : static_cast<__u32>(EPOLLIN))
+					 | (Connection.bWantWrite ? static_cast<__u32>(EPOLLOUT) : 0u);
+	if (want == Connection.events)
+		return;
+	struct epoll_event ev = {};
+	ev.events = want;
+	ev.data.fd = Connection.Socket;
+	if (epoll_ctl(epfd, EPOLL_CTL_MOD, Connection.Socket, &ev) < 0)
+		Error("epoll_ctl(MOD) failed for Control connection " + to_hex<__u32>(Connection.Socket) + ": " + strerror(errno));
+	else
+		Connection.events = want;
+}
+
+// the run-loop is done with Connection; anything worth knowing about how its Messages fared
+static void LogControlConnectionStats(const TControlConnection &Connection)
+{
+	if (const unsigned expired = Connection.sendQueue->Expired())
+		Log("Control connection " + to_hex<__u32>(Connection.Socket) + ": " + std::to_string(expired) + " Messages expired before they ran");
+	if (const unsigned superseded = Connection.sendQueue->Superseded())
+		Log("Control connection " + to_hex<__u32>(Connection.Socket) + ": " + std::to_string(superseded) + " output writes superseded before they ran");
+}
+
+static void CloseControlConnection(int epfd, TControlConnections &Connections, TControlConnections::iterator it)
+{
+	LogControlConnectionStats(it->second);
+	it->second.sendQueue->Shut();
+	epoll_ctl(epfd, EPOLL_CTL_DEL, it->first, nullptr);
+	Disconnect(it->first);
+	Connections.erase(it);
 }
 
+// The Control listener's run-loop: a single epoll set holds the listen socket, every Control client, and the send
+// queues' eventfd, so clients cost a file descriptor and a TControlConnection instead of a thread and its stack.
+// Replies are sent from here too (see sendqueue.h); the ActionThread only queues them.
 void HandleNewControlClients(int ControlListenSocket, socklen_t addrSize, sockaddr_storage &addr)
 {
-	int new_socket;
 	Trace("Accept for Control");
 
-	while (!done)
+	int epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd < 0)
 	{
-		fd_set readfds;
-		FD_ZERO(&readfds);
-		FD_SET(ControlListenSocket, &readfds);
+		Error("epoll_create1 failed");
+		perror("epoll_create1 failed");
+		exit(EXIT_FAILURE);
+	}
 
-		// select() needs the highest fd + 1
-		int nfds = ControlListenSocket + 1;
+	fcntl(ControlListenSocket, F_SETFL, fcntl(ControlListenSocket, F_GETFL) | O_NONBLOCK);
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.fd = ControlListenSocket;
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, ControlListenSocket, &ev) < 0)
+	{
+		Error("epoll_ctl(ADD) failed for Control listen socket");
+		perror("epoll_ctl(ADD) failed for Control listen socket");
+		exit(EXIT_FAILURE);
+	}
 
-		// Set a 1-second timeout (adjust to taste)
-		struct timeval tv;
-		tv.tv_sec = 1;
-		tv.tv_usec = 0;
+	const int ReadyFd = SendReadyEventFd();
+	ev.events = EPOLLIN;
+	ev.data.fd = ReadyFd;
+	if ((ReadyFd < 0) || (epoll_ctl(epfd, EPOLL_CTL_ADD, ReadyFd, &ev) < 0))
+	{
+		Error("epoll_ctl(ADD) failed for the Control send queues' eventfd");
+		perror("epoll_ctl(ADD) failed for the Control send queues' eventfd");
+		exit(EXIT_FAILURE);
+	}
 
-		int ret = select(nfds, &readfds, nullptr, nullptr, &tv);
+	TControlConnections Connections;
+	std::vector<PTSendQueue> ready;
+	struct epoll_event events[ControlMaxEpollEvents];
+
+	while (!done)
+	{
+		int ret = epoll_wait(epfd, events, ControlMaxEpollEvents, 1000); // 1-second timeout so we notice `done`
 		if (ret < 0)
 		{
 			if (errno == EINTR)
+				continue;
+			perror("epoll_wait() failed");
+			break;
+		}
+
+		for (int i = 0; i < ret; i++)
+		{
+			int fd = events[i].data.fd;
+			if (fd == ControlListenSocket)
 			{
-				if (done)
-					break;
-				continue; // otherwise just keep going
+				AcceptControlClients(epfd, ControlListenSocket, Connections);
+				continue;
 			}
-			perror("select() failed");
-			break;
+
+			if (fd == ReadyFd)
+			{
+				TakeReadySendQueues(ready);
+				for (PTSendQueue &q : ready)
+				{
+					auto it = Connections.find(q->Socket());
+					if ((it == Connections.end()) || (it->second.sendQueue != q))
+						continue; // closed since the reply was queued
+					if (FlushControlConnection(it->second))
+					{
+						ResumeControlConnection(it->second);
+						UpdateControlEvents(epfd, it->second);
+					}
+					else
+						CloseControlConnection(epfd, Connections, it);
+				}
+				ready.clear();
+				continue;
+			}
+
+			auto it = Connections.find(fd);
+			if (it == Connections.end())
+				continue;
+			TControlConnection &Connection = it->second;
+			const __u32 happened = events[i].events;
+
+			bool keep = true;
+			if (happened & EPOLLOUT)
+				keep = FlushControlConnection(Connection);
+			// EPOLLHUP/EPOLLERR show up here too; recv() reports them as 0 or -1
+			if (keep && (happened & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+				keep = Connection.bDraining ? !(happened & (EPOLLHUP | EPOLLERR)) : ReceiveFromControlClient(Connection);
+
+			if (keep)
+			{
+				ResumeControlConnection(Connection);
+				UpdateControlEvents(epfd, Connection);
+			}
+			else
+				CloseControlConnection(epfd, Connections, it);
 		}
-		else if (ret == 0)
+	}
+
+	for (auto &c : Connections)
+	{
+		c.second.sendQueue->Shut();
+		Disconnect(c.first);
+	}
+	Connections.clear();
+	close(epfd);
+}
+
+#define UringTag(fd, kind) ((static_cast<__u64>(fd) << 8) | (kind))
+enum { UringAccept = 1, UringRecv = 2, UringSend = 3, UringSendReady = 4, UringCancel = 5 };
+
+// io_uring: a throttled connection's multishot recv would keep filling its deframer; cancel it.  Its final CQE
+// (-ECANCELED) then leaves it disarmed until ResumeControlConnectionUring()
+static void ThrottleControlConnectionUring(TIoUring &ring, TControlConnection &Connection)
+{
+	if (!Connection.bThrottled || !Connection.bRecvArmed || Connection.bRecvCancel || Connection.bDraining || Connection.bClosing)
+		return;
+	if (ring.PrepCancel(UringTag(Connection.Socket, UringRecv), UringTag(Connection.Socket, UringCancel)))
+		Connection.bRecvCancel = true;
+	else
+		Warn("io_uring SQ full; Control connection " + to_hex<__u32>(Connection.Socket) + " keeps reading while throttled");
+}
+
+// io_uring: ResumeControlConnection(), re-arming the recv a throttle cancelled; false if the connection should be closed
+static bool ResumeControlConnectionUring(TIoUring &ring, TControlConnection &Connection)
+{
+	if (!ResumeControlConnection(Connection))
+		return true;
+	if (Connection.bDraining)
+	{
+		shutdown(Connection.Socket, SHUT_RD); // as in the recv path: the 'X' just queued closes it once sent
+		return true;
+	}
+	if (Connection.bThrottled)
+	{
+		ThrottleControlConnectionUring(ring, Connection);
+		return true;
+	}
+	if (Connection.bRecvArmed)
+		return true; // still armed, or its cancel's final CQE will re-arm it
+	Connection.bRecvArmed = ring.PrepMultishotRecv(Connection.Socket, UringTag(Connection.Socket, UringRecv));
+	if (!Connection.bRecvArmed)
+		Error("io_uring SQ full; dropping Control connection " + to_hex<__u32>(Connection.Socket));
+	return Connection.bRecvArmed;
+}
+
+// io_uring: submits a sendmsg() of Connection's queued replies, unless one is already outstanding (its CQE comes back
+// here for the rest).  The socket is a blocking one, so the kernel waits for room itself instead of failing with
+// EAGAIN.  false once the connection should be closed
+static bool FlushControlConnectionUring(TIoUring &ring, TControlConnection &Connection)
+{
+	if (Connection.bSendArmed)
+		return !Connection.sendQueue->Dropped();
+	TSendQueue::TResult result;
+	struct msghdr *msg = Connection.sendQueue->StartSend(result);
+	if (!msg)
+		return result == TSendQueue::TResult::Empty;
+	if (!ring.PrepSendMsg(Connection.Socket, msg, UringTag(Connection.Socket, UringSend)))
+	{
+		(void)Connection.sendQueue->Sent(0);
+		Error("io_uring SQ full; dropping Control connection " + to_hex<__u32>(Connection.Socket));
+		return false;
+	}
+	Connection.bSendArmed = true;
+	return true;
+}
+
+// io_uring: done with the connection at `it`.  Its fd is only close()d once no recv or sendmsg is outstanding on it, so
+// a late CQE can't be taken for a new connection that reused the fd (nor a sendmsg read replies that are gone);
+// shutdown() makes those finish promptly, and their final CQEs call this again
+static void CloseControlConnectionUring(TControlConnections &Connections, TControlConnections::iterator it)
+{
+	TControlConnection &Connection = it->second;
+	if (!Connection.bClosing)
+	{
+		Connection.bClosing = true;
+		LogControlConnectionStats(Connection);
+		Connection.sendQueue->Shut();
+		Connection.deframer.Clear();
+		if (Connection.bRecvArmed || Connection.bSendArmed)
+			shutdown(Connection.Socket, SHUT_RDWR);
+	}
+	if (Connection.bRecvArmed || Connection.bSendArmed)
+		return;
+	Disconnect(it->first);
+	Connections.erase(it);
+}
+
+// io_uring flavor of HandleNewControlClients(): one multishot accept plus one multishot recv per client, all fed from
+// the ring's shared provided buffers, so a steady stream of requests costs no syscalls per recv.  Replies go out through
+// the ring as well: a one-shot poll on the send queues' eventfd says when there are some, and each client gets one
+// sendmsg at a time.
+// Returns false if io_uring can't be used here (or fails later); the caller falls back to the epoll run-loop.
+bool HandleNewControlClientsUring(int ControlListenSocket)
+{
+	TIoUring ring;
+	if (!ring.Open(ControlUringEntries, ControlUringBuffers, ControlUringBufferSize))
+		return false;
+	if (!ring.PrepMultishotAccept(ControlListenSocket, UringTag(ControlListenSocket, UringAccept)))
+		return false;
+	const int ReadyFd = SendReadyEventFd();
+	if (ReadyFd < 0)
+		return false;
+
+	Log("Control connections using io_uring");
+	TControlConnections Connections;
+	std::vector<PTSendQueue> ready;
+	bool bAcceptWorks = false;
+	bool bAcceptArmed = true;
+	bool bReadyArmed = false;
+	bool bOk = true;
+
+	while (!done && bOk)
+	{
+		if (!bAcceptArmed) // the SQ was full when it needed re-arming; try again now the last batch has gone in
+			bAcceptArmed = ring.PrepMultishotAccept(ControlListenSocket, UringTag(ControlListenSocket, UringAccept));
+		if (!bReadyArmed) // one-shot; re-armed each time it fires
+			bReadyArmed = ring.PrepPoll(ReadyFd, POLLIN, UringTag(ReadyFd, UringSendReady));
+		if (!ring.WaitForCompletions(1000)) // 1-second timeout so we notice `done`
 		{
-			// Timeout expired, no sockets ready
-			if (done)
-				break; // see if we should exit
-			// else just continue polling
-			continue;
+			bOk = false;
+			break;
 		}
 
-		// If we get here, ret > 0, meaning 'listenSock' is readable
-		// => accept() should not block
-		if (FD_ISSET(ControlListenSocket, &readfds))
+		while (struct io_uring_cqe *cqe = ring.PeekCompletion())
 		{
-			sockaddr_storage socka;
-			socklen_t sockl = sizeof(socka);
-			if ((new_socket = accept(ControlListenSocket, (struct sockaddr *)&socka, &addrSize)) < 0)
+			int fd = static_cast<int>(cqe->user_data >> 8);
+			int kind = static_cast<int>(cqe->user_data & 0xFF);
+			int res = cqe->res;
+			__u32 flags = cqe->flags;
+			ring.CompletionSeen();
+
+			if (kind == UringAccept)
 			{
-				Error("accept failed");
-				perror("accept failed");
+				if (res >= 0)
+				{
+					bAcceptWorks = true;
+					Log("New Control connection, socket fd is: " + to_hex<__u32>(res) + " " + PeerToString(res));
+					TControlConnection &Connection = Connections[res] = TControlConnection{res, {}, std::make_shared<TSendQueue>(res, ControlSendQueueLimit)};
+					Connection.weight = ClientWeight(res);
+					Connection.bSupersede = ClientSupersedes(res);
+					SendControlHello(*Connection.sendQueue);
+					Connection.bRecvArmed = ring.PrepMultishotRecv(res, UringTag(res, UringRecv));
+					if (!Connection.bRecvArmed)
+					{
+						Error("io_uring SQ full; dropping Control connection " + to_hex<__u32>(res));
+						CloseControlConnectionUring(Connections, Connections.find(res));
+					}
+				}
+				else if ((res == -EINVAL) && !bAcceptWorks)
+				{
+					Warn("io_uring multishot accept not supported");
+					bOk = false;
+					break;
+				}
+				else
+					Error("io_uring accept failed: " + std::string(strerror(-res)));
+
+				if (!(flags & IORING_CQE_F_MORE))
+				{
+					bAcceptArmed = ring.PrepMultishotAccept(ControlListenSocket, UringTag(ControlListenSocket, UringAccept));
+					if (!bAcceptArmed)
+						Warn("io_uring SQ full; re-arming the Control accept on the next pass");
+				}
+				continue;
+			}
+
+			if (kind == UringSendReady)
+			{
+				bReadyArmed = false;
+				TakeReadySendQueues(ready);
+				for (PTSendQueue &q : ready)
+				{
+					auto it = Connections.find(q->Socket());
+					if ((it == Connections.end()) || (it->second.sendQueue != q) || it->second.bClosing)
+						continue; // closed since the reply was queued
+					if (!FlushControlConnectionUring(ring, it->second) || !ResumeControlConnectionUring(ring, it->second))
+						CloseControlConnectionUring(Connections, it);
+				}
+				ready.clear();
+				continue;
+			}
+
+			auto it = Connections.find(fd);
+			if (kind == UringSend)
+			{
+				if (it == Connections.end())
+					continue;
+				it->second.bSendArmed = false;
+				if (!it->second.sendQueue->Sent(res) || it->second.bClosing || !FlushControlConnectionUring(ring, it->second) ||
+					!ResumeControlConnectionUring(ring, it->second))
+					CloseControlConnectionUring(Connections, it);
+				continue;
+			}
+			if (kind == UringCancel)
+				continue; // how the recv it cancelled ended is what matters, and that comes as the recv's own CQE
+
+			__u16 bid = static_cast<__u16>(flags >> IORING_CQE_BUFFER_SHIFT);
+			if (it == Connections.end())
+			{
+				if (flags & IORING_CQE_F_BUFFER)
+					ring.RecycleBuffer(bid);
+				continue;
+			}
+			TControlConnection &Connection = it->second;
+
+			if (res > 0)
+			{
+				if (!Connection.bClosing && !Connection.bDraining)
+				{
+					Connection.deframer.Append(ring.Buffer(bid), static_cast<size_t>(res));
+					bool keep = true;
+					try
+					{
+						Trace("control receiver got " + std::to_string(res) + " bytes");
+						keep = ProcessMessages(Connection);
+					}
+					catch (const std::logic_error &e)
+					{
+						Error(e.what());
+					}
+					if (!keep)
+					{
+						// stop reading: shutdown() ends the recv, and the 'X' just queued closes the connection once sent
+						Connection.bDraining = true;
+						shutdown(fd, SHUT_RD);
+					}
+					else if (flags & IORING_CQE_F_MORE)
+						ThrottleControlConnectionUring(ring, Connection);
+				}
+				ring.RecycleBuffer(bid);
+			}
+
+			if (flags & IORING_CQE_F_MORE)
 				continue;
+
+			// this connection's multishot recv has ended: re-arm it unless it ended because the client is gone.  A
+			// throttled one stays disarmed; ResumeControlConnectionUring() re-arms it
+			const bool bCancelled = (res == -ECANCELED) && Connection.bRecvCancel;
+			Connection.bRecvCancel = false;
+			if (!Connection.bClosing && !Connection.bDraining && ((res > 0) || (res == -ENOBUFS) || bCancelled))
+			{
+				if (Connection.bThrottled)
+				{
+					Connection.bRecvArmed = false;
+					continue;
+				}
+				if (ring.PrepMultishotRecv(fd, UringTag(fd, UringRecv)))
+					continue;
 			}
-			pthread_t receive_thread;
-			Log("New Control connection, socket fd is: " + to_hex<__u32>(new_socket));
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
-			pthread_create(&receive_thread, NULL, &threadReceiver, (void *)new_socket); // spawn Control Read thread here, pass in new_socket
-			pthread_detach(receive_thread);
-#pragma GCC diagnostic pop
+
+			Connection.bRecvArmed = false;
+			if (Connection.bDraining && !Connection.bClosing)
+				continue; // still waiting for its 'X' to go out
+			if ((res < 0) && !Connection.bClosing)
+				Error("error on Control recv(): " + std::to_string(-res));
+			CloseControlConnectionUring(Connections, it);
 		}
 	}
-	// ReceiverThreadQueue.enqueue(receive_thread);
+
+	// an outstanding sendmsg reads its client's replies, which go with the send queues; end those first
+	auto sending = [&Connections] { return std::any_of(Connections.begin(), Connections.end(), [](const auto &c) { return c.second.bSendArmed; }); };
+	for (auto &c : Connections)
+	{
+		c.second.sendQueue->Shut();
+		if (c.second.bSendArmed)
+			shutdown(c.first, SHUT_RDWR);
+	}
+	for (int waits = 0; (waits < 10) && sending() && ring.WaitForCompletions(100); waits++)
+		while (struct io_uring_cqe *cqe = ring.PeekCompletion())
+		{
+			auto it = Connections.find(static_cast<int>(cqe->user_data >> 8));
+			if (((cqe->user_data & 0xFF) == UringSend) && (it != Connections.end()))
+			{
+				it->second.bSendArmed = false;
+				(void)it->second.sendQueue->Sent(cqe->res);
+			}
+			else if (cqe->flags & IORING_CQE_F_BUFFER)
+				ring.RecycleBuffer(static_cast<__u16>(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+			ring.CompletionSeen();
+		}
+	ring.Close(); // cancels the outstanding accept, recvs, and polls before their sockets are closed
+	for (auto &c : Connections)
+		Disconnect(c.first);
+	Connections.clear();
+	return bOk;
 }
 
 // bool RunMessage(TMessage &aMessage)
@@ -1095,12 +1838,19 @@ void HandleNewControlClients(int ControlListenSocket, socklen_t addrSize, sockad
 // 	return !anyError;
 // }
 
-bool RunMessage(TMessage &aMessage)
+// runs aMessage's DataItems in order, turning it into its reply; a read may be answered from an identical one that
+// started after `received`, when aMessage arrived (see coalesce.h), and a run of bit changes to one register shares a
+// read and a write (see rmw.h)
+bool RunMessage(TMessage &aMessage, std::chrono::steady_clock::time_point received)
 {
     bool anyError = false;
+    size_t fused = 0; // DataItems from i on that RunFusedRmw() has already run
 
     for (size_t i = 0; i < aMessage.DataItems.size(); ++i)
     {
+        if (!fused)
+            fused = RunFusedRmw(aMessage.DataItems, i);
+
         auto item = aMessage.DataItems[i];
         DataItemIds originalDid = DataItemIds::INVALID;
 
@@ -1108,7 +1858,14 @@ bool RunMessage(TMessage &aMessage)
 
         try
         {
-            if (item) item->Go();
+            if (fused)
+                --fused;
+            else if (item)
+            {
+                PTDataItemBase ran = Coalescer.Go(item, received);
+                if (ran != item)
+                    aMessage.DataItems[i] = item = ran; // answered with another Message's reply
+            }
 
             TError rc = item ? item->getResultCode() : ERR_MSG_PARSE;
             if (rc != ERR_SUCCESS)
@@ -1146,42 +1903,339 @@ bool RunMessage(TMessage &aMessage)
 }
 
 
-void SendResponse(int Client, TMessage &aMessage)
+// serializes anAction's Message as a reply and queues it on its client; never blocks on the client's socket (see
+// sendqueue.h).  anAction no longer counts against the client's outstanding Messages, or the Admission budget
+void SendResponse(TActionQueueItem &anAction)
 {
-	TBytes rbuf = aMessage.AsBytes(true);
-	ssize_t bytesSent = send(Client, rbuf.data(), rbuf.size(), MSG_NOSIGNAL);
-	if (bytesSent == -1)
+	const PTSendQueue &Client = anAction.Client;
+	TMessage &aMessage = *anAction.theMessage;
+	if (anAction.Bytes)
+		Admission.Release(anAction.Bytes);
+	Client->Answered(); // first: the Enqueue() below is what wakes the run-loop to resume a throttled client
+	TBytes rbuf = Client->Buffer(); // one the send queue is done with, when it has one; saves an allocation per reply
+	aMessage.AsBytes(rbuf, true);
+	Trace("queued Reply to Control Client# " + std::to_string(Client->Socket()) + " " + std::to_string(rbuf.size()) + " bytes: ", rbuf);
+	if (!Client->Enqueue(std::move(rbuf), anAction.bCloseAfter))
+		Debug("Reply to Control Client# " + std::to_string(Client->Socket()) + " discarded; the connection is closing");
+}
+
+
+#pragma region ActionLanes
+/*	The ActionThreads share the ActionQueue through TActionLanes.  While a Message runs it holds every lane in its
+	TActionQueueItem::Lanes, so Messages on disjoint lanes (an ADC scan and a DIO poll, say) run at the same time and
+	each Message still runs as a whole.  Only one ActionThread at a time pulls from the ActionQueue (it has a single
+	consumer), sorting what it pulls into one flow per client.
+
+	Which Message runs next is a deficit round robin over the flows, so a client pipelining hundreds of ADC scans gets
+	its share of the ActionThreads and the others get theirs, instead of everybody waiting behind its backlog.  Each
+	Message costs its TActionQueueItem::Cost (the TCosts of its DIds: a DIO poll is cheap, a scan or a config write is
+	not); each round a flow's deficit grows by ActionQuantum times its client's weight, and its oldest Message may start
+	once the deficit covers it.  A flow's oldest Message may start when
+		its deficit covers the Message's cost,
+		none of its lanes is held, or wanted by a flow that is further ahead in the round and can afford to go (so a
+		Message that needs every lane isn't starved by a stream of small ones), and
+		none of the client's Messages is running (a client's replies go out in the order it asked).
+	The Control run-loop does its part by not reading more than ClientMaxOutstanding Messages ahead of any one client.
+
+	The FileThread takes the file I/O off the lanes, in `fileWork` order (first come, first written):
+		a Message with a LaneFile DataItem (CFG_Hostname, SYS_Upload*) is handed to it to run, holding its lanes as usual;
+		a Message whose DataItems saved config (DAC_Calibrate1, BRD_Model, ...) runs on an ActionThread with the writes
+		held back (DeferConfigWrites()); HandOff() then frees its lanes and the FileThread writes them.
+	Either way the reply goes out only once the files are written, and the client's next Message waits for it.
+*/
+#define ActionQuantum CostAdcScan // deficit each flow gains per round, times its weight
+
+#pragma pack(push, 8) // TDataItem.h leaves pack(1) in effect
+class TActionLanes
+{
+public:
+	// the next Message this ActionThread may run, with its lanes now held; nullptr once `done`
+	PTActionQueueItem Next(TActionQueue &Q)
 	{
-		Error("! TCP Send of Reply to Control failed, bytesSent != Message Length (" + std::to_string(bytesSent) + " != " + std::to_string(rbuf.size()) + ")");
-		// handle xmit error
+		std::unique_lock<std::mutex> guard(lock);
+		for (;;)
+		{
+			if (done)
+			{
+				changed.notify_all();
+				return nullptr;
+			}
+			bool bMore = false;
+			PTActionQueueItem item = takeRunnable(bMore);
+			if (item && (item->Lanes & LaneFile))
+			{
+				fileWork.push_back(std::move(item));
+				fileChanged.notify_one();
+				continue;
+			}
+			if (item)
+			{
+				// somebody else can run the next one, or should wait on the ActionQueue; not while every lane is held,
+				// since nothing it pulled could start before this one finishes anyway (and on a small CPU the handoff costs)
+				if (bMore || (!bFeeding && !pendingCount && (busyLanes != LaneAll)))
+					changed.notify_one();
+				return item;
+			}
+			if (bFeeding || (pendingCount >= ActionQueueDepth))
+			{
+				changed.wait_for(guard, std::chrono::seconds(1)); // 1-second timeout so we notice `done`
+				continue;
+			}
+
+			bFeeding = true;
+			guard.unlock();
+			item = Q.dequeue();
+			guard.lock();
+			bFeeding = false;
+			if (item)
+				addPending(std::move(item));
+			while ((pendingCount < ActionQueueDepth) && (item = Q.tryDequeue()))
+				addPending(std::move(item));
+		}
 	}
-	else
+
+	// anItem has run and its reply is queued: its lanes and its client are free for the next Messages.  No wakeup: the
+	// caller's own Next() picks up whatever this unblocked, and wakes another ActionThread if there is more
+	void Finished(const TActionQueueItem &anItem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		release(anItem);
+	}
+
+	// ActionThread: anItem has run but its ConfigWrites haven't been written; frees its lanes and queues it for the
+	// FileThread, which sends the reply (and lets the client's next Message go) afterwards
+	void HandOff(PTActionQueueItem anItem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		busyLanes &= static_cast<TLanes>(~anItem->Lanes);
+		anItem->Lanes = LaneNone;
+		fileWork.push_back(std::move(anItem));
+		fileChanged.notify_one();
+	}
+
+	// FileThread: Finished(), and since the FileThread never calls Next(), wakes an ActionThread for whatever it unblocked
+	void FileFinished(const TActionQueueItem &anItem)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		release(anItem);
+		if (pendingCount)
+			changed.notify_one();
+	}
+
+	// FileThread: the next LaneFile Message to run or handed-off item to write; nullptr once `done` and nothing's left
+	PTActionQueueItem NextFileWork()
 	{
-		Trace("sent Reply to Control Client# " + std::to_string(Client) + " " + std::to_string(bytesSent) + " bytes: ", rbuf);
+		std::unique_lock<std::mutex> guard(lock);
+		while (fileWork.empty())
+		{
+			if (done)
+				return nullptr;
+			fileChanged.wait_for(guard, std::chrono::seconds(1)); // 1-second timeout so we notice `done`
+		}
+		PTActionQueueItem item = std::move(fileWork.front());
+		fileWork.pop_front();
+		return item;
+	}
+
+private:
+	struct TFlow
+	{
+		const TSendQueue *client;
+		std::deque<PTActionQueueItem> items; // pulled from the ActionQueue, not yet running; oldest first
+		long deficit;    // µs of ActionThread time the client may still spend this round
+		unsigned weight; // ActionQuantums per round
+		bool bRunning;   // one of its Messages is running (or with the FileThread)
+	};
+
+	std::deque<TFlow>::iterator flowOf(const TSendQueue *client)
+	{
+		return std::find_if(flows.begin(), flows.end(), [client](const TFlow &flow) { return flow.client == client; });
+	}
+
+	void addPending(PTActionQueueItem item)
+	{
+		auto flow = flowOf(item->Client.get());
+		if (flow == flows.end())
+		{
+			flows.push_back(TFlow{item->Client.get(), {}, 0, std::max(item->Weight, 1u), false});
+			flow = flows.end() - 1;
+		}
+		flow->items.push_back(std::move(item));
+		pendingCount++;
+	}
+
+	void release(const TActionQueueItem &anItem)
+	{
+		busyLanes &= static_cast<TLanes>(~anItem.Lanes);
+		auto flow = flowOf(anItem.Client.get());
+		flow->bRunning = false;
+		if (flow->items.empty())
+		{
+			const size_t index = flow - flows.begin();
+			flows.erase(flow);
+			if (cursor > index)
+				cursor--;
+		}
+	}
+
+	// the next Message the round robin allows, marked running; bMore says whether another one could start too
+	PTActionQueueItem takeRunnable(bool &bMore)
+	{
+		for (int pass = 0; pass < 2; pass++)
+		{
+			TLanes blockedLanes = busyLanes;
+			long needRounds = 0; // rounds until the nearest flow can afford its oldest Message, when none can now
+			size_t found = flows.size();
+			for (size_t n = 0; n < flows.size(); n++)
+			{
+				const size_t index = (cursor + n) % flows.size();
+				TFlow &flow = flows[index];
+				if (flow.bRunning || flow.items.empty())
+					continue;
+				const TActionQueueItem &head = *flow.items.front();
+				const bool bFree = !(head.Lanes & blockedLanes);
+				if (bFree && (found != flows.size()))
+				{
+					bMore = true; // it, or another round, can go next; let the caller wake another ActionThread
+					break;
+				}
+				if (flow.deficit < static_cast<long>(head.Cost))
+				{
+					const long quantum = static_cast<long>(ActionQuantum) * flow.weight;
+					const long rounds = (static_cast<long>(head.Cost) - flow.deficit + quantum - 1) / quantum;
+					if (!needRounds || (rounds < needRounds))
+						needRounds = rounds;
+					continue;
+				}
+				if (bFree)
+					found = index;
+				blockedLanes |= head.Lanes; // it can afford to go: nobody behind it takes these lanes first
+			}
+			if (found != flows.size())
+			{
+				TFlow &flow = flows[found];
+				PTActionQueueItem item = std::move(flow.items.front());
+				flow.items.pop_front();
+				pendingCount--;
+				flow.deficit = flow.items.empty() ? 0 : flow.deficit - item->Cost; // an idle flow saves nothing up
+				flow.bRunning = true;
+				cursor = (found + 1) % flows.size();
+				busyLanes |= item->Lanes;
+				return item;
+			}
+			if (!needRounds)
+				return nullptr;
+
+			// nobody can afford to go: play out the rounds it takes until somebody can
+			for (TFlow &flow : flows)
+				if (!flow.bRunning && !flow.items.empty() && (flow.deficit < static_cast<long>(flow.items.front()->Cost)))
+					flow.deficit += needRounds * static_cast<long>(ActionQuantum) * flow.weight;
+		}
+		return nullptr;
 	}
+
+	std::mutex lock;
+	std::condition_variable changed; // a Message arrived or finished, or the ActionQueue needs a reader
+	std::deque<TFlow> flows;         // clients with Messages waiting or running, in round-robin order
+	size_t cursor = 0;               // the flow the next round-robin scan starts at
+	size_t pendingCount = 0;         // Messages waiting in all the flows
+	TLanes busyLanes = LaneNone;
+	bool bFeeding = false; // an ActionThread is waiting on the ActionQueue
+	std::condition_variable fileChanged;    // fileWork isn't empty
+	std::deque<PTActionQueueItem> fileWork; // the FileThread's, oldest first
+};
+#pragma pack(pop)
+static TActionLanes ActionLanes;
+#pragma endregion
+
+// ActionThread/FileThread, about to run anAction: if its TTL ran out while it waited, turns theMessage into its 'E'
+// reply (SYS_Error ERR_EXPIRED, Info = how many ms late) instead; true if it did
+static bool ExpireMessage(TActionQueueItem &anAction)
+{
+	if (anAction.Deadline == std::chrono::steady_clock::time_point{})
+		return false;
+	const auto now = std::chrono::steady_clock::now();
+	if (now <= anAction.Deadline)
+		return false;
+
+	const auto lateMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - anAction.Deadline).count();
+	anAction.Client->CountExpired();
+	Debug("Message from Control Client# " + std::to_string(anAction.Client->Socket()) + " expired " + std::to_string(lateMs) + " ms ago; not run");
+	TMessage expired('E');
+	if (PTDataItemBase di = BuildSysError(SysErrStage::Execute, ErrIndex(ERR_EXPIRED), static_cast<__u32>(std::min<long long>(lateMs, UINT32_MAX)), "")) expired.addDataItem(di);
+	*anAction.theMessage = std::move(expired);
+	return true;
 }
 
+// ActionThread, about to run anAction: if it is a lone output write (see LoneOutputWrite()) from an AIOENET_SUPERSEDE
+// client that has queued a newer write to the same output since, turns theMessage into its 'E' reply (SYS_Error
+// ERR_SUPERSEDED, Info = how many newer writes) instead; true if it did.  The newest write always runs, so the output
+// still ends up holding the client's last value, without waiting out an SPI transfer for every stale one before it
+static bool SupersedeMessage(TActionQueueItem &anAction)
+{
+	if (anAction.Output < 0)
+		return false;
+	const __u32 newer = anAction.Client->NewerOutputs(static_cast<unsigned>(anAction.Output), anAction.OutputNumber);
+	if (!newer)
+		return false;
+
+	anAction.Client->CountSuperseded();
+	Debug("Output write from Control Client# " + std::to_string(anAction.Client->Socket()) + " superseded by " + std::to_string(newer) + " newer; not run");
+	TMessage superseded('E');
+	if (PTDataItemBase di = BuildSysError(SysErrStage::Execute, ErrIndex(ERR_SUPERSEDED), newer, "")) superseded.addDataItem(di);
+	*anAction.theMessage = std::move(superseded);
+	return true;
+}
 
 void *ActionThread(TActionQueue *Q)
 {
 	for (; done == 0;)
 	{
-		TActionQueueItem *anAction = Q->dequeue();
+		PTActionQueueItem anAction = ActionLanes.Next(*Q);
 		if (!anAction) continue;
 
 		Trace("---DEQUEUED---");
 
-		const TMessageId mid = anAction->theMessage.getMId();
-		if (mid == 'Q' || mid == 'C' || mid == 'M')
+		TMessage &theMessage = *anAction->theMessage;
+		const TMessageId mid = theMessage.getMId();
+		if ((mid == 'Q' || mid == 'C' || mid == 'M') && !ExpireMessage(*anAction) && !SupersedeMessage(*anAction))
 		{
-			RunMessage(anAction->theMessage);
+			DeferConfigWrites(&anAction->ConfigWrites);
+			RunMessage(theMessage, anAction->Received);
+			DeferConfigWrites(nullptr);
 		}
 		// else: 'X' (or anything else) is already a reply message
 
-		SendResponse(anAction->Socket, anAction->theMessage);
+		if (!anAction->ConfigWrites.empty())
+		{
+			ActionLanes.HandOff(std::move(anAction)); // the FileThread writes them, then replies
+			continue;
+		}
+		SendResponse(*anAction);
+		ActionLanes.Finished(*anAction);
+		RecycleActionQueueItem(std::move(anAction));
+	}
+	return nullptr;
+}
+
+// the one thread that does file I/O for Messages; see [ActionLanes]
+void *FileThread(void *)
+{
+	while (PTActionQueueItem anAction = ActionLanes.NextFileWork())
+	{
+		TMessage &theMessage = *anAction->theMessage;
+		const TMessageId mid = theMessage.getMId();
+		if (anAction->Lanes & LaneFile)
+		{
+			if ((mid == 'Q' || mid == 'C' || mid == 'M') && !ExpireMessage(*anAction))
+				RunMessage(theMessage, anAction->Received); // nothing deferred here; its WriteConfigString()s (if any) happen right away
+		}
+		else
+			(void)CommitConfigWrites(anAction->ConfigWrites); // failures are logged; the Message's own result stands
 
-		// You probably want to delete this; it currently leaks.
-		// delete anAction;
+		SendResponse(*anAction);
+		ActionLanes.FileFinished(*anAction);
+		RecycleActionQueueItem(std::move(anAction));
 	}
 	return nullptr;
 }
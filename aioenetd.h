@@ -1,18 +1,61 @@
 #pragma once
+#include <chrono>
+#include <unordered_map>
 #include <vector>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/epoll.h>
 
-#include "safe_queue.h"
+#include "mpsc_queue.h"
+#include "sendqueue.h"
 #include "TMessage.h"
+#include "TDeframer.h"
+#include "arena.h"
+#include "config.h"
+
+// TDataItem.h leaves #pragma pack(1) in effect; the smart pointers and atomics below must keep their natural alignment
+#pragma pack(push, 8)
 
 using TActionQueueItem = struct TActionQueueItemClass
 {
 	// pthread_t &sender; // which thread is responsible for sending results of the action to the client
-	// TActinQueue &SendQueue; // which queue to stuff Responses into for sending to Clients
-	int Socket; // which client is all this from/for
-	TMessage &theMessage;
+	PTSendQueue Client; // which client is all this from/for; the reply goes into its send queue
+	bool bCloseAfter;   // the connection ends once this reply has been sent ('X' for an oversize Message)
+	TLanes Lanes;       // every lane theMessage's DataItems use; held while it runs
+	__u32 Cost;         // what running theMessage is expected to take, in µs: its DIds' TCosts added up
+	unsigned Weight;    // the client's share of the ActionThreads (AIOENET_CLIENT_WEIGHTS); see [ActionLanes]
+	__u32 Bytes;        // theMessage's size as received, counted against the Admission budget; 0 for the run-loop's own replies
+	std::chrono::steady_clock::time_point Received; // when the run-loop framed theMessage; see coalesce.h
+	std::chrono::steady_clock::time_point Deadline; // when theMessage's TTL runs out (see TMessage.h); {} if it has none
+	int Output;         // theMessage is a lone write to this output, which a newer one supersedes (see SupersedeMessage());
+	                    // -1 if it isn't, or its client isn't in AIOENET_SUPERSEDE
+	__u32 OutputNumber; // its TSendQueue::QueueOutput() number
+	TConfigWrites ConfigWrites; // what running theMessage saved to the config files; the FileThread writes it
+	std::unique_ptr<TMessageArena> Arena; // theMessage's DataItems; declared first so it is destroyed after theMessage
+	std::unique_ptr<TMessage> theMessage;
 };
+// an item has exactly one owner at a time: the Control thread that parsed it, the ActionQueue, then the ActionThread,
+// which empties it and passes it back to the Control thread through SpareActionQueueItems
+using PTActionQueueItem = std::unique_ptr<TActionQueueItem>;
+
+// one per accepted Control client; owned by the Control run-loop (HandleNewControlClients or its io_uring flavor)
+using TControlConnection = struct TControlConnectionClass
+{
+	int Socket;
+	TDeframer deframer;       // received bytes not yet framed into a TMessage
+	PTSendQueue sendQueue;    // replies the ActionThread has queued for this client; sent by the run-loop
+	bool bDraining = false;   // no longer reading; closed once its close-after reply has been sent
+	bool bWantWrite = false;  // the socket was full last Flush(); waiting for it to become writable
+	__u32 events = EPOLLIN;   // epoll: what the socket is registered for
+	bool bRecvArmed = false;  // io_uring: a multishot recv is outstanding
+	bool bSendArmed = false;  // io_uring: a sendmsg of its queued replies is outstanding
+	bool bClosing = false;    // io_uring: shut down, waiting for the outstanding recv/sendmsg to finish before close()
+	bool bRecvCancel = false; // io_uring: the recv is being cancelled because the connection is throttled
+	bool bThrottled = false;  // not reading: ClientMaxOutstanding of its Messages are unanswered, or ClientMaxUnsent bytes unsent
+	unsigned weight = 1;      // from AIOENET_CLIENT_WEIGHTS, by peer address; copied into each TActionQueueItem
+	bool bSupersede = false;  // AIOENET_SUPERSEDE lists its peer address: a newer output write replaces a queued one
+};
+using TControlConnections = std::unordered_map<int, TControlConnection>; // by socket
 
 // using TSendQueueItem = struct TSendQueueItemClass
 // {
@@ -31,8 +74,19 @@ using TActionQueueItem = struct TActionQueueItemClass
 // };
 
 
-using TActionQueue = SafeQueue<TActionQueueItem *>;
+#define ActionThreads 4       // one per hardware lane; see [ActionLanes] in aioenetd.cpp.  Plus one FileThread
+#define ActionQueueDepth 1024 // Messages parsed but not yet run; when full, the Control thread stops reading until there's room
+#define SpareActionItems 64   // recycled TActionQueueItems (each with its arena) kept for the next Messages
+#define ClientMaxOutstanding 64    // a Control client's unanswered Messages before the run-loop stops reading from it...
+#define ClientResumeOutstanding 32 // ...until it is down to this many
+#define ClientMaxUnsent (256 * 1024)  // likewise for a Control client's reply bytes not yet sent...
+#define ClientResumeUnsent (64 * 1024) // ...so one that reads slowly is paused, not dropped (see ControlSendQueueLimit)
+#define ClientMaxWeight 16         // largest AIOENET_CLIENT_WEIGHTS weight
+
+using TActionQueue = TMpscQueue<PTActionQueueItem, ActionQueueDepth>;
 TActionQueue ActionQueue; // NOTE: This instantiates, but this is a header file! bad bad should be extern, no?
+// items the ActionThread is done with, on their way back to the Control thread; see NewActionQueueItem()
+TMpscQueue<PTActionQueueItem, SpareActionItems> SpareActionQueueItems;
 
 void OpenDevFile();
 void exit_handler(int s);
@@ -40,7 +94,10 @@ void abort_handler(int s);
 void Intro(int argc, char **argv);
 void HandleNewAdcClients(int Socket, int addrSize, std::vector<int> &ClientList, struct sockaddr_storage &addr);
 void HandleNewControlClients(int Socket, socklen_t addrSize, struct sockaddr_storage &addr );
+bool HandleNewControlClientsUring(int ControlListenSocket);
 void *ActionThread(TActionQueue *Q);
+void *FileThread(void *);
 void *ControlListenerThread(void *arg);
 void *AdcListenerThread(void *arg);
 
+#pragma pack(pop)
@@ -1,13 +1,52 @@
 #include "apci.h"
 #include "apcilib.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/mman.h>
 #include "eNET-AIO16-16F.h"
 #include "logging.h"
+#include "shadow.h"
+
+#define IORESOURCE_MEM 0x00000200 // sysfs `resource` flags: a memory BAR, which can be mmap()ed (see linux/ioport.h)
+
+/*	Register access: by default every in8()/out32()/... is an apci_read*()/apci_write*() ioctl round trip into the
+	driver.  apciMapRegisters() maps BAR_REGISTER into the process instead (AIOENET_REGISTER_ACCESS=mmap), and then
+	they are plain volatile loads and stores of the width widthFromOffset() gives; anything outside the mapping, or
+	misaligned for its width, still goes through the ioctl.
+*/
+static volatile __u8 *Registers = nullptr; // BAR_REGISTER, once apciMapRegisters() has mapped it (at startup, before any thread)
+static size_t RegistersSize = 0;
+
+// whether a `width`-byte access at offset can use the mapping
+static inline bool Mapped(int offset, size_t width)
+{
+	return Registers && (offset >= 0) && (static_cast<size_t>(offset) + width <= RegistersSize) && !(offset % width);
+}
+
+template <typename T>
+static inline T Load(int offset)
+{
+	return *reinterpret_cast<volatile T *>(Registers + offset);
+}
+
+template <typename T>
+static inline void Store(int offset, T value)
+{
+	*reinterpret_cast<volatile T *>(Registers + offset) = value;
+}
 
 __u8 in8(int offset)
 {
 	__u8 value = 0;
-	int status = apci_read8(apci, 0, BAR_REGISTER, offset, &value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		value = Load<__u8>(offset);
+	else
+		status = apci_read8(apci, 0, BAR_REGISTER, offset, &value);
 	Trace("in8(" + to_hex<__u8>(static_cast<__u8>(offset)) + ") ? " + to_hex<__u8>(value));
 	return status ? -1 : value;
 }
@@ -15,7 +54,11 @@ __u8 in8(int offset)
 __u16 in16(int offset)
 {
 	__u16 value = 0;
-	int status = apci_read16(apci, 0, BAR_REGISTER, offset, &value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		value = Load<__u16>(offset);
+	else
+		status = apci_read16(apci, 0, BAR_REGISTER, offset, &value);
 	Trace("in16(" + to_hex<__u8>(static_cast<__u8>(offset)) + ") ? " + to_hex<__u16>(value));
 	return status ? -1 : value;
 }
@@ -23,7 +66,11 @@ __u16 in16(int offset)
 __u32 in32(int offset)
 {
 	__u32 value = 0;
-	int status = apci_read32(apci, 0, BAR_REGISTER, offset, &value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		value = Load<__u32>(offset);
+	else
+		status = apci_read32(apci, 0, BAR_REGISTER, offset, &value);
 	Trace("in32(" + to_hex<__u8>(static_cast<__u8>(offset)) + ") ? " + to_hex<__u32>(value));
 
 	return status ? -1 : value;
@@ -47,38 +94,132 @@ __u32 in(int offset)
 
 TError out8(int offset, __u8 value)
 {
-	int status = apci_write8(apci, 0, BAR_REGISTER, offset, value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		Store<__u8>(offset, value);
+	else
+		status = apci_write8(apci, 0, BAR_REGISTER, offset, value);
 	Trace("out8(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + to_hex<__u8>(value) + ")" );
 	return status;
 }
 
 TError out16(int offset, __u16 value)
 {
-	int status = apci_write16(apci, 0, BAR_REGISTER, offset, value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		Store<__u16>(offset, value);
+	else
+		status = apci_write16(apci, 0, BAR_REGISTER, offset, value);
 	Trace("out16(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + to_hex<__u16>(value) + ")" );
 	return status;
 }
 
 TError out32(int offset, __u32 value)
 {
-	int status = apci_write32(apci, 0, BAR_REGISTER, offset, value);
+	int status = 0;
+	if (Mapped(offset, sizeof(value)))
+		Store<__u32>(offset, value);
+	else
+		status = apci_write32(apci, 0, BAR_REGISTER, offset, value);
 	Trace("out32(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + to_hex<__u32>(value) + ")" );
 	return status;
 }
 
+// every out() keeps the register shadow current, and skips what it says is already there (see shadow.h)
 TError out(int offset, __u32 value)
 {
+	if (Shadow.Unchanged(offset, value))
+	{
+		Trace("out(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + to_hex<__u32>(value) + ") unchanged; not written");
+		return 0;
+	}
+	TError status;
 	switch (widthFromOffset(offset))
 	{
 	case 8:
-		return out8(offset, static_cast<__u8>(value));
+		status = out8(offset, static_cast<__u8>(value));
+		break;
 	case 16:
-		return out16(offset, static_cast<__u16>(value));
+		status = out16(offset, static_cast<__u16>(value));
+		break;
 	case 32:
-		return out32(offset, value);
+		status = out32(offset, value);
+		break;
+	default:
+		return -1;
+	}
+	Shadow.Wrote(offset, value, status);
+	return status;
+}
+
+// count accesses of `T` at offset, through the mapping if it covers them, else one ioctl each
+template <typename T, typename Ioctl>
+static TError readBuf(int offset, __u8 *into, size_t count, Ioctl read)
+{
+	if (Mapped(offset, sizeof(T)))
+	{
+		for (size_t i = 0; i < count; i++, into += sizeof(T))
+		{
+			const T value = Load<T>(offset);
+			memcpy(into, &value, sizeof(T));
+		}
+		return 0;
+	}
+	for (size_t i = 0; i < count; i++, into += sizeof(T))
+	{
+		T value = 0;
+		if (read(apci, 0, BAR_REGISTER, offset, &value))
+			return -1;
+		memcpy(into, &value, sizeof(T));
+	}
+	return 0;
+}
+
+template <typename T, typename Ioctl>
+static TError writeBuf(int offset, const __u8 *from, size_t count, Ioctl write)
+{
+	for (size_t i = 0; i < count; i++, from += sizeof(T))
+	{
+		T value;
+		memcpy(&value, from, sizeof(T));
+		if (Mapped(offset, sizeof(T)))
+			Store<T>(offset, value);
+		else if (write(apci, 0, BAR_REGISTER, offset, value))
+			return -1;
+	}
+	return 0;
+}
+
+TError inBuf(int offset, __u8 *into, size_t count)
+{
+	Trace("inBuf(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + std::to_string(count) + ")");
+	switch (widthFromOffset(offset))
+	{
+	case 8:
+		return readBuf<__u8>(offset, into, count, apci_read8);
+	case 16:
+		return readBuf<__u16>(offset, into, count, apci_read16);
+	case 32:
+		return readBuf<__u32>(offset, into, count, apci_read32);
+	default:
+		return -1;
+	}
+}
+
+TError outBuf(int offset, const __u8 *from, size_t count)
+{
+	Trace("outBuf(" + to_hex<__u8>(static_cast<__u8>(offset)) + ", " + std::to_string(count) + ")");
+	Shadow.Forget(offset);
+	switch (widthFromOffset(offset))
+	{
+	case 8:
+		return writeBuf<__u8>(offset, from, count, apci_write8);
+	case 16:
+		return writeBuf<__u16>(offset, from, count, apci_write16);
+	case 32:
+		return writeBuf<__u32>(offset, from, count, apci_write32);
 	default:
 		return -1;
-		break;
 	}
 }
 
@@ -86,6 +227,78 @@ int apciGetDevices() { return apci_get_devices(apci); }
 
 int apciGetDeviceInfo(unsigned int *deviceID, unsigned long bars[6]) { return apci_get_device_info(apci, 0, deviceID, bars); }
 
+// the PCI device whose BAR_REGISTER starts at barStart: its sysfs directory, and the BAR's size; false if none is,
+// or that BAR isn't memory
+static bool FindRegisterBar(unsigned long barStart, std::filesystem::path &device, size_t &size)
+{
+	std::error_code ec;
+	for (const auto &dir : std::filesystem::directory_iterator("/sys/bus/pci/devices", ec))
+	{
+		FILE *f = fopen((dir.path() / "resource").c_str(), "r");
+		if (!f)
+			continue;
+		unsigned long long start = 0, end = 0, flags = 0;
+		bool bFound = false;
+		for (int bar = 0; bar <= BAR_REGISTER; bar++)
+			if (fscanf(f, "%llx %llx %llx", &start, &end, &flags) != 3)
+			{
+				start = 0;
+				break;
+			}
+		fclose(f);
+		if (start && (start == barStart) && (end > start))
+		{
+			bFound = (flags & IORESOURCE_MEM) != 0;
+			if (!bFound)
+				Error("PCI " + dir.path().filename().string() + " BAR" + std::to_string(BAR_REGISTER) + " is I/O space; it can't be mapped");
+		}
+		if (bFound)
+		{
+			device = dir.path();
+			size = end - start + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool apciMapRegisters()
+{
+	unsigned int deviceID = 0;
+	unsigned long bars[6] = {};
+	if (apciGetDeviceInfo(&deviceID, bars) < 0)
+	{
+		Error("apci_get_device_info() failed; can't find BAR" + std::to_string(BAR_REGISTER) + " to map");
+		return false;
+	}
+	std::filesystem::path device;
+	size_t size = 0;
+	if (!FindRegisterBar(bars[BAR_REGISTER], device, size))
+	{
+		Error("no PCI device in sysfs has a memory BAR at " + to_hex<__u32>(static_cast<__u32>(bars[BAR_REGISTER])));
+		return false;
+	}
+
+	const std::filesystem::path resource = device / ("resource" + std::to_string(BAR_REGISTER));
+	int fd = open(resource.c_str(), O_RDWR | O_SYNC);
+	if (fd < 0)
+	{
+		Error("open(" + resource.string() + ") failed: " + strerror(errno));
+		return false;
+	}
+	void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); // the mapping keeps it
+	if (map == MAP_FAILED)
+	{
+		Error("mmap(" + resource.string() + ") failed: " + strerror(errno));
+		return false;
+	}
+	Registers = static_cast<volatile __u8 *>(map);
+	RegistersSize = size;
+	Log("Registers mapped from " + resource.string() + ", " + std::to_string(size) + " bytes; in()/out() no longer ioctl()");
+	return true;
+}
+
 int apciWaitForIRQ() { return apci_wait_for_irq(apci, 0); }
 
 int apciCancelWaitForIRQ() { return apci_cancel_irq(apci, 0); }
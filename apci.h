@@ -8,10 +8,17 @@ extern int apci;
 
 __u32 in(int offset);
 TError out(int offset, __u32 value);
+// `count` in()s or out()s of the one register at offset (a FIFO, say), each widthFromOffset() wide, packed
+// little-endian in the buffer; one call, and no ioctl at all once the registers are mapped.  -1 if one failed
+TError inBuf(int offset, __u8 *into, size_t count);
+TError outBuf(int offset, const __u8 *from, size_t count);
 
 
 int apciGetDevices();
 int apciGetDeviceInfo(unsigned int *deviceID, unsigned long bars[6]);
+// after the device is open: maps BAR_REGISTER so in()/out() are loads and stores instead of ioctls; false leaves them
+// ioctls (see apci.cpp)
+bool apciMapRegisters();
 int apciWaitForIRQ();
 int apciCancelWaitForIRQ();
 int apciDmaTransferSize(__u8 slots, size_t size);
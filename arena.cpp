@@ -0,0 +1,19 @@
+#include "arena.h"
+
+static thread_local std::pmr::memory_resource *currentArena = nullptr;
+
+TArenaScope::TArenaScope(TMessageArena &arena)
+	: previous(currentArena)
+{
+	currentArena = arena.Resource();
+}
+
+TArenaScope::~TArenaScope()
+{
+	currentArena = previous;
+}
+
+std::pmr::memory_resource *CurrentArena()
+{
+	return currentArena ? currentArena : std::pmr::new_delete_resource();
+}
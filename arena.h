@@ -0,0 +1,63 @@
+#pragma once
+/*
+arena.h
+
+TMessageArena: one monotonic memory pool per received Message, owned by its TActionQueueItem.
+
+	While a TArenaScope is active on a thread, the DIdDict constructors (construct<>()) place each TDataItem, its
+	shared_ptr control block, and its rawBytes in that scope's arena instead of the heap.  A Message of 50 DataItems
+	then costs a couple of bump-pointer allocations instead of a hundred-odd malloc()s.
+
+	Nothing is freed piecemeal: the ActionThread recycles its TActionQueueItem after SendResponse(), which destroys the
+	TMessage and then Reset()s the arena, and whatever the arena took from the heap goes back in one step.  Anything that must outlive the Message (and
+	anything built outside a TArenaScope, like the Hello Message or SYS_Error replies) comes from the heap as before.
+
+	The arena is not thread-safe; it belongs to whichever thread holds its TActionQueueItem (the Control thread while
+	parsing, then the ActionThread).
+*/
+
+// TDataItem.h leaves #pragma pack(1) in effect; the arena must have one layout in every file
+#pragma pack(push, 8)
+#include <cstddef>
+#include <linux/types.h>
+#include <memory_resource>
+#include <vector>
+
+#define MessageArenaInitialSize 4096 // covers a typical Message's DataItems without touching the heap again
+
+class TMessageArena
+{
+public:
+	TMessageArena() = default;
+	TMessageArena(const TMessageArena &) = delete;
+	TMessageArena &operator=(const TMessageArena &) = delete;
+
+	std::pmr::memory_resource *Resource() { return &pool; }
+	// gives back everything allocated so far, keeping `initial`, so a recycled arena starts over like a new one
+	void Reset() { pool.release(); }
+
+private:
+	alignas(std::max_align_t) std::byte initial[MessageArenaInitialSize];
+	std::pmr::monotonic_buffer_resource pool{initial, sizeof(initial)};
+};
+
+// makes arena the current thread's allocation target for DataItems until the scope ends; scopes nest
+class TArenaScope
+{
+public:
+	explicit TArenaScope(TMessageArena &arena);
+	~TArenaScope();
+	TArenaScope(const TArenaScope &) = delete;
+	TArenaScope &operator=(const TArenaScope &) = delete;
+
+private:
+	std::pmr::memory_resource *previous;
+};
+
+// the active TArenaScope's arena, or the plain heap if there isn't one
+std::pmr::memory_resource *CurrentArena();
+
+// byte buffer that lives in whichever arena was current when it was constructed
+using TArenaBytes = std::pmr::vector<__u8>;
+
+#pragma pack(pop)
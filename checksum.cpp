@@ -0,0 +1,140 @@
+#include "checksum.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+using TChecksumKernel = __u8 (*)(std::span<const __u8>);
+
+static __u8 SumTail(const __u8 *p, size_t n, __u8 sum)
+{
+	for (size_t i = 0; i < n; i++)
+		sum = static_cast<__u8>(sum + p[i]);
+	return sum;
+}
+
+__u8 ChecksumScalar(std::span<const __u8> bytes)
+{
+	return SumTail(bytes.data(), bytes.size(), 0);
+}
+
+#if defined(__x86_64__)
+// 8-bit lanes wrap exactly like the scalar sum; _mm_sad_epu8 against zero then adds the 16 lanes together
+static __u8 FoldLanes(__m128i acc)
+{
+	__m128i sad = _mm_sad_epu8(acc, _mm_setzero_si128());
+	return static_cast<__u8>(_mm_cvtsi128_si32(sad) + _mm_extract_epi16(sad, 4));
+}
+
+__u8 ChecksumSSE2(std::span<const __u8> bytes)
+{
+	const __u8 *p = bytes.data();
+	size_t n = bytes.size();
+	__m128i a0 = _mm_setzero_si128(), a1 = _mm_setzero_si128(), a2 = _mm_setzero_si128(), a3 = _mm_setzero_si128();
+	for (; n >= 64; p += 64, n -= 64)
+	{
+		a0 = _mm_add_epi8(a0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+		a1 = _mm_add_epi8(a1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16)));
+		a2 = _mm_add_epi8(a2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32)));
+		a3 = _mm_add_epi8(a3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48)));
+	}
+	for (; n >= 16; p += 16, n -= 16)
+		a0 = _mm_add_epi8(a0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+	__m128i acc = _mm_add_epi8(_mm_add_epi8(a0, a1), _mm_add_epi8(a2, a3));
+	return SumTail(p, n, FoldLanes(acc));
+}
+
+__attribute__((target("avx2"))) __u8 ChecksumAVX2(std::span<const __u8> bytes)
+{
+	const __u8 *p = bytes.data();
+	size_t n = bytes.size();
+	__m256i a0 = _mm256_setzero_si256(), a1 = _mm256_setzero_si256(), a2 = _mm256_setzero_si256(), a3 = _mm256_setzero_si256();
+	for (; n >= 128; p += 128, n -= 128)
+	{
+		a0 = _mm256_add_epi8(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+		a1 = _mm256_add_epi8(a1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32)));
+		a2 = _mm256_add_epi8(a2, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 64)));
+		a3 = _mm256_add_epi8(a3, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 96)));
+	}
+	for (; n >= 32; p += 32, n -= 32)
+		a0 = _mm256_add_epi8(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+	__m256i acc = _mm256_add_epi8(_mm256_add_epi8(a0, a1), _mm256_add_epi8(a2, a3));
+	__m128i half = _mm_add_epi8(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+	for (; n >= 16; p += 16, n -= 16)
+		half = _mm_add_epi8(half, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+	return SumTail(p, n, FoldLanes(half));
+}
+
+static TChecksumKernel SelectChecksumKernel(const char *&name)
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		name = "AVX2";
+		return ChecksumAVX2;
+	}
+	name = "SSE2"; // part of the x86-64 baseline
+	return ChecksumSSE2;
+}
+
+#elif defined(__aarch64__)
+__u8 ChecksumNEON(std::span<const __u8> bytes)
+{
+	const __u8 *p = bytes.data();
+	size_t n = bytes.size();
+	uint8x16_t a0 = vdupq_n_u8(0), a1 = vdupq_n_u8(0), a2 = vdupq_n_u8(0), a3 = vdupq_n_u8(0);
+	for (; n >= 64; p += 64, n -= 64)
+	{
+		a0 = vaddq_u8(a0, vld1q_u8(p));
+		a1 = vaddq_u8(a1, vld1q_u8(p + 16));
+		a2 = vaddq_u8(a2, vld1q_u8(p + 32));
+		a3 = vaddq_u8(a3, vld1q_u8(p + 48));
+	}
+	for (; n >= 16; p += 16, n -= 16)
+		a0 = vaddq_u8(a0, vld1q_u8(p));
+	uint8x16_t acc = vaddq_u8(vaddq_u8(a0, a1), vaddq_u8(a2, a3));
+	return SumTail(p, n, vaddvq_u8(acc)); // vaddvq_u8 wraps at 8 bits, which is exactly what we want
+}
+
+static TChecksumKernel SelectChecksumKernel(const char *&name)
+{
+	if (getauxval(AT_HWCAP) & HWCAP_ASIMD)
+	{
+		name = "NEON";
+		return ChecksumNEON;
+	}
+	name = "scalar";
+	return ChecksumScalar;
+}
+
+#else
+static TChecksumKernel SelectChecksumKernel(const char *&name)
+{
+	name = "scalar";
+	return ChecksumScalar;
+}
+#endif
+
+static const char *kernelName = "scalar";
+
+// a function-local static, so it's safe to call from other files' static initializers
+static TChecksumKernel Kernel()
+{
+	static const TChecksumKernel kernel = SelectChecksumKernel(kernelName);
+	return kernel;
+}
+
+__u8 Checksum(std::span<const __u8> bytes)
+{
+	return Kernel()(bytes);
+}
+
+const char *ChecksumKernelName()
+{
+	Kernel();
+	return kernelName;
+}
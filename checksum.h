@@ -0,0 +1,31 @@
+#pragma once
+/*
+checksum.h
+
+The Message checksum byte (see TMessage.h [MESSAGE FORMAT]) is the 8-bit sum of every byte in the Message.
+
+	Checksum() runs on every received frame and every Response, so it has vector kernels: SSE2 or AVX2 on x86-64,
+	NEON (ASIMD) on the AM64x's Cortex-A53, and a scalar loop everywhere else.  The kernel is picked once, from what
+	the CPU reports at runtime, the first time Checksum() is called.
+
+	All kernels give bit-identical results: an 8-bit sum doesn't care what order the bytes are added in, so each
+	kernel adds bytes into 8-bit vector lanes (wrapping, just like the scalar loop) and then adds the lanes together.
+*/
+
+#include <linux/types.h>
+#include <span>
+
+// the 8-bit sum of bytes
+__u8 Checksum(std::span<const __u8> bytes);
+
+// name of the kernel Checksum() uses on this CPU, for the startup log
+const char *ChecksumKernelName();
+
+// the individual kernels; only ChecksumScalar() is available everywhere
+__u8 ChecksumScalar(std::span<const __u8> bytes);
+#if defined(__x86_64__)
+__u8 ChecksumSSE2(std::span<const __u8> bytes);
+__u8 ChecksumAVX2(std::span<const __u8> bytes);
+#elif defined(__aarch64__)
+__u8 ChecksumNEON(std::span<const __u8> bytes);
+#endif
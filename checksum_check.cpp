@@ -0,0 +1,102 @@
+/*
+checksum_check.cpp
+
+Standalone check of the Message checksum kernels (see checksum.h): every kernel this CPU can run has to agree with a
+plain byte loop, for every short length at every alignment within a cache line, and for random lengths and alignments
+up to a maximum-size Message.  `make check` builds and runs it; the exit status is non-zero if any kernel disagrees.
+
+A kernel the CPU lacks (AVX2 on an older x86, NEON on an aarch64 without ASIMD) is still compiled, and reported as
+skipped.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+#if defined(__aarch64__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#include "checksum.h"
+
+#define CheckMaxAlign  64            // offsets 0..63 from a 64-byte boundary
+#define CheckShortLen  (4 * 128 + 8) // past four of the widest kernel's unrolled steps, so every tail length is hit
+#define CheckMaxLen    (1 << 16)     // a little past the largest Message
+#define CheckRandomRuns 2000
+
+struct TChecksumKernelCheck
+{
+	const char *name;
+	__u8 (*sum)(std::span<const __u8>);
+	bool bRuns;          // this CPU has the instructions
+	size_t cases = 0;
+	size_t failures = 0;
+};
+
+static __u8 ByteLoop(const __u8 *p, size_t n)
+{
+	__u8 sum = 0;
+	for (size_t i = 0; i < n; i++)
+		sum = static_cast<__u8>(sum + p[i]);
+	return sum;
+}
+
+int main()
+{
+	std::vector<TChecksumKernelCheck> kernels{
+		{"scalar", ChecksumScalar, true},
+		{"Checksum()", Checksum, true}, // whichever kernel was picked at runtime
+#if defined(__x86_64__)
+		{"SSE2", ChecksumSSE2, true},
+		{"AVX2", ChecksumAVX2, __builtin_cpu_supports("avx2") != 0},
+#elif defined(__aarch64__)
+		{"NEON", ChecksumNEON, (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0},
+#endif
+	};
+
+	std::mt19937 rng(0x494f);
+	std::vector<__u8> buf(CheckMaxLen + CheckMaxAlign);
+	for (__u8 &b : buf)
+		b = static_cast<__u8>(rng());
+
+	auto check = [&](size_t ofs, size_t len)
+	{
+		const __u8 expected = ByteLoop(buf.data() + ofs, len);
+		for (TChecksumKernelCheck &k : kernels)
+		{
+			if (!k.bRuns)
+				continue;
+			k.cases++;
+			const __u8 got = k.sum(std::span<const __u8>(buf.data() + ofs, len));
+			if ((got != expected) && (k.failures++ < 10))
+				printf("%s: offset %zu, length %zu: got %02x, expected %02x\n", k.name, ofs, len, got, expected);
+		}
+	};
+
+	for (size_t ofs = 0; ofs < CheckMaxAlign; ofs++)
+		for (size_t len = 0; len <= CheckShortLen; len++)
+			check(ofs, len);
+
+	std::uniform_int_distribution<size_t> ofsDist(0, CheckMaxAlign - 1);
+	std::uniform_int_distribution<size_t> lenDist(0, CheckMaxLen);
+	for (int run = 0; run < CheckRandomRuns; run++)
+		check(ofsDist(rng), lenDist(rng));
+
+	// all 0xFF wraps every lane on the first add
+	std::fill(buf.begin(), buf.end(), 0xFF);
+	for (size_t len : {size_t{255}, size_t{256}, size_t{257}, size_t{4096}, size_t{CheckMaxLen}})
+		check(1, len);
+
+	size_t failures = 0;
+	printf("Checksum() uses the %s kernel\n", ChecksumKernelName());
+	for (const TChecksumKernelCheck &k : kernels)
+	{
+		if (!k.bRuns)
+			printf("  %-10s skipped: this CPU can't run it\n", k.name);
+		else
+			printf("  %-10s %s: %zu cases, %zu mismatches\n", k.name, k.failures ? "FAILED" : "ok", k.cases, k.failures);
+		failures += k.failures;
+	}
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+#include "coalesce.h"
+#include "logging.h"
+
+TCoalescer Coalescer;
+
+// what a Coalesce() DataItem answered from another one's read replies with: the same DId, and that read's reply
+class TDataItemShared : public TDataItemBase
+{
+public:
+	TDataItemShared(DataItemIds dId, std::shared_ptr<const TBytes> aReply)
+		: TDataItemBase(dId), reply(std::move(aReply))
+	{
+	}
+
+	// the hardware was read for somebody else
+	virtual TDataItemBase &Go() override { return *this; }
+
+	virtual TBytes calcPayload(bool bAsReply = false) override { return *reply; }
+
+	virtual std::string AsString(bool bAsReply = false) override
+	{
+		return getDIdDesc() + " (shared read) → " + to_hex(*reply);
+	}
+
+private:
+	std::shared_ptr<const TBytes> reply;
+};
+
+void TCoalescer::Touch(TLanes lanes)
+{
+	for (unsigned bit = 0; lanes; bit++, lanes >>= 1)
+		if (lanes & 1)
+			touched[bit].fetch_add(1, std::memory_order_relaxed);
+}
+
+__u64 TCoalescer::Stamp(TLanes lanes) const
+{
+	__u64 stamp = 0;
+	for (unsigned bit = 0; lanes; bit++, lanes >>= 1)
+		if (lanes & 1)
+			stamp += touched[bit].load(std::memory_order_relaxed);
+	return stamp;
+}
+
+PTDataItemBase TCoalescer::Go(const PTDataItemBase &item, TClock::time_point received)
+{
+	const TDIdDictEntry *entry = DIdDict.find(item->getDId());
+	if ((entry == DIdDict.end()) || !entry->bCoalesce)
+	{
+		if (entry != DIdDict.end())
+			Touch(entry->lanes); // before Go(): nothing on these lanes runs at the same time, so a throw changes nothing
+		item->Go();
+		return item;
+	}
+
+	// the caller holds entry->lanes, so nobody Touch()es them while we look, or while the read below runs
+	reads.fetch_add(1, std::memory_order_relaxed);
+	TKey key(entry->DId, item->calcPayload(false));
+	const TClock::time_point now = TClock::now();
+	const __u64 stamp = Stamp(entry->lanes);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = replies.find(key);
+		if ((it != replies.end()) && (it->second.stamp == stamp) &&
+			((received <= it->second.started) || (now - it->second.started <= std::chrono::microseconds(windowUs))))
+		{
+			shared.fetch_add(1, std::memory_order_relaxed);
+			return std::make_shared<TDataItemShared>(entry->DId, it->second.payload);
+		}
+	}
+
+	item->Go();
+	if (item->getResultCode() != ERR_SUCCESS)
+		return item; // not worth sharing; whoever asks next tries again
+
+	auto payload = std::make_shared<const TBytes>(item->calcPayload(true));
+	std::lock_guard<std::mutex> guard(lock);
+	if (replies.size() >= CoalesceMaxReplies)
+		replies.clear();
+	replies.insert_or_assign(std::move(key), TReply{std::move(payload), now, stamp});
+	return item;
+}
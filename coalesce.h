@@ -0,0 +1,80 @@
+#pragma once
+/*
+coalesce.h
+
+TCoalescer: lets identical hardware reads (DIO_Input, ADC_CountsAll, BRD_FpgaID, ...) that pile up in the ActionQueue
+share one trip to the hardware.
+
+	A DIdList entry wrapped in Coalesce() is a read with no side effects worth repeating: its reply depends only on its
+	DId, its request payload, and the hardware.  RunMessage() hands every DataItem to Go() here instead of calling its
+	Go() directly.  For one of those reads, Go() looks for the last reply to the identical request (same DId, same
+	payload) and answers with a copy of it instead of touching the hardware, when
+		nothing has run on the read's lanes since (any other DataItem on a lane counts; see Touch()), and
+		the read started after this Message was received (it was already waiting, so a reply sampled then is as fresh
+		as one it would have gotten itself), or it is no older than the window (AIOENET_COALESCE_US; 0 by default, so
+		nobody gets a reply sampled before they asked unless the admin says so).
+	Otherwise the DataItem runs as usual and, if it succeeds, its reply becomes the one to share.
+
+	Ten HMIs polling DIO_Input at the same moment then cost one in() instead of ten; behind an ADC scan, every identical
+	scan queued while it ran gets its result.  SYS_Coalescing reads the counters.
+
+	Go() may be called from every ActionThread (and the FileThread) at once.
+*/
+
+#include "DataItems/TDataItem.h"
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics, map and mutex below must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <linux/types.h>
+
+#define CoalesceMaxReplies 64      // remembered replies; past this they're all forgotten (they go stale fast anyway)
+#define CoalesceMaxWindowUs 1000000 // AIOENET_COALESCE_US can't ask for more than this
+
+class TCoalescer
+{
+public:
+	using TClock = std::chrono::steady_clock;
+
+	// runs item (one of a Message received at `received`), or answers it from an identical read; returns what the
+	// Message should reply with: item itself, or a copy of the shared reply
+	PTDataItemBase Go(const PTDataItemBase &item, TClock::time_point received);
+
+	// something other than a coalesced read ran on lanes; Go() calls it for everything else it runs, and whoever runs a
+	// DataItem without Go() (RunFusedRmw()) must call it instead
+	void Touch(TLanes lanes);
+
+	// at startup
+	void SetWindow(__u32 microseconds) { windowUs = microseconds; }
+
+	__u32 WindowUs() const { return windowUs; }
+	__u64 Reads() const { return reads.load(std::memory_order_relaxed); }
+	__u64 Shared() const { return shared.load(std::memory_order_relaxed); }
+
+private:
+	using TKey = std::pair<DataItemIds, TBytes>; // DId and request payload
+	struct TReply
+	{
+		std::shared_ptr<const TBytes> payload;
+		TClock::time_point started; // when the hardware read began
+		__u64 stamp;                // Stamp() of its lanes then
+	};
+
+	// changes whenever anything is Touch()ed on lanes
+	__u64 Stamp(TLanes lanes) const;
+
+	__u32 windowUs = 0;
+	std::atomic<__u64> touched[8] = {}; // per TLanes bit
+	std::mutex lock;                    // guards replies
+	std::map<TKey, TReply> replies;
+	std::atomic<__u64> reads{0};  // Coalesce() DataItems that came through Go(), shared or not
+	std::atomic<__u64> shared{0}; // ...that were answered from another one's read
+};
+
+extern TCoalescer Coalescer; // the daemon's one; defined in coalesce.cpp
+
+#pragma pack(pop)
@@ -1,6 +1,7 @@
 //------------------- Configuration Files -------------
 // config.cpp
 
+#include <algorithm>
 #include <fcntl.h>
 #include <unistd.h>
 #include <fstream>
@@ -431,9 +432,8 @@ int ReadConfigFloat(std::string key, float &value, std::string which)
 	return 0;
 }
 
-int WriteConfigString(std::string key, std::string value, std::string which)
+static int WriteConfigFile(const std::string &path, const std::string &value)
 {
-	std::string path = FilePathFor(which, key);
 	// ensure dir exists (idempotent)
 	MkdirP(fs::path(path).parent_path().string(), 0755);
 	int rc = AtomicWriteTextFile(path, value, 0644);
@@ -442,10 +442,45 @@ int WriteConfigString(std::string key, std::string value, std::string which)
 		Error("WriteConfigString(" + path + ") failed: " + std::to_string(-rc));
 	}
 	else
-		Debug("Wrote config key " + key + " in " + which + " as " + value);
+		Debug("Wrote config file " + path + " as " + value);
 	return rc;
 }
 
+static thread_local TConfigWrites *deferredWrites = nullptr; // see DeferConfigWrites()
+
+void DeferConfigWrites(TConfigWrites *into)
+{
+	deferredWrites = into;
+}
+
+int CommitConfigWrites(const TConfigWrites &writes)
+{
+	int result = 0;
+	for (const auto &[path, value] : writes)
+	{
+		int rc = WriteConfigFile(path, value);
+		if ((rc < 0) && (result == 0))
+			result = rc;
+	}
+	return result;
+}
+
+int WriteConfigString(std::string key, std::string value, std::string which)
+{
+	std::string path = FilePathFor(which, key);
+	if (deferredWrites)
+	{
+		// a Message that writes a key twice (DAC_Calibrate1 then DAC_Scale1, say) only needs the last one on disk
+		auto write = std::find_if(deferredWrites->begin(), deferredWrites->end(), [&](const auto &w) { return w.first == path; });
+		if (write != deferredWrites->end())
+			write->second = std::move(value);
+		else
+			deferredWrites->emplace_back(std::move(path), std::move(value));
+		return 0;
+	}
+	return WriteConfigFile(path, value);
+}
+
 int WriteConfigU8(std::string key, __u8 value, std::string which)
 {
 	std::string v = to_hex<__u8>(value);
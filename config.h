@@ -22,6 +22,8 @@ eNET-AIO configuration structure and support API.
 */
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "utilities.h"
 #include "eNET-AIO16-16F.h"
@@ -92,6 +94,14 @@ bool SaveSubmuxConfig(std::string which = CONFIG_CURRENT);
 bool SaveConfig(std::string which = CONFIG_CURRENT);
 int WriteConfigString(std::string key, std::string value, std::string which = CONFIG_CURRENT);
 
+// config file writes held back for later: (path, contents), one per file, latest contents wins
+using TConfigWrites = std::vector<std::pair<std::string, std::string>>;
+// while `into` is set, this thread's WriteConfigString()s (and so the Save*Config()s) only update `into` and return 0;
+// the ActionThreads use this so a DataItem's fsync()s happen on the FileThread instead.  nullptr: write immediately
+void DeferConfigWrites(TConfigWrites *into);
+// writes everything in `writes`, in order; 0, or the first error (each failure is logged)
+int CommitConfigWrites(const TConfigWrites &writes);
+
 void ApplyConfig();
 
 
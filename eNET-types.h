@@ -25,6 +25,7 @@ typedef uint32_t __u32;
 #include <string>
 #include <iomanip>
 #include <memory>
+#include <span>
 #include <vector>
 #include <thread>
 
@@ -33,6 +34,7 @@ typedef uint32_t __u32;
 
 /* type definitions */
 using TBytes = std::vector<__u8>;
+using TByteSpan = std::span<const __u8>; // non-owning view of TBytes, e.g. one DataItem inside a received Message
 typedef __u8 TMessageId;
 typedef __u32 TMessagePayloadSize;
 typedef __u8 TCheckSum;
@@ -184,6 +186,10 @@ enum class DataItemIds : TDataId
 	CFG_Hostname = 0x9001,
 	SYS_UploadFileName = 0xEF01,
 	SYS_UploadFileData = 0xEF02,
+	SYS_Admission = 0xEF10, // admission control's budgets, what's queued now, and what it has shed
+	SYS_Coalescing = 0xEF11, // how many hardware reads have been shared between identical requests
+	SYS_MaxAge = 0xEF12, // prefix for a 'Q': its reads may be answered from values this many ms old (see snapshot.h)
+	SYS_Shadow = 0xEF13, // how many register reads and writes the register shadow has saved (see shadow.h)
 	SYS_Error = 0xEFF0,
 	SYS_ItemError = 0xEFF1,
 	DOC_Get = 0xFFFF,
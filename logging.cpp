@@ -63,7 +63,7 @@ static const char* colorForLevel(LogLevel level)
     }
     return "";
 }
-void LogImpl(LogLevel level, std::string intro, TBytes bytes, bool crlf, const source_location &loc)
+void LogImpl(LogLevel level, std::string intro, TByteSpan bytes, bool crlf, const source_location &loc)
 {
     std::stringstream msg;
     msg << intro;
@@ -83,7 +83,7 @@ void LogImpl(LogLevel level, std::string message, const source_location &loc)
     // forward to the full overload with an empty payload
     LogImpl(level,
             std::move(message),
-            TBytes{} /*empty bytes*/,
+            TByteSpan{} /*empty bytes*/,
             true     /*default crlf*/,
             loc);
 }
\ No newline at end of file
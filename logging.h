@@ -21,7 +21,7 @@ void SetLogLevel(LogLevel level);
 LogLevel GetLogLevel();
 
 void LogImpl(LogLevel level, std::string message, const source_location &loc = source_location::current());
-void LogImpl(LogLevel level, std::string intro, TBytes bytes, bool crlf = true, const source_location &loc = source_location::current());
+void LogImpl(LogLevel level, std::string intro, TByteSpan bytes, bool crlf = true, const source_location &loc = source_location::current());
 
 #define LOG_IF(level, ...) \
     do { if ((level) <= GetLogLevel()) LogImpl(level, __VA_ARGS__); } while (0)
@@ -0,0 +1,197 @@
+#pragma once
+/*
+mpsc_queue.h
+
+TMpscQueue: bounded, lock-free, many-producer/one-consumer ring; the ActionQueue (Control thread(s) -> ActionThread).
+
+	Each slot carries a sequence number that says whose turn it is (Dmitry Vyukov's bounded queue): a producer claims a
+	slot with one CAS on `tail`, moves its item in, and publishes it by bumping the slot's sequence; the consumer takes
+	slots in order without any atomic read-modify-write at all.  Nothing is allocated per item; the slots are the nodes.
+
+	Nobody sleeps while there is work.  The consumer only blocks (on a futex) after it has announced itself idle and
+	re-checked the ring, and a producer only pays for a wakeup syscall when it sees that announcement.  A producer that
+	finds the ring full blocks the same way until the consumer frees a slot, which pushes back on the socket it is reading
+	instead of growing memory without limit; it is woken once the consumer has emptied half the ring.
+
+	Same interface as SafeQueue (enqueue/dequeue/tryDequeue/Stop), so it drops in wherever T is nullable and movable
+	(std::unique_ptr<>, a raw pointer).
+*/
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics below must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <signal.h>
+#include <utility>
+#include <linux/futex.h>
+#include <linux/types.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+extern volatile sig_atomic_t done;
+
+// blocks while *word == expected (or until woken / timeoutMs passes; 0 = no timeout)
+inline void FutexWait(std::atomic<__u32> &word, __u32 expected, long timeoutMs = 0)
+{
+	static_assert(sizeof(std::atomic<__u32>) == sizeof(__u32) && std::atomic<__u32>::is_always_lock_free);
+	struct timespec ts = {timeoutMs / 1000, (timeoutMs % 1000) * 1000000};
+	syscall(SYS_futex, reinterpret_cast<__u32 *>(&word), FUTEX_WAIT_PRIVATE, expected, timeoutMs ? &ts : nullptr, nullptr, 0);
+}
+
+inline void FutexWake(std::atomic<__u32> &word, int count)
+{
+	syscall(SYS_futex, reinterpret_cast<__u32 *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+#define CacheLineSize 64
+
+template <class T, size_t Capacity>
+class TMpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "TMpscQueue Capacity must be a power of two");
+
+public:
+	TMpscQueue()
+	{
+		for (size_t i = 0; i < Capacity; i++)
+			ring[i].seq.store(i, std::memory_order_relaxed);
+	}
+	TMpscQueue(const TMpscQueue &) = delete;
+	TMpscQueue &operator=(const TMpscQueue &) = delete;
+
+	// any thread; moves t into the queue and returns true, or returns false (leaving t alone) if the queue is full
+	bool tryEnqueue(T &t)
+	{
+		size_t pos = tail.load(std::memory_order_relaxed);
+		TSlot *slot;
+		for (;;)
+		{
+			slot = &ring[pos & (Capacity - 1)];
+			const intptr_t turn = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire) - pos);
+			if (turn == 0)
+			{
+				if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (turn < 0)
+				return false; // the consumer hasn't taken this slot's previous item yet
+			else
+				pos = tail.load(std::memory_order_relaxed); // another producer got here first
+		}
+		slot->value = std::move(t);
+		slot->seq.store(pos + 1, std::memory_order_release);
+		wakeConsumer();
+		return true;
+	}
+
+	// any thread; waits for room if the queue is full.  false only when shutting down with the queue still full (t is dropped)
+	bool enqueue(T t)
+	{
+		while (!tryEnqueue(t))
+		{
+			if (done || stop.load(std::memory_order_relaxed))
+				return false;
+			waitForRoom();
+		}
+		return true;
+	}
+
+	// consumer only; the next item, or nullptr if there isn't one
+	T tryDequeue(void)
+	{
+		TSlot &slot = ring[head & (Capacity - 1)];
+		if (slot.seq.load(std::memory_order_acquire) != head + 1)
+			return nullptr;
+		T val = std::move(slot.value);
+		slot.value = nullptr;
+		slot.seq.store(head + Capacity, std::memory_order_release);
+		head++;
+		wakeProducers();
+		return val;
+	}
+
+	// consumer only; waits for the next item.  nullptr after Stop() or once `done` is set
+	T dequeue(void)
+	{
+		for (;;)
+		{
+			if (T val = tryDequeue())
+				return val;
+			if (done || stop.load(std::memory_order_relaxed))
+				return nullptr;
+
+			// announce we're about to sleep, then look again: a producer either sees the announcement or we see its item
+			consumerIdle.store(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!hasItem() && !done && !stop.load(std::memory_order_relaxed))
+				FutexWait(consumerIdle, 1);
+			consumerIdle.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void Stop(void)
+	{
+		stop.store(true, std::memory_order_relaxed);
+		consumerIdle.store(0, std::memory_order_relaxed);
+		FutexWake(consumerIdle, 1);
+		FutexWake(taken, INT_MAX);
+	}
+
+private:
+	struct TSlot
+	{
+		std::atomic<size_t> seq; // == index: free for the producer at index; == index + 1: holds that producer's item
+		T value{};
+	};
+
+	bool hasItem() const
+	{
+		return ring[head & (Capacity - 1)].seq.load(std::memory_order_acquire) == head + 1;
+	}
+
+	bool isFull() const
+	{
+		const size_t pos = tail.load(std::memory_order_relaxed);
+		return static_cast<intptr_t>(ring[pos & (Capacity - 1)].seq.load(std::memory_order_acquire) - pos) < 0;
+	}
+
+	void wakeConsumer()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in dequeue()
+		if (consumerIdle.load(std::memory_order_relaxed) && consumerIdle.exchange(0, std::memory_order_relaxed))
+			FutexWake(consumerIdle, 1);
+	}
+
+	void waitForRoom()
+	{
+		const __u32 seen = taken.load(std::memory_order_relaxed);
+		producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+		if (isFull())
+			FutexWait(taken, seen, 10); // the timeout only bounds how long a shutdown can go unnoticed
+		producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	// once half the ring is free, not per slot: waking a producer for every item we take just ping-pongs the two threads
+	void wakeProducers()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fetch_add in waitForRoom()
+		if (producersWaiting.load(std::memory_order_relaxed) && tail.load(std::memory_order_relaxed) - head <= Capacity / 2)
+		{
+			taken.fetch_add(1, std::memory_order_relaxed);
+			FutexWake(taken, INT_MAX);
+		}
+	}
+
+	TSlot ring[Capacity];
+	alignas(CacheLineSize) std::atomic<size_t> tail{0}; // next slot a producer will claim
+	alignas(CacheLineSize) size_t head = 0;             // next slot the consumer will take; consumer-private
+	alignas(CacheLineSize) std::atomic<__u32> consumerIdle{0}; // 1 while the consumer is (about to be) asleep in dequeue()
+	alignas(CacheLineSize) std::atomic<__u32> taken{0}; // bumped when the consumer frees a slot for a waiting producer
+	std::atomic<__u32> producersWaiting{0};
+	std::atomic<bool> stop{false};
+};
+
+#pragma pack(pop)
@@ -0,0 +1,130 @@
+#pragma once
+/*
+paramcodec.h
+
+Wire codec for TDataItem ParamStructs, generated at compile time from a list of field descriptors.
+
+	A ParamStruct opts in by specializing TParamLayout with the fields that go on the wire, in wire order:
+
+		template <> struct TParamLayout<ADC_Span1Params>
+			: TParamCodec<ADC_Span1Params, PARAM_FIELD(ADC_Span1Params, rangeIndex), PARAM_FIELD(ADC_Span1Params, scale)> {};
+
+	TDataItem<ParamStruct> then decodes a received payload into params (when the payload carries every field) and encodes
+	params in the default calcPayload(), so the DataItem class needs no copy code of its own.  DATA_ITEM_PARAMS() in
+	TDataItem.cpp takes a DId's lengths from the same layout, so DIdDict can't disagree with the codec.
+
+	Fields are arithmetic types (__u8, __u16, __u32, float, ...) or fixed-size arrays of them, always little-endian on the
+	wire.  Every access goes through byte loads and shifts (ReadLE/WriteLE), never through a typed pointer into the
+	payload or the (packed) ParamStruct, so nothing depends on alignment or on the host's byte order.
+
+	ParamStructs whose wire form isn't "these fields, in order" (e.g. the request and the reply differ) keep a hand-written
+	parse, but should still use ReadLE/WriteLE for the individual values.
+*/
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <linux/types.h>
+
+template <size_t N> struct TWireUInt;
+template <> struct TWireUInt<1> { using type = __u8; };
+template <> struct TWireUInt<2> { using type = __u16; };
+template <> struct TWireUInt<4> { using type = __u32; };
+template <> struct TWireUInt<8> { using type = __u64; };
+
+// one little-endian value from src, which needn't be aligned
+template <typename T>
+inline T ReadLE(const __u8 *src)
+{
+	static_assert(std::is_arithmetic_v<T>, "ReadLE() is for integers and floats");
+	using U = typename TWireUInt<sizeof(T)>::type;
+	U u = 0;
+	for (size_t i = 0; i < sizeof(T); i++)
+		u = static_cast<U>(u | (static_cast<U>(src[i]) << (8 * i)));
+	return std::bit_cast<T>(u);
+}
+
+// value to dest as little-endian; returns the byte after it
+template <typename T>
+inline __u8 *WriteLE(__u8 *dest, T value)
+{
+	static_assert(std::is_arithmetic_v<T>, "WriteLE() is for integers and floats");
+	using U = typename TWireUInt<sizeof(T)>::type;
+	U u = std::bit_cast<U>(value);
+	for (size_t i = 0; i < sizeof(T); i++)
+		*dest++ = static_cast<__u8>(u >> (8 * i));
+	return dest;
+}
+
+// one ParamStruct member: where it lives in the struct, and its type (a scalar or a fixed array of scalars)
+template <size_t Offset, typename T>
+struct TParamField
+{
+	using TElement = std::remove_all_extents_t<T>;
+	static_assert(std::is_arithmetic_v<TElement>, "ParamStruct fields must be integers, floats, or arrays of them");
+	static constexpr size_t Count = sizeof(T) / sizeof(TElement);
+	static constexpr size_t WireSize = Count * sizeof(TElement);
+
+	static void Decode(__u8 *paramStruct, const __u8 *src)
+	{
+		for (size_t i = 0; i < Count; i++)
+		{
+			const TElement v = ReadLE<TElement>(src + i * sizeof(TElement));
+			std::memcpy(paramStruct + Offset + i * sizeof(TElement), &v, sizeof(TElement));
+		}
+	}
+
+	static void Encode(const __u8 *paramStruct, __u8 *dest)
+	{
+		for (size_t i = 0; i < Count; i++)
+		{
+			TElement v;
+			std::memcpy(&v, paramStruct + Offset + i * sizeof(TElement), sizeof(TElement));
+			WriteLE<TElement>(dest + i * sizeof(TElement), v);
+		}
+	}
+};
+
+#define PARAM_FIELD(P, field) TParamField<offsetof(P, field), decltype(P::field)>
+
+template <typename P, typename... Fields>
+struct TParamCodec
+{
+	static_assert(std::is_trivially_copyable_v<P> && std::is_standard_layout_v<P>, "ParamStructs must be plain structs");
+	static constexpr size_t WireSize = (size_t{0} + ... + Fields::WireSize);
+
+	// bytes must hold at least WireSize bytes
+	static void Decode(P &params, std::span<const __u8> bytes)
+	{
+		__u8 *dst = reinterpret_cast<__u8 *>(&params);
+		const __u8 *src = bytes.data();
+		((Fields::Decode(dst, src), src += Fields::WireSize), ...);
+	}
+
+	// writes WireSize bytes; returns the byte after them
+	static __u8 *Encode(const P &params, __u8 *dest)
+	{
+		const __u8 *src = reinterpret_cast<const __u8 *>(&params);
+		((Fields::Encode(src, dest), dest += Fields::WireSize), ...);
+		return dest;
+	}
+
+	static std::vector<__u8> Encode(const P &params)
+	{
+		std::vector<__u8> bytes(WireSize);
+		Encode(params, bytes.data());
+		return bytes;
+	}
+};
+
+// specialize (deriving from TParamCodec) to give a ParamStruct a wire layout; see above
+template <typename P>
+struct TParamLayout
+{
+};
+
+template <typename P>
+concept HasParamLayout = requires { TParamLayout<P>::WireSize; };
@@ -0,0 +1,230 @@
+/*
+paramcodec_check.cpp
+
+Standalone check of the generated ParamStruct wire codecs (see paramcodec.h), and of the DIdDict lengths taken from
+them.  `make check` builds and runs it; the exit status is non-zero if anything disagrees.
+
+	Every TParamLayout: random wire bytes decode and encode back to the same bytes, and a few known values come out
+	little-endian regardless of the host.
+
+	Every DATA_ITEM_PARAMS() DId (see TDataItem.cpp): DIdDict's min/typ/max lengths are the layout's WireSize, a
+	WireSize payload validates while one byte fewer or more doesn't, and the DId's own class sends an all-zero payload
+	back unchanged and a random one back the same way every time.  Constructors that GUARD their parameters get more
+	tries.
+*/
+
+#include <cstdio>
+#include <random>
+#include <signal.h>
+#include <string>
+#include <vector>
+
+#include "adc.h"
+#include "admission.h"
+#include "paramcodec.h"
+#include "DataItems/ADC_.h"
+#include "DataItems/BRD_.h"
+#include "DataItems/DAC_.h"
+#include "DataItems/DIO_.h"
+#include "DataItems/REG_.h"
+#include "DataItems/SYS_.h"
+#include "DataItems/TDataItem.h"
+
+// the daemon's globals, which the DataItems refer to; defined in aioenetd.cpp, which isn't linked in
+int apci = -1;
+volatile sig_atomic_t done = 0;
+TAdmission Admission;
+
+#define CheckRoundTrips 1000 // random payloads per layout
+#define CheckGuardTries 1000 // random payloads a GUARDing constructor may reject before the DId counts as failed
+
+static std::mt19937 rng(0x494f);
+static int failures = 0;
+
+static void Fail(const std::string &what)
+{
+	if (failures++ < 20)
+		printf("  FAILED: %s\n", what.c_str());
+}
+
+static TBytes RandomBytes(size_t n)
+{
+	TBytes bytes(n);
+	for (__u8 &b : bytes)
+		b = static_cast<__u8>(rng());
+	return bytes;
+}
+
+// bytes → P → bytes, for one layout
+template <typename P>
+static void CheckLayout(const char *name)
+{
+	using L = TParamLayout<P>;
+	for (int run = 0; run < CheckRoundTrips; run++)
+	{
+		const TBytes wire = RandomBytes(L::WireSize);
+		P params{};
+		L::Decode(params, wire);
+		if (L::Encode(params) != wire)
+		{
+			Fail(std::string(name) + ": " + to_hex(wire) + " decoded and encoded as " + to_hex(L::Encode(params)));
+			return;
+		}
+	}
+}
+
+#define CHECK_LAYOUT(P) CheckLayout<P>(#P)
+
+// known values: multi-byte fields little-endian, floats as their IEEE-754 bits
+static void CheckByteOrder()
+{
+	DAC_RangeParams range{};
+	range.dacChannel = 2;
+	range.dacRange = RC_BIPOLAR_10;
+	if (TParamLayout<DAC_RangeParams>::Encode(range) != TBytes{0x02, 0x42, 0xE1, 0x31, 0x30})
+		Fail("DAC_RangeParams encodes as " + to_hex(TParamLayout<DAC_RangeParams>::Encode(range)));
+
+	SubmuxScaleParams scale{};
+	TParamLayout<SubmuxScaleParams>::Decode(scale, TBytes{0x01, 0x03, 0x00, 0x00, 0x80, 0x3F});
+	if ((scale.submuxIndex != 1) || (scale.gainGroupIndex != 3) || (scale.value != 1.0f))
+		Fail("SubmuxScaleParams 01 03 00 00 80 3F didn't decode as (1, 3, 1.0)");
+}
+
+// entry's DataItem built from bytes, as a request's payload again
+static TBytes RoundTrip(const TDIdDictEntry *entry, const TBytes &bytes)
+{
+	PTDataItemBase item = entry->Construct(entry->DId, bytes);
+	AdcStreamingConnection = -1; // building an ADC_StreamStart claims the stream; give it back
+	return item->calcPayload(false);
+}
+
+// DIdDict's lengths for DId, and its class's round trip
+template <typename C>
+static void CheckParamsDId(DataItemIds DId, const char *name)
+{
+	const size_t wireSize = TParamLayout<typename C::TParams>::WireSize;
+	const TDIdDictEntry *entry = DIdDict.find(DId);
+	if (entry == DIdDict.end())
+	{
+		Fail(std::string(name) + " isn't in DIdDict");
+		return;
+	}
+	if ((entry->minLen != wireSize) || (entry->typLen != wireSize) || (entry->maxLen != wireSize))
+		Fail(std::string(name) + ": DIdDict lengths " + std::to_string(entry->minLen) + "/" + std::to_string(entry->typLen)
+			 + "/" + std::to_string(entry->maxLen) + ", layout WireSize " + std::to_string(wireSize));
+
+	// what validateDataItemPayload() accepts; only the valid size is passed in, as the others log an Error apiece
+	const TBytes payload = RandomBytes(wireSize);
+	if (TDataItemBase::validateDataItemPayload(DId, payload) != ERR_SUCCESS)
+		Fail(std::string(name) + ": a " + std::to_string(wireSize) + "-byte payload doesn't validate");
+	if ((wireSize > 0) && (TDataItemBase::getMinLength(DId) <= wireSize - 1))
+		Fail(std::string(name) + ": a " + std::to_string(wireSize - 1) + "-byte payload would validate");
+	if (TDataItemBase::getMaxLength(DId) >= wireSize + 1)
+		Fail(std::string(name) + ": a " + std::to_string(wireSize + 1) + "-byte payload would validate");
+
+	// all zeros is in range for every DId here, so it has to come back byte for byte
+	const TBytes zeros(wireSize, 0);
+	const TBytes zerosBack = RoundTrip(entry, zeros);
+	if (zerosBack != zeros)
+		Fail(std::string(name) + ": " + to_hex(zeros) + " came back as " + to_hex(zerosBack));
+
+	// a random payload may be normalized (DAC_Range1 turns an unknown range code into a read), but only once: what comes
+	// back has to come back unchanged when sent again
+	for (int tries = 0; tries < CheckGuardTries; tries++)
+	{
+		const TBytes request = RandomBytes(wireSize);
+		TBytes reply;
+		try
+		{
+			reply = RoundTrip(entry, request);
+		}
+		catch (const std::logic_error &)
+		{
+			continue; // GUARDed parameter; try another
+		}
+		if (RoundTrip(entry, reply) != reply)
+			Fail(std::string(name) + ": " + to_hex(request) + " came back as " + to_hex(reply) + ", which doesn't come back as itself");
+		return;
+	}
+	Fail(std::string(name) + ": every random payload tried was rejected by its constructor");
+}
+
+#define CHECK_PARAMS_DID(d, aclass) CheckParamsDId<aclass>(DataItemIds::d, #d)
+
+int main()
+{
+	SetLogLevel(LogLevel::Error);
+
+	printf("TParamLayout round trips\n");
+	CHECK_LAYOUT(ADC_BaseClockParams);
+	CHECK_LAYOUT(ADC_StreamStartParams);
+	CHECK_LAYOUT(ADC_Differential1Params);
+	CHECK_LAYOUT(ADC_DifferentialAllParams);
+	CHECK_LAYOUT(ADC_Range1Params);
+	CHECK_LAYOUT(ADC_RangeAllParams);
+	CHECK_LAYOUT(ADC_Span1Params);
+	CHECK_LAYOUT(ADC_SpanAllParams);
+	CHECK_LAYOUT(ADC_Offset1Params);
+	CHECK_LAYOUT(ADC_OffsetAllParams);
+	CHECK_LAYOUT(ADC_Calibration1Params);
+	CHECK_LAYOUT(NumberOfSubmuxParams);
+	CHECK_LAYOUT(BRD_GetNumberOfAdcChannelsParams);
+	CHECK_LAYOUT(SubmuxScaleParams);
+	CHECK_LAYOUT(SubmuxOffsetParams);
+	CHECK_LAYOUT(DAC_RangeParams);
+	CHECK_LAYOUT(DIO_ConfigureBitParams);
+	CHECK_LAYOUT(DIO_InputBitParams);
+	CHECK_LAYOUT(DIO_OutputBitParams);
+	CHECK_LAYOUT(DIO_ClearBitParams);
+	CHECK_LAYOUT(DIO_SetBitParams);
+	CHECK_LAYOUT(DIO_ToggleBitParams);
+	CHECK_LAYOUT(TDIO_ConfigureParams);
+	CHECK_LAYOUT(TDIO_InputParams);
+	CHECK_LAYOUT(TDIO_OutputParams);
+	CHECK_LAYOUT(REG_ReadBitParams);
+	CHECK_LAYOUT(REG_WriteBitParams);
+	CHECK_LAYOUT(REG_ClearBitParams);
+	CHECK_LAYOUT(REG_SetBitParams);
+	CHECK_LAYOUT(REG_ToggleBitParams);
+	CHECK_LAYOUT(SYS_ErrorParams);
+	CHECK_LAYOUT(SYS_ItemErrorParams);
+	CHECK_LAYOUT(SYS_AdmissionParams);
+	CHECK_LAYOUT(SYS_CoalescingParams);
+	CHECK_LAYOUT(SYS_ShadowParams);
+	CHECK_LAYOUT(SYS_MaxAgeParams);
+	CheckByteOrder();
+
+	printf("DATA_ITEM_PARAMS() DIds: lengths and request round trips\n");
+	CHECK_PARAMS_DID(BRD_NumberOfSubmuxes, TBRD_NumberOfSubmuxes);
+	CHECK_PARAMS_DID(BRD_SubmuxScale, TBRD_SubmuxScale);
+	CHECK_PARAMS_DID(BRD_SubmuxOffset, TBRD_SubmuxOffset);
+	CHECK_PARAMS_DID(REG_WriteBit, TREG_WriteBit);
+	CHECK_PARAMS_DID(REG_ClearBit, TREG_ClearBit);
+	CHECK_PARAMS_DID(REG_SetBit, TREG_SetBit);
+	CHECK_PARAMS_DID(REG_ToggleBit, TREG_ToggleBit);
+	CHECK_PARAMS_DID(DAC_Range1, TDAC_Range1);
+	CHECK_PARAMS_DID(DIO_Configure, TDIO_Configure);
+	CHECK_PARAMS_DID(DIO_Output, TDIO_Output);
+	CHECK_PARAMS_DID(DIO_ConfigureBit, TDIO_ConfigureBit);
+	CHECK_PARAMS_DID(DIO_OutputBit, TDIO_OutputBit);
+	CHECK_PARAMS_DID(DIO_ClearBit, TDIO_ClearBit);
+	CHECK_PARAMS_DID(DIO_SetBit, TDIO_SetBit);
+	CHECK_PARAMS_DID(DIO_ToggleBit, TDIO_ToggleBit);
+	CHECK_PARAMS_DID(ADC_Differential1, TADC_Differential1);
+	CHECK_PARAMS_DID(ADC_DifferentialAll, TADC_DifferentialAll);
+	CHECK_PARAMS_DID(ADC_Range1, TADC_Range1);
+	CHECK_PARAMS_DID(ADC_RangeAll, TADC_RangeAll);
+	CHECK_PARAMS_DID(ADC_Scale1, TADC_Scale1);
+	CHECK_PARAMS_DID(ADC_ScaleAll, TADC_ScaleAll);
+	CHECK_PARAMS_DID(ADC_Offset1, TADC_Offset1);
+	CHECK_PARAMS_DID(ADC_OffsetAll, TADC_OffsetAll);
+	CHECK_PARAMS_DID(ADC_Calibration1, TADC_Calibration1);
+	CHECK_PARAMS_DID(ADC_StreamStart, TADC_StreamStart);
+	CHECK_PARAMS_DID(SYS_MaxAge, TSYS_MaxAge);
+
+	if (failures)
+		printf("%d FAILED\n", failures);
+	else
+		printf("ok\n");
+	return failures ? 1 : 0;
+}
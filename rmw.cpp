@@ -0,0 +1,133 @@
+#include "rmw.h"
+#include "coalesce.h"
+#include "shadow.h"
+#include "DataItems/DIO_.h"
+#include "DataItems/REG_.h"
+
+// the TRmw of setting (value != 0) or clearing one bit; false if the bit isn't in the register
+static bool WriteBit(int offset, __u8 bit, bool value, TRmw &rmw)
+{
+	if (bit >= widthFromOffset(offset))
+		return false;
+	rmw = {offset, ~(1u << bit), value ? (1u << bit) : 0};
+	return true;
+}
+
+static bool ToggleBit(int offset, __u8 bit, TRmw &rmw)
+{
+	if (bit >= widthFromOffset(offset))
+		return false;
+	rmw = {offset, ~0u, 1u << bit};
+	return true;
+}
+
+// REG_SetBits and friends: u8 offset, then the bits, as wide as the register
+static bool RegBits(const TBytes &Data, __u32 &bits, int &offset)
+{
+	if (Data.empty())
+		return false;
+	offset = Data[0];
+	const int width = widthFromOffset(offset);
+	if ((width == 0) || (Data.size() < 1 + width / 8u))
+		return false;
+	bits = regextract(const_cast<__u8 *>(Data.data()) + 1, offset);
+	return true;
+}
+
+bool AsRmw(const TDataItemBase &item, TRmw &rmw)
+{
+	__u32 bits = 0;
+	int offset = 0;
+	switch (item.getDId())
+	{
+	case DataItemIds::DIO_SetBit:
+		return WriteBit(ofsDioOutputs, static_cast<const TDIO_SetBit &>(item).params.bitNumber, true, rmw);
+	case DataItemIds::DIO_ClearBit:
+		return WriteBit(ofsDioOutputs, static_cast<const TDIO_ClearBit &>(item).params.bitNumber, false, rmw);
+	case DataItemIds::DIO_ToggleBit:
+		return ToggleBit(ofsDioOutputs, static_cast<const TDIO_ToggleBit &>(item).params.bitNumber, rmw);
+	case DataItemIds::DIO_OutputBit:
+	{
+		const auto &p = static_cast<const TDIO_OutputBit &>(item).params;
+		return WriteBit(ofsDioOutputs, p.bitNumber, p.value, rmw);
+	}
+	case DataItemIds::DIO_ConfigureBit:
+	{
+		const auto &p = static_cast<const TDIO_ConfigureBit &>(item).params;
+		return WriteBit(ofsDioDirections, p.bitNumber, p.direction, rmw);
+	}
+
+	case DataItemIds::REG_SetBit:
+	{
+		const auto &p = static_cast<const TREG_SetBit &>(item).params;
+		return WriteBit(p.offset, p.bitIndex, true, rmw);
+	}
+	case DataItemIds::REG_ClearBit:
+	{
+		const auto &p = static_cast<const TREG_ClearBit &>(item).params;
+		return WriteBit(p.offset, p.bitIndex, false, rmw);
+	}
+	case DataItemIds::REG_ToggleBit:
+	{
+		const auto &p = static_cast<const TREG_ToggleBit &>(item).params;
+		return ToggleBit(p.offset, p.bitIndex, rmw);
+	}
+	case DataItemIds::REG_WriteBit:
+	{
+		const auto &p = static_cast<const TREG_WriteBit &>(item).params;
+		return WriteBit(p.offset, p.bitIndex, p.value, rmw);
+	}
+
+	// the DIdList lambdas; what they get to see is Data
+	case DataItemIds::REG_SetBits:
+		if (!RegBits(item.Data, bits, offset))
+			return false;
+		rmw = {offset, ~bits, bits};
+		return true;
+	case DataItemIds::REG_ClearBits:
+		if (!RegBits(item.Data, bits, offset))
+			return false;
+		rmw = {offset, ~bits, 0};
+		return true;
+	case DataItemIds::REG_ToggleBits:
+		if (!RegBits(item.Data, bits, offset))
+			return false;
+		rmw = {offset, ~0u, bits};
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+size_t RunFusedRmw(const TPayload &items, size_t first)
+{
+	TRmw run, next;
+	if (!items[first] || !AsRmw(*items[first], run))
+		return 0;
+
+	__u32 changed = run.Changes();
+	size_t count = 1;
+	for (size_t i = first + 1; i < items.size(); i++, count++)
+	{
+		if (!items[i] || !AsRmw(*items[i], next) || (next.offset != run.offset) || (next.Changes() & changed))
+			break;
+		run.Then(next);
+		changed |= next.Changes();
+	}
+	if (count < 2)
+		return 0;
+
+	// what the Go()s would have Touch()ed, before the hardware changes (see TCoalescer::Go())
+	for (size_t i = first; i < first + count; i++)
+	{
+		const TDIdDictEntry *entry = DIdDict.find(items[i]->getDId());
+		if (entry != DIdDict.end())
+			Coalescer.Touch(entry->lanes);
+	}
+
+	const __u32 regValue = Shadow.Read(run.offset);
+	out(run.offset, (regValue & run.keep) ^ run.flip);
+	Debug("fused " + std::to_string(count) + " read-modify-writes of " + to_hex<__u8>(static_cast<__u8>(run.offset)));
+	return count;
+}
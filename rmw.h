@@ -0,0 +1,48 @@
+#pragma once
+/*
+rmw.h
+
+Fusing read-modify-write DataItems: a Message that sets, clears or toggles several bits of one register, one DataItem
+per bit, costs one in() and one out() instead of a pair per DataItem.
+
+	The DataItems that read a register, change some of its bits and write it back (DIO_SetBit, DIO_ClearBit,
+	DIO_ToggleBit, DIO_OutputBit and DIO_ConfigureBit; REG_SetBit, REG_ClearBit, REG_ToggleBit and REG_WriteBit; the
+	REG_SetBits, REG_ClearBits and REG_ToggleBits lambdas) each describe what their Go() does as a TRmw.  Before
+	RunMessage() runs one of them it looks at the DataItems after it: as long as the next one is also a TRmw of the same
+	register, and changes none of the bits the run has already changed, it joins the run.  A run of two or more is
+	read once, each TRmw is applied in order, and the result is written once; none of their Go()s are called.
+
+	Their replies are unchanged (these DataItems only echo their request), and the register ends up holding exactly
+	what it would have.  A bit changed twice in a row (SetBit 3 then ClearBit 3, a pulse) starts a new run, so every
+	edge still reaches the pins; only writes that would have changed different bits one after the other become one
+	write that changes them together.  Anything else between two of them (a DIO_Input, a REG_Write1 of the same
+	register, a bit number past the register) also ends the run and runs as usual.
+*/
+
+#include "DataItems/TDataItem.h"
+#include <linux/types.h>
+
+// what one read-modify-write DataItem does to its register: new value = (old value & keep) ^ flip
+struct TRmw
+{
+	int offset;
+	__u32 keep;
+	__u32 flip;
+
+	// bits this may change
+	__u32 Changes() const { return ~keep | flip; }
+	// this, then next, as one TRmw of the same register
+	void Then(const TRmw &next)
+	{
+		flip = (flip & next.keep) ^ next.flip;
+		keep &= next.keep;
+	}
+};
+
+// true, with rmw describing item's Go(), if item is one of the read-modify-write DataItems above and Go() would touch
+// a register that exists, and a bit inside it
+bool AsRmw(const TDataItemBase &item, TRmw &rmw);
+
+// RunMessage(): if items[first] and at least the DataItem after it can share one read and write (see above), does it
+// and returns how many DataItems that covered; 0 leaves items[first] for RunMessage() to run as usual
+size_t RunFusedRmw(const TPayload &items, size_t first);
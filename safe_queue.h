@@ -5,6 +5,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <utility>
 
 extern volatile sig_atomic_t done;
 // A threadsafe-queue.
@@ -25,7 +26,7 @@ public:
   void enqueue(T t)
   {
     std::lock_guard<std::mutex> lock(m);
-    q.push(t);
+    q.push(std::move(t)); // T may be move-only (std::unique_ptr)
     c.notify_one();
   }
 
@@ -42,7 +43,7 @@ public:
     }
     if (done)
       return nullptr;
-    T val = q.front();
+    T val = std::move(q.front());
     q.pop();
     return val;
   }
@@ -50,9 +51,9 @@ public:
 T tryDequeue(void)
 {
   std::unique_lock<std::mutex> lock(m);
-  if (q.empty()) return NULL;
+  if (q.empty()) return nullptr;
 
-  T val = q.front();
+  T val = std::move(q.front());
   q.pop();
   return val;
 }
@@ -0,0 +1,214 @@
+#include <cerrno>
+#include <cstring>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "sendqueue.h"
+#include "logging.h"
+
+static std::mutex readyLock;
+static std::vector<PTSendQueue> readyQueues; // queues with something for the run-loop to send; see TSendQueue::Enqueue()
+
+int SendReadyEventFd()
+{
+	static const int fd = []
+	{
+		int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (efd < 0)
+			Error("eventfd() for Control send queues failed: " + std::string(strerror(errno)));
+		return efd;
+	}();
+	return fd;
+}
+
+void TakeReadySendQueues(std::vector<PTSendQueue> &into)
+{
+	// reset the eventfd first: a queue added after this either lands in the swap below or bumps the eventfd again
+	__u64 count;
+	(void)!read(SendReadyEventFd(), &count, sizeof(count));
+
+	std::lock_guard<std::mutex> guard(readyLock);
+	into.swap(readyQueues);
+}
+
+void TSendQueue::signalReady()
+{
+	bool bWasEmpty;
+	{
+		std::lock_guard<std::mutex> guard(readyLock);
+		bWasEmpty = readyQueues.empty();
+		readyQueues.push_back(shared_from_this());
+	}
+	if (bWasEmpty)
+	{
+		const __u64 one = 1;
+		if ((write(SendReadyEventFd(), &one, sizeof(one)) < 0) && (errno != EAGAIN))
+			Error("can't wake the Control run-loop: " + std::string(strerror(errno)));
+	}
+}
+
+TBytes TSendQueue::Buffer()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	if (spares.empty())
+		return {};
+	TBytes buffer = std::move(spares.back());
+	spares.pop_back();
+	return buffer;
+}
+
+bool TSendQueue::Enqueue(TBytes &&reply, bool bCloseAfter)
+{
+	const size_t len = reply.size();
+	bool bQueued = false;
+	bool bWake = false;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (bShut || bOverflow || bCloseQueued)
+			return false;
+
+		const size_t pending = pendingBytes.load(std::memory_order_relaxed);
+		if (pending && (pending + len > maxBytes)) // one oversized reply on its own is allowed through
+		{
+			Warn("Control client " + to_hex<__u32>(socket) + " isn't reading its replies (" + std::to_string(pending) + " bytes unsent); dropping it");
+			bOverflow = true;
+			queued.clear();
+			bSignaled = false; // even if the run-loop is waiting for POLLOUT, which a client like this never gives it
+		}
+		else
+		{
+			queued.push_back(std::move(reply));
+			pendingBytes.fetch_add(len, std::memory_order_relaxed);
+			bCloseQueued = bCloseAfter;
+			bQueued = true;
+		}
+		bWake = !bSignaled;
+		bSignaled = true;
+	}
+	if (bWake)
+		signalReady();
+	return bQueued;
+}
+
+TSendQueue::TResult TSendQueue::Flush()
+{
+	TResult result;
+	while (struct msghdr *msg = StartSend(result))
+	{
+		// MSG_DONTWAIT: the run-loop must never wait here
+		ssize_t sent = sendmsg(socket, msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if ((sent < 0) && (errno == EAGAIN)) // EAGAIN is EWOULDBLOCK on Linux
+		{
+			(void)Sent(0);
+			std::lock_guard<std::mutex> guard(lock);
+			bSignaled = true; // the run-loop will Flush() when the socket is writable; Enqueue() needn't wake it
+			return TResult::Blocked;
+		}
+		if (!Sent((sent < 0) ? -errno : sent))
+			return TResult::Drop;
+	}
+	return result;
+}
+
+struct msghdr *TSendQueue::StartSend(TResult &result)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (bOverflow || bShut)
+		{
+			result = TResult::Drop;
+			return nullptr;
+		}
+		bSignaled = false;
+		for (auto &reply : queued)
+			sending.push_back(std::move(reply));
+		queued.clear();
+		bClosePending = bCloseQueued;
+	}
+	if (sending.empty())
+	{
+		result = bClosePending ? TResult::Close : TResult::Empty;
+		return nullptr;
+	}
+
+	size_t n = 0;
+	for (auto reply = sending.begin(); (reply != sending.end()) && (n < SendQueueMaxIovecs); ++reply, ++n)
+	{
+		const size_t skip = n ? 0 : sentOfFront;
+		sendIov[n].iov_base = reply->data() + skip;
+		sendIov[n].iov_len = reply->size() - skip;
+	}
+	sendMsg = {};
+	sendMsg.msg_iov = sendIov;
+	sendMsg.msg_iovlen = n;
+	bSendStarted = true;
+	return &sendMsg;
+}
+
+bool TSendQueue::Sent(ssize_t sent)
+{
+	bSendStarted = false;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (bShut)
+		{
+			sending.clear(); // Shut() while this was being sent left it for here
+			sentOfFront = 0;
+			return false;
+		}
+	}
+	if ((sent == -EINTR) || (sent == -EAGAIN))
+		sent = 0; // nothing went out; StartSend() describes the same bytes again
+	if (sent < 0)
+	{
+		Error("! TCP Send to Control Client# " + to_hex<__u32>(socket) + " failed: " + std::string(strerror(static_cast<int>(-sent))));
+		return false;
+	}
+	Trace("sent " + std::to_string(sent) + " bytes of replies to Control Client# " + to_hex<__u32>(socket));
+	pendingBytes.fetch_sub(static_cast<size_t>(sent), std::memory_order_relaxed);
+
+	// retire what went out; whole buffers go back to spares for Buffer()
+	std::lock_guard<std::mutex> guard(lock);
+	size_t left = static_cast<size_t>(sent);
+	while (left)
+	{
+		TBytes &front = sending.front();
+		const size_t rest = front.size() - sentOfFront;
+		if (left < rest)
+		{
+			sentOfFront += left;
+			break;
+		}
+		left -= rest;
+		sentOfFront = 0;
+		if ((spares.size() < SendQueueSpareBuffers) && (front.capacity() <= SendQueueSpareMaxSize))
+		{
+			front.clear();
+			spares.push_back(std::move(front));
+		}
+		sending.pop_front();
+	}
+	return true;
+}
+
+bool TSendQueue::Dropped()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return bOverflow || bShut;
+}
+
+void TSendQueue::Shut()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		bShut = true;
+		queued.clear();
+		spares.clear();
+	}
+	if (bSendStarted)
+		return; // the kernel may still be reading it; Sent() clears it
+	sending.clear();
+	sentOfFront = 0;
+}
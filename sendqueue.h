@@ -0,0 +1,137 @@
+#pragma once
+/*
+sendqueue.h
+
+TSendQueue: one per Control connection; the replies the ActionThread has produced for that client, not yet sent.
+
+	The ActionThread never touches a socket.  SendResponse() serializes a reply into a buffer and Enqueue()s it, which
+	costs a lock and a push; the Control run-loop owns the socket.  The epoll one Flush()es the queue with one
+	non-blocking sendmsg() covering as many queued replies as fit (writev-style gather, no copying them together); the
+	io_uring one submits that same sendmsg() to its ring instead (StartSend(), then Sent() when it completes).  A
+	client that stops reading only fills its own queue: the run-loop waits for the socket to become writable again and
+	everybody else keeps getting answers.  Once a client's unsent replies pass maxBytes the connection is dropped rather
+	than letting it hold the ActionThread's output hostage in memory.
+
+	Waking the run-loop: the first Enqueue() since the last Flush() puts the queue on a process-wide ready list and, if
+	that list was empty, bumps SendReadyEventFd(), which the run-loop polls.  A burst of replies costs one wakeup.
+
+	It also counts the client's Messages that have been queued for the ActionThreads but not answered yet, which is
+	how the Control run-loop keeps one client from filling the ActionQueue (see ProcessMessages()), and those whose
+	time-to-live ran out before they could run.  For a client that lets a newer output write supersede an older one
+	(AIOENET_SUPERSEDE) it numbers the writes queued to each output, so an ActionThread can tell a write is stale.
+
+	Enqueue(), Buffer(), Answered(), CountExpired(), NewerOutputs(), CountSuperseded() and Dropped() may be called
+	from any thread; everything else belongs to the Control run-loop.
+*/
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics and the mutex must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <linux/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "utilities.h"
+
+#define SendQueueMaxIovecs 64  // replies gathered into one sendmsg()
+#define SendQueueSpareBuffers 4 // sent reply buffers kept for Buffer() to hand out again
+#define SendQueueSpareMaxSize 65536 // ...unless they grew bigger than this (a DOC_Get reply, say)
+#define SendQueueOutputs 5 // outputs a write can supersede another on: DIO_Output, then DAC channels 0..3
+
+class TSendQueue : public std::enable_shared_from_this<TSendQueue>
+{
+public:
+	enum class TResult
+	{
+		Empty,   // everything queued has been sent
+		Blocked, // the socket is full; Flush() again once it is writable
+		Close,   // a close-after reply has been sent; the connection is finished
+		Drop,    // the client fell too far behind, or the socket failed; close the connection
+	};
+
+	TSendQueue(int aSocket, size_t aMaxBytes) : socket(aSocket), maxBytes(aMaxBytes) {}
+	TSendQueue(const TSendQueue &) = delete;
+	TSendQueue &operator=(const TSendQueue &) = delete;
+
+	int Socket() const { return socket; }
+
+	// any thread: an empty buffer to serialize the next reply into; reuses one Flush() has finished with if it can
+	TBytes Buffer();
+	// any thread: queues reply for sending; bCloseAfter ends the connection once it has gone out.  false if reply was
+	// discarded (the connection is gone or closing, or this reply put it over maxBytes)
+	bool Enqueue(TBytes &&reply, bool bCloseAfter = false);
+
+	// Control run-loop: one more of this client's Messages is on its way to the ActionThreads
+	void Asked() { outstanding.fetch_add(1, std::memory_order_relaxed); }
+	// any thread: one of them is answered; call before Enqueue()ing the reply, whose wakeup lets the run-loop read again
+	void Answered() { outstanding.fetch_sub(1, std::memory_order_relaxed); }
+	unsigned Outstanding() const { return outstanding.load(std::memory_order_relaxed); }
+	// reply bytes queued or being sent, not yet taken by the socket
+	size_t Unsent() const { return pendingBytes.load(std::memory_order_relaxed); }
+
+	// any thread: one of this client's Messages was answered ERR_EXPIRED instead of being run
+	void CountExpired() { expired.fetch_add(1, std::memory_order_relaxed); }
+	unsigned Expired() const { return expired.load(std::memory_order_relaxed); }
+
+	// Control run-loop: a write to `output` (< SendQueueOutputs) is being queued; returns its number, for NewerOutputs()
+	__u32 QueueOutput(unsigned output) { return outputsQueued[output].fetch_add(1, std::memory_order_relaxed) + 1; }
+	// any thread: how many writes to `output` were queued after the one QueueOutput() numbered `number`
+	__u32 NewerOutputs(unsigned output, __u32 number) const { return outputsQueued[output].load(std::memory_order_relaxed) - number; }
+	// any thread: one of this client's Messages was answered ERR_SUPERSEDED instead of being run
+	void CountSuperseded() { superseded.fetch_add(1, std::memory_order_relaxed); }
+	unsigned Superseded() const { return superseded.load(std::memory_order_relaxed); }
+
+	// Control run-loop: sends as much as the socket takes without blocking
+	TResult Flush();
+	// Control run-loop: Flush() in two halves, for a run-loop that hands the sendmsg() to the kernel (io_uring).
+	// StartSend() describes as much as one sendmsg() may take, or returns nullptr and what Flush() would have returned
+	// (Empty, Close or Drop).  The msghdr, and the replies it points at, stay put until Sent() is told how it went
+	struct msghdr *StartSend(TResult &result);
+	// ...the sendmsg() StartSend() described returned `sent` (-errno on failure); false if the connection must go
+	bool Sent(ssize_t sent);
+	// any thread: the client fell too far behind (see Enqueue()), or the queue was Shut()
+	bool Dropped();
+	// Control run-loop: the connection is closed; anything queued now or later is discarded (what a StartSend() is
+	// still sending, once Sent() is called)
+	void Shut();
+
+private:
+	void signalReady();
+
+	const int socket;
+	const size_t maxBytes;
+
+	std::mutex lock; // guards everything down to `sending`
+	std::deque<TBytes> queued;
+	std::vector<TBytes> spares;
+	bool bSignaled = false;   // on the ready list, or Flush() will look at `queued` again anyway
+	bool bCloseQueued = false;
+	bool bOverflow = false;
+	bool bShut = false;
+	std::atomic<size_t> pendingBytes{0}; // queued + unsent part of sending
+	std::atomic<unsigned> outstanding{0}; // Messages Asked() and not yet Answered()
+	std::atomic<unsigned> expired{0};
+	std::atomic<__u32> outputsQueued[SendQueueOutputs] = {};
+	std::atomic<unsigned> superseded{0};
+
+	// the run-loop's private side; only Flush(), StartSend(), Sent() and Shut() touch these
+	std::deque<TBytes> sending;
+	size_t sentOfFront = 0; // bytes of sending.front() already sent
+	bool bClosePending = false;
+	bool bSendStarted = false; // StartSend() has handed out sendIov, and Sent() hasn't been called yet
+	struct iovec sendIov[SendQueueMaxIovecs];
+	struct msghdr sendMsg = {};
+};
+using PTSendQueue = std::shared_ptr<TSendQueue>;
+
+// readable whenever a TSendQueue has been put on the ready list; for the Control run-loop's epoll set / io_uring poll
+int SendReadyEventFd();
+// Control run-loop: resets SendReadyEventFd() and moves every queue on the ready list into `into`
+void TakeReadySendQueues(std::vector<PTSendQueue> &into);
+
+#pragma pack(pop)
@@ -0,0 +1,103 @@
+#include "shadow.h"
+#include "apci.h"
+#include "eNET-AIO16-16F.h"
+#include <array>
+
+TShadow Shadow;
+
+// registers first..last (every one in between that exists) and what the shadow does for them; anything not listed is
+// ShadowNone
+struct TShadowRange
+{
+	__u8 first;
+	__u8 last;
+	TShadowPolicy policy;
+};
+
+static constexpr TShadowRange ShadowTable[] = {
+	{ofsAdcRange, ofsAdcRange + 7, ShadowElide},                    // each channel group's gain, polarity, single-ended
+	{ofsAdcCalibrationMode, ofsAdcCalibrationMode, ShadowElide},
+	{ofsAdcTriggerOptions, ofsAdcTriggerOptions, ShadowWriteThrough}, // every software scan rewrites it to arm the next
+	{ofsAdcStartChannel, ofsAdcOversamples, ShadowElide},
+	{ofsAdcCrossTalkFeep, ofsAdcCrossTalkFeep, ShadowElide},
+	{ofsAdcRateDivisor, ofsAdcRateDivisor, ShadowWriteThrough},     // a write may restart the rate generator
+	{ofsAdcFifoIrqThreshold, ofsAdcFifoIrqThreshold, ShadowElide},
+	{ofsIrqEnables, ofsIrqEnables, ShadowElide},
+	{ofsDacSleep, ofsDacSleep, ShadowElide},
+	{ofsDioDirections, ofsDioDirections, ShadowElide}, // bit 31 reads back as SPI busy; the shadow holds what was written
+	{ofsDioOutputs, ofsDioOutputs, ShadowElide},
+	{ofsSubMuxSelect, ofsSubMuxSelect, ShadowElide},
+	{ofsAdcCalScale, ofsAdcCalOffset + 7 * ofsAdcCalOffsetStride, ShadowElide}, // the eight scale, offset pairs
+};
+
+// ShadowTable, by offset; the 8-bit registers are every offset below 0x18, the 32-bit ones every fourth after that
+static constexpr std::array<TShadowPolicy, ShadowRegisters> ShadowPolicies = [] {
+	std::array<TShadowPolicy, ShadowRegisters> policies{};
+	for (const TShadowRange &range : ShadowTable)
+		for (int ofs = range.first; ofs <= range.last; ofs += (ofs < 0x18) ? 1 : 4)
+			policies[ofs] = range.policy;
+	return policies;
+}();
+
+// what a write of value to offset leaves in the register: no more bits than it's wide
+static __u64 AsWritten(int offset, __u32 value)
+{
+	return (offset < 0x18) ? (value & 0xFFu) : value;
+}
+
+TShadowPolicy TShadow::Policy(int offset) const
+{
+	if ((offset < 0) || (offset >= ShadowRegisters) || !Enabled())
+		return ShadowNone;
+	return ShadowPolicies[offset];
+}
+
+__u32 TShadow::Read(int offset)
+{
+	if (Policy(offset) != ShadowNone)
+	{
+		const __u64 value = values[offset].load(std::memory_order_relaxed);
+		if (value & Known)
+		{
+			readsSaved.fetch_add(1, std::memory_order_relaxed);
+			return static_cast<__u32>(value);
+		}
+	}
+	return in(offset);
+}
+
+bool TShadow::Unchanged(int offset, __u32 value)
+{
+	if ((Policy(offset) != ShadowElide) || (values[offset].load(std::memory_order_relaxed) != (Known | AsWritten(offset, value))))
+		return false;
+	writesSaved.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void TShadow::Wrote(int offset, __u32 value, TError status)
+{
+	if (offset == ofsReset)
+		Resync();
+	else if (Policy(offset) != ShadowNone)
+		values[offset].store(status ? 0 : (Known | AsWritten(offset, value)), std::memory_order_relaxed);
+}
+
+void TShadow::Forget(int offset)
+{
+	if (offset == ofsReset)
+		Resync();
+	else if ((offset >= 0) && (offset < ShadowRegisters))
+		values[offset].store(0, std::memory_order_relaxed);
+}
+
+void TShadow::Resync()
+{
+	for (std::atomic<__u64> &value : values)
+		value.store(0, std::memory_order_relaxed);
+}
+
+void TShadow::SetEnabled(bool on)
+{
+	enabled.store(on, std::memory_order_relaxed);
+	Resync();
+}
@@ -0,0 +1,77 @@
+#pragma once
+/*
+shadow.h
+
+TShadow: the last value written to each configuration and output register, so a read-modify-write needs no read and
+a write of what the register already holds needs no write.
+
+	Every out() goes through here (see apci.cpp).  For a register the table in shadow.cpp lists, a successful out()
+	remembers the value; Read() then answers from that instead of an in(), which is what the read-modify-write
+	DataItems (DIO_SetBit, DIO_ConfigureBit, REG_SetBits, ADC_Differential1, RunFusedRmw(), ...) use to read back the
+	register they're about to change.  For a register whose policy is ShadowElide, an out() of the value it already
+	holds isn't done at all: ADC_RangeAll or ADC_ScaleAll with one group changed writes one register, not eight.
+
+	Only registers that read back exactly what was last written, and that nothing but out() changes, are in the table;
+	everything else (the FIFO, the DAC command register, status and ID registers, the reset and flash registers) is
+	never shadowed and behaves as before.  Any write to ofsReset (the startup reset, a REG_Write1 or REG_WriteBuf to it)
+	forgets every value (Resync()), so the next read of each comes from the board again; so does
+	AIOENET_REGISTER_SHADOW=off, for good.  A plain in() (REG_Read1,
+	DIO_Input, ...) always reads the hardware.
+
+	Each register is written only by DataItems on its own lane (REG_ takes them all), so a check-then-write here never
+	races another write of the same register.  SYS_Shadow reads the counters.
+*/
+
+#include "DataItems/TDataItem.h"
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics below must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <linux/types.h>
+
+#define ShadowRegisters 0x100 // offsets 0x00-0xFF; widthFromOffset() says which exist
+
+// what the shadow does for one register
+enum TShadowPolicy : __u8
+{
+	ShadowNone,         // not shadowed: every in() and out() goes to the board
+	ShadowWriteThrough, // every out() goes to the board; Read() answers from the last one
+	ShadowElide,        // ...and an out() of the value the register already holds is skipped
+};
+
+class TShadow
+{
+public:
+	// the register at offset, for a read-modify-write: the last value written, or in() if there isn't one (what was
+	// read isn't remembered; only what the board was told to hold is)
+	__u32 Read(int offset);
+
+	// out(): true if writing value to offset can be skipped (counted in WritesSaved())
+	bool Unchanged(int offset, __u32 value);
+	// out(): the board now holds value at offset (status is what the write returned; a failed one forgets it)
+	void Wrote(int offset, __u32 value, TError status);
+	// outBuf() and the like: whatever offset holds now isn't known (ofsReset: whatever any register holds)
+	void Forget(int offset);
+	// the board was reset, or may have changed behind our back: forget everything
+	void Resync();
+
+	// at startup; off forgets everything and shadows nothing from then on
+	void SetEnabled(bool on);
+
+	TShadowPolicy Policy(int offset) const;
+	bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+	__u64 ReadsSaved() const { return readsSaved.load(std::memory_order_relaxed); }
+	__u64 WritesSaved() const { return writesSaved.load(std::memory_order_relaxed); }
+
+private:
+	static constexpr __u64 Known = 1ull << 32; // values[] holds a value, in its low 32 bits
+
+	std::atomic<bool> enabled{true};
+	std::atomic<__u64> values[ShadowRegisters] = {}; // per offset: Known | value, or 0
+	std::atomic<__u64> readsSaved{0};  // in()s Read() answered instead
+	std::atomic<__u64> writesSaved{0}; // out()s Unchanged() skipped
+};
+
+extern TShadow Shadow; // the daemon's one; defined in shadow.cpp
+
+#pragma pack(pop)
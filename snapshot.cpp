@@ -0,0 +1,155 @@
+#include "snapshot.h"
+#include "TMessage.h"
+#include "DataItems/ADC_.h"
+#include "DataItems/BRD_.h"
+#include "DataItems/DIO_.h"
+#include "DataItems/SYS_.h"
+
+TSnapshot Snapshot;
+
+// index into TSnapshot::adc / TBoard, or -1 for any other DId
+static int AdcScanIndex(DataItemIds DId)
+{
+	switch (DId)
+	{
+	case DataItemIds::ADC_RawAll: return 0;
+	case DataItemIds::ADC_CountsAll: return 1;
+	case DataItemIds::ADC_VoltsAll: return 2;
+	default: return -1;
+	}
+}
+
+static int BoardIdIndex(DataItemIds DId)
+{
+	switch (DId)
+	{
+	case DataItemIds::BRD_DeviceID: return 0;
+	case DataItemIds::BRD_FpgaID: return 1;
+	case DataItemIds::BRD_Features: return 2;
+	default: return -1;
+	}
+}
+
+void TSnapshot::PublishDioInputs(__u16 inputs)
+{
+	const TClock::time_point now = TClock::now();
+	dio.Update([&](TDio &d) {
+		d.inputs = inputs;
+		d.at = now;
+	});
+}
+
+void TSnapshot::PublishAdcScan(DataItemIds DId, const __u8 *bytes, size_t len)
+{
+	const int i = AdcScanIndex(DId);
+	if ((i < 0) || (len > SnapshotMaxAdcBytes))
+		return;
+	const TClock::time_point now = TClock::now();
+	adc[i].Update([&](TAdcScan &scan) {
+		scan.len = static_cast<__u16>(len);
+		std::memcpy(scan.bytes, bytes, len);
+		scan.at = now;
+	});
+}
+
+void TSnapshot::PublishBoardId(DataItemIds DId, __u32 value)
+{
+	const int i = BoardIdIndex(DId);
+	if (i < 0)
+		return;
+	const TClock::time_point now = TClock::now();
+	board.Update([&](TBoard &b) {
+		b.value[i] = value;
+		b.at[i] = now;
+	});
+}
+
+bool TSnapshot::Answer(TMessage &aMessage)
+{
+	if ((aMessage.getMId() != 'Q') || (aMessage.DataItems.size() < 2) || !aMessage.DataItems[0] ||
+		(aMessage.DataItems[0]->getDId() != DataItemIds::SYS_MaxAge))
+		return false;
+
+	// anything published before `oldest` is too stale for this client; `at` is {} for what was never published
+	const auto maxAge = std::chrono::milliseconds(static_cast<TSYS_MaxAge &>(*aMessage.DataItems[0]).params.MaxAgeMs);
+	const TClock::time_point oldest = TClock::now() - maxAge;
+	auto stale = [oldest](TClock::time_point at) { return (at == TClock::time_point{}) || (at < oldest); };
+
+	for (size_t i = 1; i < aMessage.DataItems.size(); i++)
+	{
+		TDataItemBase *item = aMessage.DataItems[i].get();
+		if (!item)
+			return false;
+		const DataItemIds DId = item->getDId();
+		switch (DId)
+		{
+		case DataItemIds::DIO_Input:
+		case DataItemIds::DIO_InputBit:
+		{
+			TDio d;
+			dio.Read([&](const TDio &published) { d = published; });
+			if (stale(d.at))
+				return false;
+			if (DId == DataItemIds::DIO_Input)
+				static_cast<TDIO_Input *>(item)->params.value = d.inputs;
+			else
+			{
+				auto &bit = static_cast<TDIO_InputBit *>(item)->params;
+				if (bit.bitNumber > 15)
+					return false; // let Go() deal with it
+				bit.bitValue = static_cast<__u8>((d.inputs >> bit.bitNumber) & 1);
+			}
+			break;
+		}
+
+		case DataItemIds::ADC_RawAll:
+		case DataItemIds::ADC_CountsAll:
+		case DataItemIds::ADC_VoltsAll:
+		{
+			__u8 bytes[SnapshotMaxAdcBytes];
+			size_t len = 0;
+			TClock::time_point at;
+			adc[AdcScanIndex(DId)].Read([&](const TAdcScan &scan) {
+				len = std::min<size_t>(scan.len, sizeof(bytes));
+				std::memcpy(bytes, scan.bytes, len);
+				at = scan.at;
+			});
+			if (stale(at))
+				return false;
+			// all three reply with whatever their Go() left in rawBytes
+			TArenaBytes &rawBytes = (DId == DataItemIds::ADC_RawAll)    ? static_cast<TADC_RawAll *>(item)->rawBytes
+								  : (DId == DataItemIds::ADC_CountsAll) ? static_cast<TADC_CountsAll *>(item)->rawBytes
+																		: static_cast<TADC_VoltsAll *>(item)->rawBytes;
+			rawBytes.assign(bytes, bytes + len);
+			break;
+		}
+
+		case DataItemIds::BRD_DeviceID:
+		case DataItemIds::BRD_FpgaID:
+		case DataItemIds::BRD_Features:
+		{
+			const int b = BoardIdIndex(DId);
+			__u32 value = 0;
+			TClock::time_point at;
+			board.Read([&](const TBoard &published) {
+				value = published.value[b];
+				at = published.at[b];
+			});
+			if (stale(at))
+				return false;
+			if (DId == DataItemIds::BRD_DeviceID)
+				static_cast<TBRD_DeviceID *>(item)->params.config = static_cast<__u16>(value);
+			else if (DId == DataItemIds::BRD_FpgaID)
+				static_cast<TBRD_FpgaId *>(item)->params.config = value;
+			else
+				static_cast<TBRD_Features *>(item)->params.config = static_cast<__u8>(value);
+			break;
+		}
+
+		default:
+			return false;
+		}
+	}
+	aMessage.setMId('R');
+	return true;
+}
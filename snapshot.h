@@ -0,0 +1,116 @@
+#pragma once
+/*
+snapshot.h
+
+TSnapshot: the latest values the ActionThreads have read from the board (DIO inputs, the last ADC scans, the board's
+ID registers), published so the Control run-loop can answer reads from them without queueing anything.
+
+	The DataItems that read these (DIO_Input, ADC_VoltsAll, BRD_FpgaID, ...) Publish() what they read, and when, from
+	their Go().  A client that can live with data up to N ms old says so by starting a 'Q' Message with SYS_MaxAge(N):
+	if every other DataItem in it can be answered from values no older than that, Answer() fills them in and the
+	run-loop replies on the spot, never touching the ActionQueue, the lanes or the hardware.  If any can't (never read
+	yet, too old, a DId the snapshot doesn't keep) the Message goes through the ActionQueue like any other, and SYS_MaxAge
+	itself just echoes.  Only a client with nothing else outstanding is answered this way, so replies never pass each
+	other.
+
+	Each group of values sits behind its own TSeqlock: a writer makes the sequence number odd, writes, and makes it even
+	again; a reader copies what it wants and retries if the number was odd or moved meanwhile.  Readers never block
+	writers and take no lock; the hardware threads never wait for the run-loop.
+*/
+
+#include "DataItems/TDataItem.h"
+
+// TDataItem.h leaves #pragma pack(1) in effect; the atomics and time_points below must keep their natural alignment
+#pragma pack(push, 8)
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <linux/types.h>
+
+class TMessage;
+
+#define SnapshotMaxAdcBytes 1024 // the largest ADC_*All reply kept: 256 channels of u32 or float
+
+// T must be trivially copyable.  Update() may be called from any thread (writers take turns on the sequence number)
+template <class T>
+class TSeqlock
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+	// change(T &) updates the value in place
+	template <class F>
+	void Update(F change)
+	{
+		__u32 seq = sequence.load(std::memory_order_relaxed);
+		while ((seq & 1) || !sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+			seq = sequence.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		change(value);
+		sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	// look(const T &) copies out what it needs; it may be called more than once, and must not act on what it saw until
+	// Read() returns
+	template <class F>
+	void Read(F look) const
+	{
+		for (;;)
+		{
+			const __u32 seq = sequence.load(std::memory_order_acquire);
+			if (seq & 1)
+				continue;
+			look(value);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == seq)
+				return;
+		}
+	}
+
+private:
+	std::atomic<__u32> sequence{0};
+	T value{};
+};
+
+class TSnapshot
+{
+public:
+	using TClock = std::chrono::steady_clock;
+
+	// the ActionThreads, from the DataItems' Go()
+	void PublishDioInputs(__u16 inputs);
+	void PublishAdcScan(DataItemIds DId, const __u8 *bytes, size_t len); // ADC_RawAll, ADC_CountsAll or ADC_VoltsAll's reply
+	void PublishBoardId(DataItemIds DId, __u32 value);                  // BRD_DeviceID, BRD_FpgaID or BRD_Features
+
+	// Control run-loop: if aMessage is a 'Q' starting with SYS_MaxAge and the snapshot can answer all the rest of it,
+	// fills in the answers, makes it the 'R' reply and returns true.  false leaves aMessage half answered; run a fresh
+	// copy of it instead
+	bool Answer(TMessage &aMessage);
+
+private:
+	struct TDio
+	{
+		__u16 inputs;
+		TClock::time_point at;
+	};
+	struct TAdcScan
+	{
+		__u16 len;
+		__u8 bytes[SnapshotMaxAdcBytes];
+		TClock::time_point at;
+	};
+	struct TBoard
+	{
+		__u32 value[3]; // BRD_DeviceID, BRD_FpgaID, BRD_Features
+		TClock::time_point at[3];
+	};
+
+	TSeqlock<TDio> dio;
+	TSeqlock<TAdcScan> adc[3]; // ADC_RawAll, ADC_CountsAll, ADC_VoltsAll
+	TSeqlock<TBoard> board;
+};
+
+extern TSnapshot Snapshot; // the daemon's one; defined in snapshot.cpp
+
+#pragma pack(pop)
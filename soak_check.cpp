@@ -0,0 +1,262 @@
+/*
+soak_check.cpp
+
+Standalone soak of a Message's lifecycle in the daemon, looking for memory that isn't given back.  `make check` builds
+and runs it; the exit status is non-zero if the process grew.
+
+	The main thread plays the Control run-loop: it Admit()s a request frame, takes a TActionQueueItem (a spare one
+	when there is one), parses the frame into it under its arena, and puts it on the ActionQueue, keeping no more than
+	ClientMaxOutstanding Messages in flight, as the run-loop does for one client.  It also Flush()es the client's
+	TSendQueue into one end of a socketpair, which a reader thread drains.
+
+	An ActionThread runs each Message's DataItems, queues the reply as SendResponse() does, and hands the item back for
+	reuse as RecycleActionQueueItem() does.  The frames cycle through register reads, board queries, Messages of
+	several DataItems.  There is no card (apci is -1), so the hardware reads fail and come
+	back as 'E' replies, which is a lifecycle of its own.
+
+	VmRSS is read once the spare items, the arenas and the send queue's buffers have warmed up, and again at the end;
+	more than SoakMaxGrowthKiB between the two fails the check.  Built with -fsanitize=address the readings are only
+	reported, as the sanitizer's quarantine holds on to freed memory; LeakSanitizer checks for leaks at exit instead.
+
+	soak_check [Messages]	(default SoakMessages)
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "admission.h"
+#include "aioenetd.h"
+#include "coalesce.h"
+#include "DataItems/TDataItem.h"
+
+// the daemon's globals, which the DataItems refer to; defined in aioenetd.cpp, which isn't linked in
+int apci = -1;
+volatile sig_atomic_t done = 0;
+TAdmission Admission;
+
+#define SoakMessages 1000000  // Messages run by default
+#define SoakWarmup 100000     // Messages run before the first VmRSS reading
+#define SoakMaxGrowthKiB 1024 // VmRSS growth allowed after the warmup
+#define SoakSendQueueBytes (4 * 1024 * 1024)
+
+// this process's resident set, in KiB; 0 if /proc doesn't say
+static long VmRSS()
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+		if (line.compare(0, 6, "VmRSS:") == 0)
+			return std::atol(line.c_str() + 6);
+	return 0;
+}
+
+// a request Message holding one DataItem per (DId, payload), framed as a client sends it
+static TBytes Frame(std::initializer_list<std::pair<DataItemIds, TBytes>> items)
+{
+	TBytes payload;
+	for (const auto &[DId, data] : items)
+	{
+		const __u16 id = static_cast<__u16>(DId);
+		const __u16 len = static_cast<__u16>(data.size());
+		payload.insert(payload.end(), {static_cast<__u8>(id), static_cast<__u8>(id >> 8), static_cast<__u8>(len), static_cast<__u8>(len >> 8)});
+		payload.insert(payload.end(), data.begin(), data.end());
+	}
+	const __u32 size = static_cast<__u32>(payload.size());
+	TBytes frame{'Q', static_cast<__u8>(size), static_cast<__u8>(size >> 8), static_cast<__u8>(size >> 16), static_cast<__u8>(size >> 24)};
+	frame.insert(frame.end(), payload.begin(), payload.end());
+	__u8 sum = 0;
+	for (__u8 b : frame)
+		sum = static_cast<__u8>(sum + b);
+	frame.push_back(static_cast<__u8>(-sum)); // the whole frame sums to zero
+	return frame;
+}
+
+// NewActionQueueItem(), for the one client
+static PTActionQueueItem NewItem(const PTSendQueue &client)
+{
+	PTActionQueueItem item = SpareActionQueueItems.tryDequeue();
+	if (!item)
+		item.reset(new TActionQueueItem{nullptr, false, LaneNone, 0, 1, 0, {}, {}, -1, 0, {}, std::make_unique<TMessageArena>(), nullptr});
+	item->Client = client;
+	item->Bytes = 0;
+	item->Received = {};
+	item->theMessage = std::make_unique<TMessage>();
+	return item;
+}
+
+// RecycleActionQueueItem()
+static void RecycleItem(PTActionQueueItem anAction)
+{
+	anAction->theMessage.reset();
+	anAction->Client.reset();
+	anAction->ConfigWrites.clear();
+	anAction->Arena->Reset();
+	SpareActionQueueItems.tryEnqueue(anAction);
+}
+
+// RunMessage() without the read-modify-write fusing or the SYS_ItemError replacements
+static void RunItems(TActionQueueItem &anAction)
+{
+	TMessage &aMessage = *anAction.theMessage;
+	if (aMessage.getMId() != 'Q')
+		return;
+	bool anyError = false;
+	for (PTDataItemBase &item : aMessage.DataItems)
+	{
+		try
+		{
+			item = Coalescer.Go(item, anAction.Received);
+			anyError |= (item->getResultCode() != ERR_SUCCESS);
+		}
+		catch (const std::exception &)
+		{
+			anyError = true;
+		}
+	}
+	aMessage.setMId(anyError ? 'E' : 'R');
+}
+
+// the ActionThread: runs each Message and queues its reply (SendResponse()) until the ActionQueue is stopped
+static void *SoakActionThread(void *)
+{
+	while (PTActionQueueItem anAction = ActionQueue.dequeue())
+	{
+		RunItems(*anAction);
+		Admission.Release(anAction->Bytes);
+		anAction->Client->Answered();
+		TBytes rbuf = anAction->Client->Buffer();
+		anAction->theMessage->AsBytes(rbuf, true);
+		anAction->Client->Enqueue(std::move(rbuf));
+		RecycleItem(std::move(anAction));
+	}
+	return nullptr;
+}
+
+// the client: reads replies until the daemon's end of the socketpair is shut
+static void *SoakReaderThread(void *arg)
+{
+	static __u8 buf[65536];
+	const int s = *static_cast<int *>(arg);
+	while (read(s, buf, sizeof(buf)) > 0)
+		;
+	return nullptr;
+}
+
+// the run-loop's half of a wakeup: sends whatever has been queued; false if the client had to be dropped
+static bool FlushReady(std::vector<PTSendQueue> &ready)
+{
+	TakeReadySendQueues(ready);
+	for (const PTSendQueue &queue : ready)
+		if (queue->Flush() == TSendQueue::TResult::Drop)
+			return false;
+	ready.clear();
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	SetLogLevel(LogLevel::Error);
+	const long messages = (argc > 1) ? std::atol(argv[1]) : SoakMessages;
+	if (messages <= SoakWarmup)
+	{
+		printf("soak_check: run more than %d Messages\n", SoakWarmup);
+		return 2;
+	}
+
+	const std::vector<TBytes> frames{
+		Frame({{DataItemIds::REG_Read1, {0x40}}}),
+		Frame({{DataItemIds::BRD_DeviceID, {}}}),
+		Frame({{DataItemIds::SYS_Admission, {}}, {DataItemIds::SYS_Coalescing, {}}, {DataItemIds::SYS_Shadow, {}}}),
+		Frame({{DataItemIds::REG_ReadAll, {}}}),
+		Frame({{DataItemIds::BRD_GetNumberOfSubmuxes, {}}, {DataItemIds::BRD_GetModel, {}}, {DataItemIds::REG_Read1, {0x40}}}),
+	};
+
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+	{
+		perror("socketpair");
+		return 2;
+	}
+	const PTSendQueue client = std::make_shared<TSendQueue>(sv[0], SoakSendQueueBytes);
+	pthread_t actionThread, readerThread;
+	pthread_create(&actionThread, NULL, SoakActionThread, nullptr);
+	pthread_create(&readerThread, NULL, SoakReaderThread, &sv[1]);
+
+	std::vector<PTSendQueue> ready;
+	long startRSS = 0;
+	bool bDropped = false;
+	for (long n = 0; (n < messages) && !bDropped; n++)
+	{
+		if (n == SoakWarmup)
+			startRSS = VmRSS();
+		while (!bDropped && (client->Outstanding() >= ClientMaxOutstanding))
+		{
+			bDropped = !FlushReady(ready);
+			sched_yield();
+		}
+
+		const TBytes &frame = frames[n % frames.size()];
+		if (Admission.Admit(static_cast<__u32>(frame.size())) != TAdmission::Admitted)
+		{
+			printf("  FAILED: Message %ld not admitted\n", n);
+			bDropped = true;
+			break;
+		}
+		PTActionQueueItem item = NewItem(client);
+		item->Bytes = static_cast<__u32>(frame.size());
+		item->Received = std::chrono::steady_clock::now();
+		{
+			TArenaScope scope(*item->Arena);
+			TError result = ERR_SUCCESS;
+			try
+			{
+				*item->theMessage = TMessage::FromBytes(TByteSpan(frame.data(), frame.size()), result);
+			}
+			catch (const std::logic_error &)
+			{
+				*item->theMessage = TMessage('X');
+			}
+		}
+		client->Asked();
+		ActionQueue.enqueue(std::move(item));
+	}
+	while (!bDropped && client->Outstanding())
+	{
+		bDropped = !FlushReady(ready);
+		sched_yield();
+	}
+	if (!bDropped)
+		bDropped = !FlushReady(ready);
+	const long endRSS = VmRSS();
+
+	ActionQueue.Stop();
+	pthread_join(actionThread, nullptr);
+	shutdown(sv[0], SHUT_WR);
+	pthread_join(readerThread, nullptr);
+	close(sv[0]);
+	close(sv[1]);
+
+	const long growth = endRSS - startRSS;
+	printf("%ld Messages: VmRSS %ld KiB after %d, %ld KiB at the end (%+ld KiB)\n", messages, startRSS, SoakWarmup, endRSS, growth);
+	if (bDropped)
+		printf("  FAILED: the client was dropped\n");
+	else if (!startRSS || !endRSS)
+		printf("  FAILED: no VmRSS in /proc/self/status\n");
+#if !defined(__SANITIZE_ADDRESS__)
+	else if (growth > SoakMaxGrowthKiB)
+		printf("  FAILED: grew more than %d KiB\n", SoakMaxGrowthKiB);
+#endif
+	else
+	{
+		printf("ok\n");
+		return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,345 @@
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "logging.h"
+#include "uring.h"
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void *arg, size_t argSize)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nrArgs)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+TIoUring::~TIoUring()
+{
+	Close();
+}
+
+bool TIoUring::Open(unsigned entries, unsigned bufferCount, unsigned aBufferSize)
+{
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	ringFd = io_uring_setup(entries, &p);
+	if (ringFd < 0)
+	{
+		Warn("io_uring_setup failed: " + std::string(strerror(errno)));
+		ringFd = -1;
+		return false;
+	}
+
+	// EXT_ARG is how WaitForCompletions() gets a timeout; it arrived after SINGLE_MMAP, so requiring it covers both
+	if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_SINGLE_MMAP))
+	{
+		Warn("io_uring lacks IORING_FEAT_EXT_ARG; kernel too old");
+		Close();
+		return false;
+	}
+
+	sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (cqRingSize > sqRingSize)
+		sqRingSize = cqRingSize;
+	cqRingSize = 0; // SINGLE_MMAP: the CQ ring shares the SQ ring's mapping
+
+	sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if (sqRing == MAP_FAILED)
+	{
+		sqRing = nullptr;
+		Warn("io_uring SQ ring mmap failed: " + std::string(strerror(errno)));
+		Close();
+		return false;
+	}
+	cqRing = sqRing;
+
+	sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+	void *s = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+	if (s == MAP_FAILED)
+	{
+		Warn("io_uring SQE mmap failed: " + std::string(strerror(errno)));
+		Close();
+		return false;
+	}
+	sqes = static_cast<struct io_uring_sqe *>(s);
+
+	__u8 *sq = static_cast<__u8 *>(sqRing);
+	sqHead = reinterpret_cast<unsigned *>(sq + p.sq_off.head);
+	sqTail = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+	sqMask = *reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+	sqEntries = p.sq_entries;
+	sqArray = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+
+	__u8 *cq = static_cast<__u8 *>(cqRing);
+	cqHead = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+	cqTail = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+	cqMask = *reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+	cqes = reinterpret_cast<struct io_uring_cqe *>(cq + p.cq_off.cqes);
+
+	// provided-buffer ring: the kernel picks a free buffer per recv completion, so idle clients pin no memory
+	bufCount = bufferCount; // must be a power of 2
+	bufferSize = aBufferSize;
+	bufRingSize = bufCount * sizeof(struct io_uring_buf);
+	void *r = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	void *b = mmap(nullptr, static_cast<size_t>(bufCount) * bufferSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if ((r == MAP_FAILED) || (b == MAP_FAILED))
+	{
+		if (r != MAP_FAILED)
+			munmap(r, bufRingSize);
+		if (b != MAP_FAILED)
+			munmap(b, static_cast<size_t>(bufCount) * bufferSize);
+		Warn("io_uring buffer mmap failed");
+		Close();
+		return false;
+	}
+	bufRing = static_cast<struct io_uring_buf_ring *>(r);
+	buffers = static_cast<__u8 *>(b);
+
+	struct io_uring_buf_reg reg;
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = reinterpret_cast<__u64>(bufRing);
+	reg.ring_entries = bufCount;
+	reg.bgid = IoUringBufferGroup;
+	if (io_uring_register(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+	{
+		Warn("io_uring IORING_REGISTER_PBUF_RING failed: " + std::string(strerror(errno)));
+		Close();
+		return false;
+	}
+
+	for (unsigned bid = 0; bid < bufCount; bid++)
+	{
+		struct io_uring_buf *buf = RingBuf(bid);
+		buf->addr = reinterpret_cast<__u64>(buffers + static_cast<size_t>(bid) * bufferSize);
+		buf->len = bufferSize;
+		buf->bid = static_cast<__u16>(bid);
+	}
+	__atomic_store_n(&bufRing->tail, static_cast<__u16>(bufCount), __ATOMIC_RELEASE);
+
+	if (!ProbeMultishotRecv())
+	{
+		Warn("io_uring multishot recv not supported; kernel too old");
+		Close();
+		return false;
+	}
+
+	Debug("io_uring opened: " + std::to_string(sqEntries) + " SQEs, " + std::to_string(bufCount) + " x " + std::to_string(bufferSize) + " byte recv buffers");
+	return true;
+}
+
+// IORING_REGISTER_PBUF_RING (5.19) succeeding doesn't guarantee multishot recv (6.0); try one on a socketpair
+bool TIoUring::ProbeMultishotRecv()
+{
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0)
+		return false;
+
+	bool ok = false;
+	const __u8 probe = 0;
+	if (PrepMultishotRecv(sv[0], 0) && (write(sv[1], &probe, sizeof(probe)) == sizeof(probe)) && WaitForCompletions(1000))
+	{
+		if (struct io_uring_cqe *cqe = PeekCompletion())
+		{
+			ok = (cqe->res == sizeof(probe)) && (cqe->flags & IORING_CQE_F_BUFFER);
+			if (ok)
+				RecycleBuffer(static_cast<__u16>(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+			CompletionSeen();
+		}
+	}
+	close(sv[1]);
+	close(sv[0]);
+
+	// closing the pair ends the multishot recv; drain its final CQE so the caller starts with an empty CQ ring
+	if (ok && WaitForCompletions(1000))
+		while (struct io_uring_cqe *cqe = PeekCompletion())
+		{
+			if (cqe->flags & IORING_CQE_F_BUFFER)
+				RecycleBuffer(static_cast<__u16>(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+			CompletionSeen();
+		}
+	return ok;
+}
+
+void TIoUring::Close()
+{
+	if (ringFd >= 0)
+		close(ringFd); // cancels anything still in flight
+	ringFd = -1;
+	if (sqes)
+		munmap(sqes, sqesSize);
+	sqes = nullptr;
+	if (sqRing)
+		munmap(sqRing, sqRingSize);
+	sqRing = cqRing = nullptr;
+	if (bufRing)
+		munmap(bufRing, bufRingSize);
+	bufRing = nullptr;
+	if (buffers)
+		munmap(buffers, static_cast<size_t>(bufCount) * bufferSize);
+	buffers = nullptr;
+	pending = 0;
+}
+
+struct io_uring_sqe *TIoUring::GetSqe()
+{
+	unsigned tail = *sqTail;
+	unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+	if (tail - head >= sqEntries)
+		return nullptr;
+
+	struct io_uring_sqe *sqe = &sqes[tail & sqMask];
+	memset(sqe, 0, sizeof(*sqe));
+	sqArray[tail & sqMask] = tail & sqMask;
+	return sqe;
+}
+
+bool TIoUring::PrepMultishotAccept(int listenSocket, __u64 userData)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = listenSocket;
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_CLOEXEC;
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+bool TIoUring::PrepMultishotRecv(int aSocket, __u64 userData)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = aSocket;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = IoUringBufferGroup;
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+bool TIoUring::PrepSendMsg(int aSocket, const struct msghdr *msg, __u64 userData)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_SENDMSG;
+	sqe->fd = aSocket;
+	sqe->addr = reinterpret_cast<__u64>(msg);
+	sqe->len = 1;
+	sqe->msg_flags = MSG_NOSIGNAL;
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+// a short send breaks a chain of bLink'ed ones: the rest complete with -ECANCELED, and the caller sends what's left
+bool TIoUring::PrepSend(int aSocket, const void *data, unsigned len, __u64 userData, bool bLink)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_SEND;
+	sqe->fd = aSocket;
+	sqe->flags = bLink ? IOSQE_IO_LINK : 0;
+	sqe->addr = reinterpret_cast<__u64>(data);
+	sqe->len = len;
+	sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL; // MSG_WAITALL: the kernel retries a partial send itself, where it can
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+bool TIoUring::PrepPoll(int fd, unsigned pollEvents, __u64 userData)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = pollEvents;
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+bool TIoUring::PrepCancel(__u64 targetUserData, __u64 userData)
+{
+	struct io_uring_sqe *sqe = GetSqe();
+	if (!sqe)
+		return false;
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = targetUserData;
+	sqe->user_data = userData;
+	__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+	pending++;
+	return true;
+}
+
+bool TIoUring::WaitForCompletions(int timeoutMs, unsigned minComplete)
+{
+	struct __kernel_timespec ts;
+	ts.tv_sec = timeoutMs / 1000;
+	ts.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+
+	struct io_uring_getevents_arg arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.sigmask_sz = _NSIG / 8;
+	arg.ts = reinterpret_cast<__u64>(&ts);
+
+	int ret = io_uring_enter(ringFd, pending, minComplete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+	if (ret < 0)
+	{
+		if ((errno == ETIME) || (errno == EINTR) || (errno == EAGAIN) || (errno == EBUSY))
+			return true;
+		Error("io_uring_enter failed: " + std::string(strerror(errno)));
+		return false;
+	}
+	pending -= static_cast<unsigned>(ret) < pending ? static_cast<unsigned>(ret) : pending;
+	return true;
+}
+
+struct io_uring_cqe *TIoUring::PeekCompletion()
+{
+	unsigned head = *cqHead;
+	if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+		return nullptr;
+	return &cqes[head & cqMask];
+}
+
+void TIoUring::CompletionSeen()
+{
+	__atomic_store_n(cqHead, *cqHead + 1, __ATOMIC_RELEASE);
+}
+
+void TIoUring::RecycleBuffer(__u16 bid)
+{
+	__u16 tail = bufRing->tail;
+	struct io_uring_buf *buf = RingBuf(tail & (bufCount - 1));
+	buf->addr = reinterpret_cast<__u64>(buffers + static_cast<size_t>(bid) * bufferSize);
+	buf->len = bufferSize;
+	buf->bid = bid;
+	__atomic_store_n(&bufRing->tail, static_cast<__u16>(tail + 1), __ATOMIC_RELEASE);
+}
@@ -0,0 +1,89 @@
+#pragma once
+/*
+uring.h
+
+Minimal io_uring wrapper for aioenetd's Control and ADC sockets, built on the raw syscalls (no liburing dependency).
+
+	Only what the Control run-loop and the ADC logger need is here:
+		multishot accept on the listen socket,
+		multishot recv on each client socket, drawing from one provided-buffer ring registered with the kernel,
+		sendmsg, for the replies a client's send queue has waiting (see TSendQueue::StartSend()),
+		send, for the ADC logger's DMA slots, several to one submission,
+		one-shot poll, for the send queues' eventfd,
+		and a wait-for-completions call with a timeout so the caller can notice `done`.
+
+	Open() fails (returns false, nothing leaks) if the kernel is too old or io_uring is disabled; the caller is
+	expected to fall back to the epoll run-loop.  Single-threaded: only the thread that calls Open() may use it.
+*/
+
+// TDataItem.h leaves #pragma pack(1) in effect; TIoUring and the kernel structs must have one layout in every file
+#pragma pack(push, 8)
+#include <linux/io_uring.h>
+#include <linux/types.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+class TIoUring
+{
+public:
+	~TIoUring();
+
+	bool Open(unsigned entries, unsigned bufferCount, unsigned bufferSize);
+	void Close();
+
+	// queue SQEs; they are handed to the kernel by the next WaitForCompletions()
+	bool PrepMultishotAccept(int listenSocket, __u64 userData);
+	bool PrepMultishotRecv(int aSocket, __u64 userData);
+	bool PrepSendMsg(int aSocket, const struct msghdr *msg, __u64 userData); // msg and its buffers must outlive the CQE
+	bool PrepSend(int aSocket, const void *data, unsigned len, __u64 userData, bool bLink); // bLink: the next SQE waits for this one
+	bool PrepPoll(int fd, unsigned pollEvents, __u64 userData); // one CQE, res = the poll(2) revents
+	bool PrepCancel(__u64 targetUserData, __u64 userData); // cancels the request tagged targetUserData; its CQE says so
+
+	// submit queued SQEs and wait up to timeoutMs for at least minComplete CQEs; returns false on a hard error
+	bool WaitForCompletions(int timeoutMs, unsigned minComplete = 1);
+
+	// CQE access; call CompletionSeen() once per CQE returned by PeekCompletion()
+	struct io_uring_cqe *PeekCompletion();
+	void CompletionSeen();
+
+	// provided-buffer helpers for IORING_CQE_F_BUFFER completions
+	const __u8 *Buffer(__u16 bid) const { return buffers + static_cast<size_t>(bid) * bufferSize; }
+	void RecycleBuffer(__u16 bid);
+
+private:
+	struct io_uring_sqe *GetSqe();
+	bool ProbeMultishotRecv();
+	// not bufRing->bufs[i]: __DECLARE_FLEX_ARRAY's empty struct has size 1 in C++, which shifts bufs[] by 8 bytes
+	struct io_uring_buf *RingBuf(unsigned i) { return reinterpret_cast<struct io_uring_buf *>(bufRing) + i; }
+
+	int ringFd = -1;
+	unsigned pending = 0; // SQEs queued but not yet submitted
+
+	void *sqRing = nullptr;
+	size_t sqRingSize = 0;
+	void *cqRing = nullptr;
+	size_t cqRingSize = 0;
+	struct io_uring_sqe *sqes = nullptr;
+	size_t sqesSize = 0;
+
+	unsigned *sqHead = nullptr;
+	unsigned *sqTail = nullptr;
+	unsigned sqMask = 0;
+	unsigned sqEntries = 0;
+	unsigned *sqArray = nullptr;
+
+	unsigned *cqHead = nullptr;
+	unsigned *cqTail = nullptr;
+	unsigned cqMask = 0;
+	struct io_uring_cqe *cqes = nullptr;
+
+	struct io_uring_buf_ring *bufRing = nullptr;
+	size_t bufRingSize = 0;
+	unsigned bufCount = 0;
+	unsigned bufferSize = 0;
+	__u8 *buffers = nullptr;
+};
+
+#define IoUringBufferGroup 0
+
+#pragma pack(pop)
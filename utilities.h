@@ -19,11 +19,13 @@ TDataItem IDs, but that should change.
 #include <iomanip>
 #include <linux/types.h>
 #include <stdexcept>
+#include <span>
 #include <vector>
 
 #include "eNET-AIO16-16F.h" // widthFromOffset()
 #include "TError.h"
 using TBytes = std::vector<__u8>;
+using TByteSpan = std::span<const __u8>;
 
 int WaitUntilRegisterBitIsLow(__u8 offset, __u32 bitMask);
 bool sanitizePath(std::string &path);